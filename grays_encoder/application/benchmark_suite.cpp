@@ -0,0 +1,328 @@
+/*------------------------------------------------------------------------------
+	()      File:   benchmark_suite.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Benchmark matrix over bit counts and threads, written as JSON.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <blend2d.h>
+#include "application/benchmark_suite.h"
+#include "application/grays_encoder.h"
+#include "application/core/monochrome.h"
+#include "utility/parallel_for.h"
+#include "utility/thread_attributes.h"
+#include "utility/version.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	using clock = std::chrono::steady_clock;
+
+	//------------------------------------------------------------------------------
+	// Repeats fn until minSeconds or maxIterations, at least once. fn returns the
+	// milliseconds it wants counted, so per iteration setup can be left out.
+	//------------------------------------------------------------------------------
+	template<class Fn>
+	void Measure( const BenchmarkOptions& options, BenchmarkSample& sample, Fn fn )
+	{
+		std::vector<double> times;
+		double total = 0.0;
+
+		do
+		{
+			const double ms = fn();
+			times.push_back( ms );
+			total += ms;
+		}
+		while ( total < options.minSeconds * 1000.0 && times.size() < std::max( options.maxIterations, 1u ) );
+
+		std::sort( times.begin(), times.end() );
+
+		sample.iterations = static_cast<uint32_t>( times.size() );
+		sample.minMs = times.front();
+		sample.meanMs = total / times.size();
+		sample.medianMs = times[times.size() / 2];
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	BenchmarkWorker ToBenchmarkWorker( const BLContextWorkerStats& stats )
+	{
+		BenchmarkWorker worker;
+		worker.bands = stats.bandCount;
+		worker.commands = stats.commandCount;
+		worker.spans = stats.spanCount;
+		worker.jobMs = stats.jobTimeNs / 1e6;
+		worker.rasterMs = stats.rasterTimeNs / 1e6;
+		worker.fillMs = stats.fillTimeNs / 1e6;
+		worker.waitMs = stats.waitTimeNs / 1e6;
+		return worker;
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	double ElapsedMs( clock::time_point start )
+	{
+		return std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	}
+
+	//------------------------------------------------------------------------------
+	// blend2d treats 0 as synchronous, the suite treats it as one per core.
+	//------------------------------------------------------------------------------
+	uint32_t ResolveThreads( uint32_t threads )
+	{
+		return threads == 0 ? parallel::HardwareThreadCount() : threads;
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// BenchmarkSuite
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BenchmarkReport BenchmarkSuite::Run( const BenchmarkOptions& options )
+{
+	const clock::time_point start = clock::now();
+
+	BenchmarkReport report;
+	report.hardwareThreads = parallel::HardwareThreadCount();
+	report.avx2 = parallel::HasAvx2();
+	report.threadAttributes = parallel::DescribeThreadAttributes();
+
+	for ( int bits = std::max( options.minBits, 1 ); bits <= options.maxBits; ++bits )
+	{
+		//generation, run extraction and path building are single threaded.
+		BenchmarkSample& generate = report.samples.emplace_back();
+		generate.kind = BenchmarkKind::Generate;
+		generate.bits = bits;
+		generate.threads = 1;
+		generate.items = uint64_t( 1 ) << bits;
+
+		Measure( options, generate, [bits]()
+		{
+			GraysEncoder grays;
+			const clock::time_point begin = clock::now();
+			grays.SetGrayNumber( static_cast<uint8_t>( bits ) );
+			return ElapsedMs( begin );
+		} );
+
+		GraysEncoder grays;
+		grays.SetGrayNumber( static_cast<uint8_t>( bits ) );
+
+		BenchmarkSample& spans = report.samples.emplace_back();
+		spans.kind = BenchmarkKind::ArcSpans;
+		spans.bits = bits;
+		spans.threads = 1;
+
+		Measure( options, spans, [&]()
+		{
+			uint64_t count = 0;
+			const clock::time_point begin = clock::now();
+			grays.ExtractArcSpans( [&count]( double, double, double, double ) { ++count; } );
+			spans.items = count;
+			return ElapsedMs( begin );
+		} );
+
+		BenchmarkSample& paths = report.samples.emplace_back();
+		paths.kind = BenchmarkKind::ArcPaths;
+		paths.bits = bits;
+		paths.threads = 1;
+		paths.items = spans.items;
+
+		Measure( options, paths, [&]()
+		{
+			BLPath path;
+			const clock::time_point begin = clock::now();
+			grays.ExtractArcSpans( [&path]( double radius, double width, double beginAngle, double sweepAngle )
+			{
+				path.clear();
+				GraysEncoder::BuildArcSegment( path, radius, width, beginAngle, sweepAngle );
+			} );
+			return ElapsedMs( begin );
+		} );
+
+		for ( const uint32_t threads : options.threads )
+		{
+			for ( const double zoom : options.zooms )
+			{
+				BenchmarkSample& render = report.samples.emplace_back();
+				render.kind = BenchmarkKind::Render;
+				render.bits = bits;
+				render.threads = threads;
+				render.zoom = zoom;
+
+				Measure( options, render, [&]()
+				{
+					const clock::time_point begin = clock::now();
+					const BLImage image = grays.RenderImage( zoom, ResolveThreads( threads ) );
+					render.items = uint64_t( image.width() ) * uint64_t( image.height() );
+					return ElapsedMs( begin );
+				} );
+			}
+
+			BenchmarkSample& print = report.samples.emplace_back();
+			print.kind = BenchmarkKind::PrintBuffer;
+			print.bits = bits;
+			print.threads = threads;
+			print.items = uint64_t( options.pageWidth ) * uint64_t( options.pageHeight );
+
+			BLImage page( static_cast<int>( options.pageWidth ), static_cast<int>( options.pageHeight ), BL_FORMAT_A8 );
+			std::vector<uint8_t> packed( Monochrome::GetPackedBytes( options.pageWidth ) * options.pageHeight );
+			std::vector<BLContextWorkerStats> workerStats( ResolveThreads( threads ) );
+
+			Measure( options, print, [&]()
+			{
+				const clock::time_point begin = clock::now();
+
+				BLContextCreateInfo createInfo{};
+				createInfo.threadCount = ResolveThreads( threads );
+				createInfo.workerStats = workerStats.data();
+				createInfo.workerStatsCapacity = static_cast<uint32_t>( workerStats.size() );
+
+				BLContext ctx( page, createInfo );
+				ctx.clearAll();
+				ctx.translate( options.pageWidth * 0.5, options.pageHeight * 0.5 );
+				ctx.scale( options.pageWidth / (grays.GetOuterExtent() * 2.0 + 2.0) );
+				grays.Render( ctx );
+				ctx.end();
+
+				BLImageData coverage;
+				page.getData( &coverage );
+
+				const size_t rowBytes = Monochrome::GetPackedBytes( options.pageWidth );
+				for ( uint32_t row = 0; row < options.pageHeight; ++row )
+				{
+					const uint8_t* src = static_cast<const uint8_t*>( coverage.pixelData ) + coverage.stride * intptr_t( row );
+					Monochrome::PackCoverage( src, options.pageWidth, packed.data() + rowBytes * row, row, MonoPacking::Threshold );
+				}
+
+				return ElapsedMs( begin );
+			} );
+
+			//the context is gone, its stats are still in workerStats.
+			std::transform( workerStats.begin(), workerStats.end(), std::back_inserter( print.workers ), ToBenchmarkWorker );
+		}
+	}
+
+	report.elapsedMs = ElapsedMs( start );
+	return report;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string BenchmarkSuite::ToJson( const BenchmarkReport& report )
+{
+	std::string json;
+	char line[512];
+
+	char timestamp[32] = {};
+	const std::time_t now = std::time( nullptr );
+	std::strftime( timestamp, sizeof( timestamp ), "%Y-%m-%dT%H:%M:%SZ", std::gmtime( &now ) );
+
+	snprintf( line, sizeof( line ), "{\n\t\"version\": \"%s\",\n\t\"timestamp\": \"%s\",\n\t\"hardwareThreads\": %u,\n\t\"avx2\": %s,\n\t\"threadAttributes\": \"%s\",\n\t\"elapsedMs\": %.3f,\n\t\"samples\": [\n",
+		APP_VERSION, timestamp, report.hardwareThreads, report.avx2 ? "true" : "false", report.threadAttributes.c_str(), report.elapsedMs );
+	json += line;
+
+	for ( size_t i = 0; i < report.samples.size(); ++i )
+	{
+		const BenchmarkSample& sample = report.samples[i];
+		const double itemsPerSecond = sample.minMs > 0.0 ? sample.items * 1000.0 / sample.minMs : 0.0;
+
+		snprintf( line, sizeof( line ), "\t\t{ \"name\": \"%s\", \"bits\": %d, \"threads\": %u, \"zoom\": %g, \"iterations\": %u, \"minMs\": %.4f, \"meanMs\": %.4f, \"medianMs\": %.4f, \"items\": %llu, \"itemsPerSecond\": %.1f",
+			GetKindName( sample.kind ),
+			sample.bits,
+			sample.threads,
+			sample.zoom,
+			sample.iterations,
+			sample.minMs,
+			sample.meanMs,
+			sample.medianMs,
+			static_cast<unsigned long long>( sample.items ),
+			itemsPerSecond );
+		json += line;
+
+		if ( !sample.workers.empty() )
+		{
+			json += ", \"workers\": [";
+			for ( size_t w = 0; w < sample.workers.size(); ++w )
+			{
+				const BenchmarkWorker& worker = sample.workers[w];
+				snprintf( line, sizeof( line ), "%s{ \"bands\": %llu, \"commands\": %llu, \"spans\": %llu, \"jobMs\": %.3f, \"rasterMs\": %.3f, \"fillMs\": %.3f, \"waitMs\": %.3f }",
+					w ? ", " : " ",
+					static_cast<unsigned long long>( worker.bands ),
+					static_cast<unsigned long long>( worker.commands ),
+					static_cast<unsigned long long>( worker.spans ),
+					worker.jobMs,
+					worker.rasterMs,
+					worker.fillMs,
+					worker.waitMs );
+				json += line;
+			}
+			json += " ]";
+		}
+
+		json += i + 1 < report.samples.size() ? " },\n" : " }\n";
+	}
+
+	json += "\t]\n}\n";
+	return json;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool BenchmarkSuite::WriteJson( const BenchmarkReport& report, const std::filesystem::path& path )
+{
+	std::ofstream file( path, std::ios::binary );
+	file << ToJson( report );
+	return file.good();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const char* BenchmarkSuite::GetKindName( BenchmarkKind kind )
+{
+	switch ( kind )
+	{
+	case BenchmarkKind::Generate: return "generate";
+	case BenchmarkKind::ArcSpans: return "arc_spans";
+	case BenchmarkKind::ArcPaths: return "arc_paths";
+	case BenchmarkKind::Render: return "render";
+	case BenchmarkKind::PrintBuffer: return "print_buffer";
+	}
+
+	return "unknown";
+}
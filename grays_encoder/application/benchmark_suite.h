@@ -0,0 +1,136 @@
+/*------------------------------------------------------------------------------
+	()      File:   benchmark_suite.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Generation, path building and rasterization benchmarks.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class BenchmarkKind : uint32_t
+{
+	Generate,		// SetGrayNumber on a fresh encoder, code generation and validation.
+	ArcSpans,		// Run extraction over every code track, no drawing.
+	ArcPaths,		// Run extraction plus building each arc's outline.
+	Render,			// Full disc render at one zoom level.
+	PrintBuffer,	// A8 page render plus packing to 1-bpp, as PrintingService does.
+
+	Count
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct BenchmarkOptions
+{
+	int minBits = 4;
+	int maxBits = 24;
+	// Render and print thread counts, 0 = one per core.
+	std::vector<uint32_t> threads = { 0, 1, 2, 4, 8, 16 };
+	// Render pixels per unit, 1.0 draws the default disc 402 pixels across.
+	std::vector<double> zooms = { 0.5, 1.0, 2.0, 4.0 };
+	// Print page in pixels, A4 at 300 dpi rendered at twice size like the print preview.
+	uint32_t pageWidth = 4960;
+	uint32_t pageHeight = 7016;
+
+	// Each measurement repeats until it has run this long or hit maxIterations.
+	double minSeconds = 0.25;
+	uint32_t maxIterations = 20;
+};
+
+//------------------------------------------------------------------------------
+// One render thread of a print buffer sample, index 0 is the calling thread.
+//------------------------------------------------------------------------------
+struct BenchmarkWorker
+{
+	uint64_t bands = 0;
+	uint64_t commands = 0;
+	uint64_t spans = 0;
+	double jobMs = 0.0;
+	double rasterMs = 0.0;
+	double fillMs = 0.0;	// Pipelines, fetch and composition.
+	double waitMs = 0.0;	// Idle, waiting for the other threads.
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct BenchmarkSample
+{
+	BenchmarkKind kind = BenchmarkKind::Generate;
+	int bits = 0;
+	uint32_t threads = 0;	// As requested, 0 = one per core.
+	double zoom = 0.0;		// Render only.
+
+	uint32_t iterations = 0;
+	double minMs = 0.0;
+	double meanMs = 0.0;
+	double medianMs = 0.0;
+
+	// Arcs, codewords or pixels handled per iteration, for throughput.
+	uint64_t items = 0;
+
+	// Print buffer only, per thread blend2d stats of the last iteration.
+	std::vector<BenchmarkWorker> workers;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct BenchmarkReport
+{
+	std::vector<BenchmarkSample> samples;
+	uint32_t hardwareThreads = 0;
+	bool avx2 = false;
+	// Render worker affinity and priority, see parallel::DescribeThreadAttributes.
+	std::string threadAttributes;
+	double elapsedMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// BenchmarkSuite
+//	Micro benchmarks for code generation, arc run extraction and path building,
+//	and macro benchmarks for whole disc and print page renders, across bit
+//	counts and thread counts. Results are written as JSON so runs can be
+//	compared over time.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class BenchmarkSuite
+{
+public:
+	static BenchmarkReport Run( const BenchmarkOptions& options );
+
+	static std::string ToJson( const BenchmarkReport& report );
+	static bool WriteJson( const BenchmarkReport& report, const std::filesystem::path& path );
+
+	static const char* GetKindName( BenchmarkKind kind );
+};
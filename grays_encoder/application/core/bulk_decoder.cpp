@@ -0,0 +1,305 @@
+/*------------------------------------------------------------------------------
+	()      File:   bulk_decoder.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Bulk Gray to binary decoding for logged encoder streams.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include <blend2d.h>
+#include "application/core/bulk_decoder.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	// Work is split into fixed blocks so each block's predecessor can be read
+	// up front, which keeps in place decoding safe across threads.
+	constexpr uint64_t BlockSize = 1 << 16;
+
+	//------------------------------------------------------------------------------
+	// Illegal jumps found by one worker, already in sample order.
+	//------------------------------------------------------------------------------
+	struct JumpTally
+	{
+		uint64_t count = 0;
+		std::vector<uint64_t> indices;
+
+		void Add( uint64_t index )
+		{
+			if ( indices.size() < BulkDecodeResult::MaxReportedJumps )
+			{
+				indices.push_back( index );
+			}
+
+			++count;
+		}
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	inline bool IsIllegalStep( uint32_t prev, uint32_t gray, uint32_t highMask )
+	{
+		const uint32_t diff = prev ^ gray;
+		return (diff & (diff - 1)) != 0 || (gray & highMask) != 0;
+	}
+
+	//------------------------------------------------------------------------------
+	// Decodes [begin, end), prev is the reading before begin (or gray[0] itself).
+	//------------------------------------------------------------------------------
+	void DecodeBlockScalar( const uint32_t* gray, uint32_t* binary, uint64_t begin, uint64_t end, uint32_t prev, int bitCount, uint32_t highMask, JumpTally& jumps )
+	{
+		for ( uint64_t i = begin; i < end; ++i )
+		{
+			const uint32_t reading = gray[i];
+
+			if ( IsIllegalStep( prev, reading, highMask ) )
+			{
+				jumps.Add( i );
+			}
+
+			uint32_t position = reading;
+			for ( int shift = 1; shift < bitCount; shift <<= 1 )
+			{
+				position ^= position >> shift;
+			}
+
+			binary[i] = position;
+			prev = reading;
+		}
+	}
+
+#if defined(_M_X64) || defined(__x86_64__)
+	//------------------------------------------------------------------------------
+	// Eight readings per iteration. The previous reading for each lane is the
+	// vector rotated up one lane with the carried reading in lane 0.
+	//------------------------------------------------------------------------------
+	void DecodeBlockAvx2( const uint32_t* gray, uint32_t* binary, uint64_t begin, uint64_t end, uint32_t prev, int bitCount, uint32_t highMask, JumpTally& jumps )
+	{
+		const __m256i rotate = _mm256_setr_epi32( 7, 0, 1, 2, 3, 4, 5, 6 );
+		const __m256i ones = _mm256_set1_epi32( -1 );
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i high = _mm256_set1_epi32( static_cast<int>( highMask ) );
+
+		uint64_t i = begin;
+		for ( ; i + 8 <= end; i += 8 )
+		{
+			const __m256i reading = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( gray + i ) );
+			const __m256i previous = _mm256_blend_epi32( _mm256_permutevar8x32_epi32( reading, rotate ), _mm256_set1_epi32( static_cast<int>( prev ) ), 0x01 );
+
+			// x & (x - 1) != 0 is more than one bit changed.
+			const __m256i diff = _mm256_xor_si256( reading, previous );
+			const __m256i multiBit = _mm256_andnot_si256( _mm256_cmpeq_epi32( _mm256_and_si256( diff, _mm256_add_epi32( diff, ones ) ), zero ), ones );
+			const __m256i outOfRange = _mm256_andnot_si256( _mm256_cmpeq_epi32( _mm256_and_si256( reading, high ), zero ), ones );
+
+			int illegal = _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_or_si256( multiBit, outOfRange ) ) );
+			while ( illegal != 0 )
+			{
+				const int lane = std::countr_zero( static_cast<unsigned int>( illegal ) );
+				jumps.Add( i + lane );
+				illegal &= illegal - 1;
+			}
+
+			__m256i position = reading;
+			for ( int shift = 1; shift < bitCount; shift <<= 1 )
+			{
+				position = _mm256_xor_si256( position, _mm256_srl_epi32( position, _mm_cvtsi32_si128( shift ) ) );
+			}
+
+			// Read the carry before the store in case binary aliases gray.
+			prev = static_cast<uint32_t>( _mm256_extract_epi32( reading, 7 ) );
+			_mm256_storeu_si256( reinterpret_cast<__m256i*>( binary + i ), position );
+		}
+
+		DecodeBlockScalar( gray, binary, i, end, prev, bitCount, highMask, jumps );
+	}
+#endif
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	uint32_t HighMask( int bitCount )
+	{
+		return bitCount >= 32 ? 0u : ~((1u << bitCount) - 1u);
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	double MillionsPerSecond( uint64_t count, double elapsedMs )
+	{
+		return elapsedMs > 0.0 ? count / (elapsedMs * 1000.0) : 0.0;
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// BulkDecoder
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BulkDecodeResult BulkDecoder::Decode( const uint32_t* gray, uint32_t* binary, uint64_t count, int bitCount, uint32_t threads /*= 0*/ )
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	BulkDecodeResult result;
+	if ( gray == nullptr || binary == nullptr || count == 0 || bitCount < 1 || bitCount > 32 )
+	{
+		return result;
+	}
+
+#if defined(_M_X64) || defined(__x86_64__)
+	result.usedAvx2 = parallel::HasAvx2();
+#endif
+
+	const uint32_t highMask = HighMask( bitCount );
+	const uint64_t blockCount = (count + BlockSize - 1) / BlockSize;
+
+	// Predecessor of every block, taken before anything is written.
+	std::vector<uint32_t> carries( blockCount );
+	for ( uint64_t block = 0; block < blockCount; ++block )
+	{
+		carries[block] = gray[block == 0 ? 0 : block * BlockSize - 1];
+	}
+
+	const uint32_t workerCount = std::max( 1u, threads == 0 ? parallel::HardwareThreadCount() : threads );
+	std::vector<JumpTally> tallies( workerCount );
+
+	result.threadsUsed = parallel::ForRange( blockCount, workerCount, [&]( uint64_t beginBlock, uint64_t endBlock, uint32_t worker )
+	{
+		for ( uint64_t block = beginBlock; block < endBlock; ++block )
+		{
+			const uint64_t begin = block * BlockSize;
+			const uint64_t end = std::min( count, begin + BlockSize );
+
+		#if defined(_M_X64) || defined(__x86_64__)
+			if ( result.usedAvx2 )
+			{
+				DecodeBlockAvx2( gray, binary, begin, end, carries[block], bitCount, highMask, tallies[worker] );
+				continue;
+			}
+		#endif
+
+			DecodeBlockScalar( gray, binary, begin, end, carries[block], bitCount, highMask, tallies[worker] );
+		}
+	} );
+
+	// Workers own ascending block ranges, so concatenating keeps sample order.
+	for ( const JumpTally& tally : tallies )
+	{
+		result.illegalJumps += tally.count;
+
+		const size_t room = BulkDecodeResult::MaxReportedJumps - result.illegalIndices.size();
+		result.illegalIndices.insert( result.illegalIndices.end(), tally.indices.begin(), tally.indices.begin() + std::min( room, tally.indices.size() ) );
+	}
+
+	result.count = count;
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BulkDecodeResult BulkDecoder::DecodeScalar( const uint32_t* gray, uint32_t* binary, uint64_t count, int bitCount )
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	BulkDecodeResult result;
+	if ( gray == nullptr || binary == nullptr || count == 0 || bitCount < 1 || bitCount > 32 )
+	{
+		return result;
+	}
+
+	JumpTally tally;
+	DecodeBlockScalar( gray, binary, 0, count, gray[0], bitCount, HighMask( bitCount ), tally );
+
+	result.count = count;
+	result.illegalJumps = tally.count;
+	result.illegalIndices = std::move( tally.indices );
+	result.threadsUsed = 1;
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BulkDecodeBenchmark BulkDecoder::Benchmark( int bitCount, uint64_t count, uint32_t threads /*= 0*/ )
+{
+	BulkDecodeBenchmark bench;
+	bench.bitCount = bitCount;
+	bench.count = count;
+
+	if ( count == 0 || bitCount < 1 || bitCount > 32 )
+	{
+		return bench;
+	}
+
+	// Random walk of a motor shaft, with the odd two bit glitch.
+	const uint32_t mask = bitCount == 32 ? UINT32_MAX : (1u << bitCount) - 1u;
+	std::vector<uint32_t> gray( count );
+
+	BLRandom rng( 0x5EED );
+	uint32_t position = 0;
+	for ( uint64_t i = 0; i < count; ++i )
+	{
+		const uint32_t r = rng.nextUInt32();
+		position += (r & 3) == 0 ? mask : (r & 3) == 1 ? 1u : 0u;
+		position &= mask;
+
+		gray[i] = position ^ (position >> 1);
+		if ( bitCount > 1 && (r >> 16) % 100000 == 0 )
+		{
+			gray[i] ^= 3u;
+		}
+	}
+
+	std::vector<uint32_t> reference( count );
+	std::vector<uint32_t> decoded( count );
+
+	const BulkDecodeResult scalar = DecodeScalar( gray.data(), reference.data(), count, bitCount );
+	const BulkDecodeResult single = Decode( gray.data(), decoded.data(), count, bitCount, 1 );
+	bench.matches = decoded == reference && single.illegalJumps == scalar.illegalJumps && single.illegalIndices == scalar.illegalIndices;
+
+	std::fill( decoded.begin(), decoded.end(), 0 );
+	const BulkDecodeResult threaded = Decode( gray.data(), decoded.data(), count, bitCount, threads );
+	bench.matches = bench.matches && decoded == reference && threaded.illegalJumps == scalar.illegalJumps && threaded.illegalIndices == scalar.illegalIndices;
+
+	bench.scalarSingle = MillionsPerSecond( count, scalar.elapsedMs );
+	bench.simdSingle = MillionsPerSecond( count, single.elapsedMs );
+	bench.simdThreaded = MillionsPerSecond( count, threaded.elapsedMs );
+	bench.threadsUsed = threaded.threadsUsed;
+	bench.usedAvx2 = threaded.usedAvx2;
+	return bench;
+}
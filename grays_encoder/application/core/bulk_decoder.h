@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------------
+	()      File:   bulk_decoder.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Bulk Gray to binary decoding for logged encoder streams.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// BulkDecodeResult
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct BulkDecodeResult
+{
+	static constexpr uint64_t NoIndex = UINT64_MAX;
+	static constexpr size_t MaxReportedJumps = 4096;
+
+	uint64_t count = 0;
+
+	// Samples i where gray[i - 1] -> gray[i] changes more than one bit, or where
+	// gray[i] has bits above the bit count. Only the first MaxReportedJumps are listed.
+	uint64_t illegalJumps = 0;
+	std::vector<uint64_t> illegalIndices;
+
+	uint32_t threadsUsed = 0;
+	bool usedAvx2 = false;
+	double elapsedMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// BulkDecodeBenchmark
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct BulkDecodeBenchmark
+{
+	int bitCount = 0;
+	uint64_t count = 0;
+	bool matches = false;
+
+	// Million samples per second.
+	double scalarSingle = 0.0;
+	double simdSingle = 0.0;
+	double simdThreaded = 0.0;
+
+	uint32_t threadsUsed = 0;
+	bool usedAvx2 = false;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// BulkDecoder
+//	Converts logged reflected binary Gray readings to binary positions.
+//	The AVX2 path folds the prefix xor into log2(bits) shift/xor steps over
+//	eight samples at a time, and checks neighbouring samples for jumps of
+//	more than one bit while the data is in registers.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class BulkDecoder
+{
+public:
+	// gray and binary may be the same buffer.
+	static BulkDecodeResult Decode( const uint32_t* gray, uint32_t* binary, uint64_t count, int bitCount, uint32_t threads = 0 );
+
+	// Single threaded scalar reference.
+	static BulkDecodeResult DecodeScalar( const uint32_t* gray, uint32_t* binary, uint64_t count, int bitCount );
+
+	// Decodes a synthetic random walk with a few injected glitches through each path.
+	static BulkDecodeBenchmark Benchmark( int bitCount, uint64_t count, uint32_t threads = 0 );
+};
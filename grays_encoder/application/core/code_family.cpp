@@ -0,0 +1,323 @@
+/*------------------------------------------------------------------------------
+	()      File:   code_family.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Pluggable Gray code families and an on disk cache for searched codes.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <bit>
+#include <fstream>
+#include <string>
+#include "application/core/code_family.h"
+#include "application/core/code_validator.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	constexpr uint32_t CacheMagic = 0x31464347;	// "GCF1"
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// ReflectedFamily
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	class ReflectedFamily final : public CodeFamily
+	{
+	public:
+		CodeFamilyType GetType() const override { return CodeFamilyType::Reflected; }
+		const char* GetName() const override { return "Reflected Binary"; }
+		bool IsExpensive() const override { return false; }
+
+		bool Generate( int bitCount, uint32_t, const SearchBudget&, GeneratedCode& out ) const override
+		{
+			const uint64_t count = uint64_t( 1 ) << bitCount;
+
+			out.codes.resize( count );
+			for ( uint64_t i = 0; i < count; ++i )
+			{
+				out.codes[i] = static_cast<unsigned int>( i ^ (i >> 1) );
+			}
+
+			return true;
+		}
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	template<class T>
+	void WritePod( std::ofstream& file, const T& value )
+	{
+		file.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	template<class T>
+	void WriteArray( std::ofstream& file, const std::vector<T>& values )
+	{
+		WritePod( file, static_cast<uint64_t>( values.size() ) );
+		file.write( reinterpret_cast<const char*>( values.data() ), values.size() * sizeof( T ) );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	template<class T>
+	bool ReadPod( std::ifstream& file, T& value )
+	{
+		return static_cast<bool>( file.read( reinterpret_cast<char*>( &value ), sizeof( T ) ) );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	template<class T>
+	bool ReadArray( std::ifstream& file, std::vector<T>& values, uint64_t maxCount )
+	{
+		uint64_t count = 0;
+		if ( !ReadPod( file, count ) || count > maxCount )
+		{
+			return false;
+		}
+
+		values.resize( count );
+		return static_cast<bool>( file.read( reinterpret_cast<char*>( values.data() ), count * sizeof( T ) ) );
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::unique_ptr<CodeFamily> CreateReflectedFamily()
+{
+	return std::make_unique<ReflectedFamily>();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// CodeFamilyEngine
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+CodeFamilyEngine::CodeFamilyEngine()
+{
+	m_families.push_back( CreateReflectedFamily() );
+	m_families.push_back( CreateBalancedFamily() );
+	m_families.push_back( CreateMaxRunLengthFamily() );
+	m_families.push_back( CreateSingleTrackFamily() );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void CodeFamilyEngine::SetCacheDirectory( const std::filesystem::path& dir )
+{
+	m_cacheDir = dir;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void CodeFamilyEngine::SetBudget( const SearchBudget& budget )
+{
+	m_budget = budget;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const CodeFamily* CodeFamilyEngine::GetFamily( CodeFamilyType type ) const
+{
+	for ( const std::unique_ptr<CodeFamily>& family : m_families )
+	{
+		if ( family->GetType() == type )
+		{
+			return family.get();
+		}
+	}
+
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+GeneratedCode CodeFamilyEngine::Generate( CodeFamilyType type, int bitCount, uint32_t param /*= 0*/ ) const
+{
+	GeneratedCode code;
+	code.family = type;
+	code.bitCount = bitCount;
+
+	const CodeFamily* family = GetFamily( type );
+	const bool cacheable = family != nullptr && family->IsExpensive() && !m_cacheDir.empty();
+	const std::filesystem::path cachePath = cacheable ? GetCachePath( type, bitCount, param ) : std::filesystem::path();
+
+	if ( cacheable && LoadCached( cachePath, code ) )
+	{
+		code.fromCache = true;
+		return code;
+	}
+
+	if ( family != nullptr && family->Generate( bitCount, param, m_budget, code ) )
+	{
+		code.exact = true;
+		code.minRunLength = MeasureMinRunLength( code.codes, bitCount );
+
+		if ( cacheable )
+		{
+			StoreCached( cachePath, code );
+		}
+
+		return code;
+	}
+
+	// Out of budget, use the reflected code so there is always something to render.
+	GeneratedCode fallback;
+	fallback.family = CodeFamilyType::Reflected;
+	fallback.bitCount = bitCount;
+	ReflectedFamily().Generate( bitCount, 0, m_budget, fallback );
+	fallback.minRunLength = MeasureMinRunLength( fallback.codes, bitCount );
+
+	return fallback;
+}
+
+//------------------------------------------------------------------------------
+// Shortest distance between two flips of the same bit, wrapping around.
+// Assumes the codes already passed validation (one bit per step).
+//------------------------------------------------------------------------------
+uint32_t CodeFamilyEngine::MeasureMinRunLength( const std::vector<unsigned int>& codes, int bitCount )
+{
+	const uint64_t count = codes.size();
+	if ( count < 2 || bitCount < 1 )
+	{
+		return 0;
+	}
+
+	std::vector<uint64_t> first( bitCount, UINT64_MAX );
+	std::vector<uint64_t> last( bitCount, UINT64_MAX );
+	uint64_t shortest = count;
+
+	for ( uint64_t step = 0; step < count; ++step )
+	{
+		const unsigned int diff = codes[step] ^ codes[(step + 1) % count];
+		if ( diff == 0 )
+		{
+			continue;
+		}
+
+		const int bit = std::countr_zero( diff );
+		if ( bit >= bitCount )
+		{
+			continue;
+		}
+
+		if ( last[bit] != UINT64_MAX )
+		{
+			shortest = std::min( shortest, step - last[bit] );
+		}
+		else
+		{
+			first[bit] = step;
+		}
+
+		last[bit] = step;
+	}
+
+	for ( int bit = 0; bit < bitCount; ++bit )
+	{
+		if ( first[bit] != UINT64_MAX )
+		{
+			shortest = std::min( shortest, first[bit] + count - last[bit] );
+		}
+	}
+
+	return static_cast<uint32_t>( shortest );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::filesystem::path CodeFamilyEngine::GetCachePath( CodeFamilyType type, int bitCount, uint32_t param ) const
+{
+	const std::string name = "family" + std::to_string( static_cast<uint32_t>( type ) )
+		+ "_n" + std::to_string( bitCount )
+		+ "_p" + std::to_string( param )
+		+ ".gcode";
+
+	return m_cacheDir / name;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool CodeFamilyEngine::LoadCached( const std::filesystem::path& path, GeneratedCode& out ) const
+{
+	std::ifstream file( path, std::ios::binary );
+	if ( !file )
+	{
+		return false;
+	}
+
+	uint32_t magic = 0;
+	uint32_t family = 0;
+	int32_t bitCount = 0;
+	if ( !ReadPod( file, magic ) || magic != CacheMagic
+		|| !ReadPod( file, family ) || family != static_cast<uint32_t>( out.family )
+		|| !ReadPod( file, bitCount ) || bitCount != out.bitCount
+		|| !ReadPod( file, out.minRunLength ) )
+	{
+		return false;
+	}
+
+	const uint64_t maxCodes = uint64_t( 1 ) << bitCount;
+	if ( !ReadArray( file, out.codes, maxCodes )
+		|| !ReadArray( file, out.ring, maxCodes )
+		|| !ReadArray( file, out.headOffsets, 64 ) )
+	{
+		return false;
+	}
+
+	// Don't trust the file, a corrupt cache must never reach the printer.
+	out.exact = CodeValidator::Validate( out.codes, bitCount ).valid;
+	return out.exact;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void CodeFamilyEngine::StoreCached( const std::filesystem::path& path, const GeneratedCode& code ) const
+{
+	std::error_code error;
+	std::filesystem::create_directories( path.parent_path(), error );
+
+	std::ofstream file( path, std::ios::binary | std::ios::trunc );
+	if ( !file )
+	{
+		return;
+	}
+
+	WritePod( file, CacheMagic );
+	WritePod( file, static_cast<uint32_t>( code.family ) );
+	WritePod( file, static_cast<int32_t>( code.bitCount ) );
+	WritePod( file, code.minRunLength );
+	WriteArray( file, code.codes );
+	WriteArray( file, code.ring );
+	WriteArray( file, code.headOffsets );
+}
@@ -0,0 +1,140 @@
+/*------------------------------------------------------------------------------
+	()      File:   code_family.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Pluggable Gray code families and an on disk cache for searched codes.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class CodeFamilyType : uint32_t
+{
+	Reflected,		// Standard reflected binary Gray code.
+	Balanced,		// Transition counts spread as evenly as possible across tracks.
+	MaxRunLength,	// Longest possible shortest run on any track (Goddyn-Gvozdjak style).
+	SingleTrack,	// One ring read by equally spaced heads.
+	Count
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct SearchBudget
+{
+	double seconds = 5.0;
+	uint32_t threads = 0;	// 0 = one per core.
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// GeneratedCode
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct GeneratedCode
+{
+	CodeFamilyType family = CodeFamilyType::Reflected;
+	int bitCount = 0;
+
+	// One codeword per sector, in angular order.
+	std::vector<unsigned int> codes;
+
+	// Single track codes only. ring[i] is the value of the shared track at
+	// sector i, head h reads sector (i + headOffsets[h]) as bit h.
+	std::vector<uint8_t> ring;
+	std::vector<uint32_t> headOffsets;
+
+	// Shortest run of equal bits on any track, in sectors.
+	uint32_t minRunLength = 0;
+
+	// False if the search ran out of budget and this is a fallback.
+	bool exact = false;
+	bool fromCache = false;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// CodeFamily
+//	A generator for one family of cyclic Gray codes.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class CodeFamily
+{
+public:
+	virtual ~CodeFamily() = default;
+
+	virtual CodeFamilyType GetType() const = 0;
+	virtual const char* GetName() const = 0;
+
+	// Worth caching on disk, i.e. generation involves a search.
+	virtual bool IsExpensive() const = 0;
+
+	// param is family specific (single track: period, 0 = longest).
+	virtual bool Generate( int bitCount, uint32_t param, const SearchBudget& budget, GeneratedCode& out ) const = 0;
+};
+
+std::unique_ptr<CodeFamily> CreateReflectedFamily();
+std::unique_ptr<CodeFamily> CreateBalancedFamily();
+std::unique_ptr<CodeFamily> CreateMaxRunLengthFamily();
+std::unique_ptr<CodeFamily> CreateSingleTrackFamily();
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// CodeFamilyEngine
+//	Owns the registered families and a disk cache of search results.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class CodeFamilyEngine
+{
+public:
+	CodeFamilyEngine();
+
+	void SetCacheDirectory( const std::filesystem::path& dir );
+	void SetBudget( const SearchBudget& budget );
+
+	const CodeFamily* GetFamily( CodeFamilyType type ) const;
+
+	// Falls back to the reflected code if the family can't produce one in budget.
+	GeneratedCode Generate( CodeFamilyType type, int bitCount, uint32_t param = 0 ) const;
+
+	static uint32_t MeasureMinRunLength( const std::vector<unsigned int>& codes, int bitCount );
+
+private:
+	std::filesystem::path GetCachePath( CodeFamilyType type, int bitCount, uint32_t param ) const;
+	bool LoadCached( const std::filesystem::path& path, GeneratedCode& out ) const;
+	void StoreCached( const std::filesystem::path& path, const GeneratedCode& code ) const;
+
+private:
+	std::vector<std::unique_ptr<CodeFamily>> m_families;
+	std::filesystem::path m_cacheDir;
+	SearchBudget m_budget;
+};
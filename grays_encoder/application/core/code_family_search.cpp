@@ -0,0 +1,836 @@
+/*------------------------------------------------------------------------------
+	()      File:   code_family_search.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Search based code families: balanced, maximum run length and single track.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include "application/core/code_family.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	using clock = std::chrono::steady_clock;
+
+	// Hamiltonian cycle search on the n-cube stops being practical past this.
+	constexpr int MaxSearchBits = 10;
+	// Necklace tables are 2^n entries.
+	constexpr int MaxSingleTrackHeads = 16;
+
+	constexpr int64_t Never = INT64_MIN;
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// SearchControl
+	//	Shared between the workers of one portfolio search, first result wins.
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	struct SearchControl
+	{
+		explicit SearchControl( clock::time_point deadlineIn )
+			: deadline( deadlineIn )
+		{
+		}
+
+		bool Expired() const
+		{
+			return stop.load( std::memory_order_relaxed ) || clock::now() >= deadline;
+		}
+
+		void Publish( const std::vector<unsigned int>& codes )
+		{
+			std::lock_guard<std::mutex> guard( lock );
+			if ( !found )
+			{
+				result = codes;
+				found = true;
+			}
+
+			stop = true;
+		}
+
+		std::atomic<bool> stop = false;
+		clock::time_point deadline;
+
+		std::mutex lock;
+		std::vector<unsigned int> result;
+		bool found = false;
+	};
+
+	//------------------------------------------------------------------------------
+	// Luby restart sequence, 1 1 2 1 1 2 4 1 1 2 ...
+	//------------------------------------------------------------------------------
+	uint64_t Luby( uint64_t i )
+	{
+		for ( uint64_t k = 1; ; ++k )
+		{
+			const uint64_t top = (uint64_t( 1 ) << k) - 1;
+			if ( i == top )
+			{
+				return uint64_t( 1 ) << (k - 1);
+			}
+			if ( i < top )
+			{
+				return Luby( i - (top >> 1) );
+			}
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// CycleSearch
+	//	Depth first search for a Hamiltonian cycle on the n-cube starting at 0.
+	//	Policy restricts which bit may flip at each step:
+	//	  void Reset();
+	//	  bool Allow( int bit, uint32_t step ) const;
+	//	  void Apply( int bit, uint32_t step );
+	//	  void Undo( int bit, uint32_t step );
+	//	  bool Feasible( uint32_t stepsTaken ) const;
+	//	  bool AllowClose( int bit, uint32_t step ) const;
+	//	  uint32_t Rank( int bit, uint32_t step ) const;	lower is tried first
+	//	Candidates are ordered by rank, then Warnsdorff's rule, then randomly
+	//	so each restart/worker explores a different part of the tree.
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	template<class Policy>
+	class CycleSearch
+	{
+	public:
+		enum class Outcome { Found, Exhausted, OutOfBudget };
+
+		CycleSearch( int n, const Policy& policy )
+			: m_n( n )
+			, m_count( 1u << n )
+			, m_policy( policy )
+		{
+			m_path.resize( m_count );
+			m_visited.resize( m_count );
+			m_degree.resize( m_count );
+			m_chosen.resize( m_count );
+			m_candidates.resize( size_t( m_count ) * n );
+			m_candidateNext.resize( m_count );
+		}
+
+		const std::vector<unsigned int>& GetPath() const
+		{
+			return m_path;
+		}
+
+		//------------------------------------------------------------------------------
+		// One restart.
+		//------------------------------------------------------------------------------
+		Outcome Run( SearchControl& control, uint64_t nodeLimit, uint32_t seed )
+		{
+			m_random.seed( seed );
+			m_policy.Reset();
+			std::fill( m_visited.begin(), m_visited.end(), uint8_t( 0 ) );
+			std::fill( m_degree.begin(), m_degree.end(), static_cast<uint8_t>( m_n ) );
+
+			m_path[0] = 0;
+			m_visited[0] = 1;
+
+			uint32_t depth = 0;
+			uint64_t nodes = 0;
+			BuildCandidates( depth );
+
+			for ( ;; )
+			{
+				if ( depth == m_count - 1 )
+				{
+					const unsigned int diff = m_path[depth] ^ m_path[0];
+					if ( std::has_single_bit( diff ) && m_policy.AllowClose( std::countr_zero( diff ), depth ) )
+					{
+						return Outcome::Found;
+					}
+				}
+				else if ( m_candidateNext[depth] < m_n )
+				{
+					const int bit = m_candidates[size_t( depth ) * m_n + m_candidateNext[depth]++];
+					const unsigned int here = m_path[depth];
+					const unsigned int next = here ^ (1u << bit);
+
+					if ( m_visited[next] || !m_policy.Allow( bit, depth ) )
+					{
+						continue;
+					}
+
+					m_policy.Apply( bit, depth );
+					m_visited[next] = 1;
+
+					if ( !m_policy.Feasible( depth + 1 ) || !Leave( here, next ) )
+					{
+						m_visited[next] = 0;
+						m_policy.Undo( bit, depth );
+						continue;
+					}
+
+					m_chosen[depth] = static_cast<uint8_t>( bit );
+					m_path[++depth] = next;
+					BuildCandidates( depth );
+
+					if ( ++nodes > nodeLimit || ((nodes & 0xFFF) == 0 && control.Expired()) )
+					{
+						return Outcome::OutOfBudget;
+					}
+
+					continue;
+				}
+
+				// Backtrack.
+				if ( depth == 0 )
+				{
+					return Outcome::Exhausted;
+				}
+
+				const unsigned int leaving = m_path[depth];
+				--depth;
+
+				m_visited[leaving] = 0;
+				Return( m_path[depth], leaving );
+				m_policy.Undo( m_chosen[depth], depth );
+			}
+		}
+
+	private:
+		//------------------------------------------------------------------------------
+		// The path head moves from here to next. here is no longer available to its
+		// other neighbours; any of them left with no way in and out is a dead end.
+		// A single remaining link is fine only for a neighbour of 0, which can end
+		// the cycle.
+		//------------------------------------------------------------------------------
+		bool Leave( unsigned int here, unsigned int next )
+		{
+			bool alive = true;
+
+			for ( int bit = 0; bit < m_n; ++bit )
+			{
+				const unsigned int neighbour = here ^ (1u << bit);
+				if ( m_visited[neighbour] || neighbour == next )
+				{
+					continue;
+				}
+
+				const uint8_t degree = --m_degree[neighbour];
+				if ( degree == 0 || (degree == 1 && !std::has_single_bit( neighbour )) )
+				{
+					alive = false;
+				}
+			}
+
+			if ( !alive )
+			{
+				Return( here, next );
+			}
+
+			return alive;
+		}
+
+		//------------------------------------------------------------------------------
+		// Undoes Leave( here, next ).
+		//------------------------------------------------------------------------------
+		void Return( unsigned int here, unsigned int next )
+		{
+			for ( int bit = 0; bit < m_n; ++bit )
+			{
+				const unsigned int neighbour = here ^ (1u << bit);
+				if ( !m_visited[neighbour] && neighbour != next )
+				{
+					++m_degree[neighbour];
+				}
+			}
+		}
+
+		//------------------------------------------------------------------------------
+		//------------------------------------------------------------------------------
+		void BuildCandidates( uint32_t depth )
+		{
+			const unsigned int here = m_path[depth];
+			uint64_t keys[32];
+
+			for ( int bit = 0; bit < m_n; ++bit )
+			{
+				const uint64_t rank = std::min<uint32_t>( m_policy.Rank( bit, depth ), 0xFFFFFF );
+				const uint64_t degree = m_degree[here ^ (1u << bit)];
+
+				keys[bit] = (rank << 40) | (degree << 32) | ((m_random() & 0xFFFFFF) << 8) | uint64_t( bit );
+			}
+
+			std::sort( keys, keys + m_n );
+
+			int8_t* candidates = &m_candidates[size_t( depth ) * m_n];
+			for ( int i = 0; i < m_n; ++i )
+			{
+				candidates[i] = static_cast<int8_t>( keys[i] & 0xFF );
+			}
+
+			m_candidateNext[depth] = 0;
+		}
+
+	private:
+		int m_n;
+		uint32_t m_count;
+		Policy m_policy;
+		std::minstd_rand m_random;
+
+		std::vector<unsigned int> m_path;
+		std::vector<uint8_t> m_visited;
+		// Neighbours that are unvisited or the path head.
+		std::vector<uint8_t> m_degree;
+		std::vector<uint8_t> m_chosen;
+		std::vector<int8_t> m_candidates;
+		std::vector<uint8_t> m_candidateNext;
+	};
+
+	//------------------------------------------------------------------------------
+	// Runs the same policy on every worker with different seeds and restarts.
+	//------------------------------------------------------------------------------
+	template<class Policy>
+	bool PortfolioSearch( int n, const Policy& policy, const SearchBudget& budget, clock::time_point deadline, std::vector<unsigned int>& out )
+	{
+		SearchControl control( deadline );
+
+		parallel::ForRange( parallel::HardwareThreadCount(), budget.threads, [&]( uint64_t begin, uint64_t /*end*/, uint32_t worker )
+		{
+			CycleSearch<Policy> search( n, policy );
+
+			for ( uint64_t attempt = 1; !control.Expired(); ++attempt )
+			{
+				const uint64_t nodeLimit = Luby( attempt ) * (uint64_t( 1 ) << (n + 8));
+				const uint32_t seed = static_cast<uint32_t>( begin * 7919 + attempt * 104729 + worker );
+
+				switch ( search.Run( control, nodeLimit, seed ) )
+				{
+				case CycleSearch<Policy>::Outcome::Found:
+					control.Publish( search.GetPath() );
+					return;
+
+				case CycleSearch<Policy>::Outcome::Exhausted:
+					// Whole tree covered, no seed can do better.
+					control.stop = true;
+					return;
+
+				default:
+					break;
+				}
+			}
+		} );
+
+		if ( control.found )
+		{
+			out = std::move( control.result );
+		}
+
+		return control.found;
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// BalancedPolicy
+	//	Every bit flips either lo or hi times, lo and hi even and hi - lo <= 2.
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	class BalancedPolicy
+	{
+	public:
+		explicit BalancedPolicy( int n )
+			: m_n( n )
+			, m_total( 1u << n )
+		{
+			m_low = 2 * (m_total / (2 * n));
+			m_high = (m_low * n == m_total) ? m_low : m_low + 2;
+		}
+
+		void Reset()
+		{
+			std::fill( std::begin( m_flips ), std::end( m_flips ), 0u );
+			m_deficit = m_low * m_n;
+		}
+
+		bool Allow( int bit, uint32_t ) const
+		{
+			return m_flips[bit] < m_high;
+		}
+
+		void Apply( int bit, uint32_t )
+		{
+			m_deficit -= m_flips[bit]++ < m_low ? 1 : 0;
+		}
+
+		void Undo( int bit, uint32_t )
+		{
+			m_deficit += --m_flips[bit] < m_low ? 1 : 0;
+		}
+
+		bool Feasible( uint32_t stepsTaken ) const
+		{
+			return m_deficit <= m_total - stepsTaken;
+		}
+
+		bool AllowClose( int bit, uint32_t ) const
+		{
+			// Closing is the last flip, so all other bits must already be done.
+			return m_flips[bit] < m_high && m_deficit <= 1 && (m_deficit == 0 || m_flips[bit] + 1 == m_low);
+		}
+
+		uint32_t Rank( int bit, uint32_t ) const
+		{
+			return m_flips[bit];
+		}
+
+	private:
+		int m_n;
+		uint32_t m_total;
+		uint32_t m_low;
+		uint32_t m_high;
+		uint32_t m_deficit = 0;
+		uint32_t m_flips[32] = {};
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// MinGapPolicy
+	//	No bit may flip twice within `gap` steps, including across the wrap.
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	class MinGapPolicy
+	{
+	public:
+		MinGapPolicy( int n, uint32_t gap )
+			: m_n( n )
+			, m_total( 1u << n )
+			, m_gap( gap )
+		{
+			m_undoLast.resize( m_total );
+			m_undoFirst.resize( m_total );
+		}
+
+		void Reset()
+		{
+			std::fill( std::begin( m_last ), std::end( m_last ), Never );
+			std::fill( std::begin( m_first ), std::end( m_first ), Never );
+		}
+
+		bool Allow( int bit, uint32_t step ) const
+		{
+			if ( m_last[bit] == Never )
+			{
+				return true;
+			}
+
+			return step - m_last[bit] >= m_gap && step + m_gap <= m_first[bit] + m_total;
+		}
+
+		void Apply( int bit, uint32_t step )
+		{
+			m_undoLast[step] = m_last[bit];
+			m_undoFirst[step] = m_first[bit];
+
+			m_last[bit] = step;
+			if ( m_first[bit] == Never )
+			{
+				m_first[bit] = step;
+			}
+		}
+
+		void Undo( int bit, uint32_t step )
+		{
+			m_last[bit] = m_undoLast[step];
+			m_first[bit] = m_undoFirst[step];
+		}
+
+		bool Feasible( uint32_t ) const
+		{
+			return true;
+		}
+
+		bool AllowClose( int bit, uint32_t step ) const
+		{
+			if ( !Allow( bit, step ) )
+			{
+				return false;
+			}
+
+			for ( int other = 0; other < m_n; ++other )
+			{
+				const int64_t last = other == bit ? step : m_last[other];
+				const int64_t first = m_first[other] == Never ? step : m_first[other];
+
+				if ( last == Never || first + m_total - last < m_gap )
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		// The gap constraint already steers towards old bits, leave ordering to Warnsdorff.
+		uint32_t Rank( int, uint32_t ) const
+		{
+			return 0;
+		}
+
+	private:
+		int m_n;
+		uint32_t m_total;
+		uint32_t m_gap;
+		int64_t m_last[32] = {};
+		int64_t m_first[32] = {};
+		std::vector<int64_t> m_undoLast;
+		std::vector<int64_t> m_undoFirst;
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// BalancedFamily
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	class BalancedFamily final : public CodeFamily
+	{
+	public:
+		CodeFamilyType GetType() const override { return CodeFamilyType::Balanced; }
+		const char* GetName() const override { return "Balanced"; }
+		bool IsExpensive() const override { return true; }
+
+		bool Generate( int bitCount, uint32_t, const SearchBudget& budget, GeneratedCode& out ) const override
+		{
+			if ( bitCount < 2 || bitCount > MaxSearchBits )
+			{
+				return false;
+			}
+
+			const clock::time_point deadline = clock::now() + std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>( budget.seconds ) );
+			return PortfolioSearch( bitCount, BalancedPolicy( bitCount ), budget, deadline, out.codes );
+		}
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// MaxRunLengthFamily
+	//	Raises the minimum gap one step at a time, keeping the last code found.
+	//	The reflected code (gap 2) is the starting point.
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	class MaxRunLengthFamily final : public CodeFamily
+	{
+	public:
+		CodeFamilyType GetType() const override { return CodeFamilyType::MaxRunLength; }
+		const char* GetName() const override { return "Maximum Run Length"; }
+		bool IsExpensive() const override { return true; }
+
+		bool Generate( int bitCount, uint32_t, const SearchBudget& budget, GeneratedCode& out ) const override
+		{
+			if ( bitCount < 2 || bitCount > MaxSearchBits )
+			{
+				return false;
+			}
+
+			CreateReflectedFamily()->Generate( bitCount, 0, budget, out );
+
+			const clock::time_point deadline = clock::now() + std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>( budget.seconds ) );
+
+			// A window of `gap` steps must flip distinct bits, so gap < n.
+			bool found = false;
+			for ( uint32_t gap = 3; gap < static_cast<uint32_t>( bitCount ); ++gap )
+			{
+				std::vector<unsigned int> codes;
+				if ( !PortfolioSearch( bitCount, MinGapPolicy( bitCount, gap ), budget, deadline, codes ) )
+				{
+					break;
+				}
+
+				out.codes = std::move( codes );
+				found = true;
+			}
+
+			// Nothing beat reflected, the engine falls back to it without caching.
+			return found;
+		}
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	inline unsigned int RotateRight( unsigned int word, int n )
+	{
+		return (word >> 1) | ((word & 1u) << (n - 1));
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// Necklaces
+	//	Rotation classes of n bit words. classOf is -1 for words whose period is
+	//	shorter than n, those can't appear in an equally spaced single track code.
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	struct Necklaces
+	{
+		explicit Necklaces( int bits )
+			: n( bits )
+		{
+			const uint32_t count = 1u << n;
+			classOf.assign( count, -2 );
+
+			for ( unsigned int word = 0; word < count; ++word )
+			{
+				if ( classOf[word] != -2 )
+				{
+					continue;
+				}
+
+				unsigned int rotated = word;
+				int period = 0;
+				do
+				{
+					rotated = RotateRight( rotated, n );
+					++period;
+				} while ( rotated != word );
+
+				const int32_t id = period == n ? static_cast<int32_t>( representatives.size() ) : -1;
+				if ( id >= 0 )
+				{
+					representatives.push_back( word );
+				}
+
+				for ( int i = 0; i < n; ++i, rotated = RotateRight( rotated, n ) )
+				{
+					classOf[rotated] = id;
+				}
+			}
+		}
+
+		int n;
+		std::vector<int32_t> classOf;
+		std::vector<unsigned int> representatives;
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	// SingleTrackFamily
+	//	Heads are equally spaced m = P / n sectors apart, so the codeword m sectors
+	//	on is the current codeword rotated by one head. The first m codewords
+	//	therefore define the whole code and must come from distinct, aperiodic
+	//	necklace classes, with codeword m == rotr( codeword 0 ).
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	class SingleTrackFamily final : public CodeFamily
+	{
+	public:
+		CodeFamilyType GetType() const override { return CodeFamilyType::SingleTrack; }
+		const char* GetName() const override { return "Single Track"; }
+		bool IsExpensive() const override { return true; }
+
+		bool Generate( int bitCount, uint32_t period, const SearchBudget& budget, GeneratedCode& out ) const override
+		{
+			if ( bitCount < 2 || bitCount > MaxSingleTrackHeads )
+			{
+				return false;
+			}
+
+			const int n = bitCount;
+			const Necklaces necklaces( n );
+
+			const clock::time_point deadline = clock::now() + std::chrono::duration_cast<clock::duration>( std::chrono::duration<double>( budget.seconds ) );
+
+			// Steps per block must be even, rotation preserves popcount.
+			uint32_t firstBlock = static_cast<uint32_t>( necklaces.representatives.size() ) & ~1u;
+			uint32_t lastBlock = 2;
+
+			if ( period != 0 )
+			{
+				if ( period % (2 * n) != 0 || period / n > firstBlock )
+				{
+					return false;
+				}
+
+				firstBlock = lastBlock = period / n;
+			}
+
+			for ( uint32_t block = firstBlock; block >= lastBlock && clock::now() < deadline; block -= 2 )
+			{
+				// Longer periods may be infeasible, leave time for the shorter ones.
+				const clock::time_point now = clock::now();
+				const clock::time_point blockDeadline = block == lastBlock ? deadline : now + (deadline - now) / 2;
+
+				std::vector<unsigned int> words;
+				if ( SearchBlock( necklaces, block, budget, blockDeadline, words ) )
+				{
+					Expand( n, block, words, out );
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+	private:
+		//------------------------------------------------------------------------------
+		// Parallel over the starting necklace, first block found wins.
+		//------------------------------------------------------------------------------
+		static bool SearchBlock( const Necklaces& necklaces, uint32_t block, const SearchBudget& budget, clock::time_point deadline, std::vector<unsigned int>& out )
+		{
+			const int n = necklaces.n;
+			SearchControl control( deadline );
+
+			parallel::ForRange( necklaces.representatives.size(), budget.threads, [&]( uint64_t begin, uint64_t end, uint32_t )
+			{
+				std::vector<unsigned int> words( block + 1 );
+				std::vector<uint8_t> nextBit( block + 1 );
+				std::vector<uint8_t> used( necklaces.representatives.size() );
+
+				for ( uint64_t rep = begin; rep < end && !control.Expired(); ++rep )
+				{
+					std::fill( used.begin(), used.end(), uint8_t( 0 ) );
+
+					words[0] = necklaces.representatives[rep];
+					used[rep] = 1;
+
+					const unsigned int target = RotateRight( words[0], n );
+					uint32_t depth = 0;
+					uint64_t nodes = 0;
+					nextBit[0] = 0;
+
+					for ( ;; )
+					{
+						if ( nextBit[depth] == n )
+						{
+							if ( depth == 0 )
+							{
+								break;
+							}
+
+							--depth;
+							const int32_t id = necklaces.classOf[words[depth + 1]];
+							if ( depth + 1 < block )
+							{
+								used[id] = 0;
+							}
+							continue;
+						}
+
+						const unsigned int next = words[depth] ^ (1u << nextBit[depth]++);
+						const uint32_t remaining = block - (depth + 1);
+
+						if ( remaining == 0 )
+						{
+							if ( next == target )
+							{
+								words[block] = next;
+								control.Publish( std::vector<unsigned int>( words.begin(), words.begin() + block ) );
+								return;
+							}
+							continue;
+						}
+
+						const int32_t id = necklaces.classOf[next];
+						const int distance = std::popcount( next ^ target );
+						if ( id < 0 || used[id] || distance > static_cast<int>( remaining ) || ((remaining - distance) & 1) )
+						{
+							continue;
+						}
+
+						used[id] = 1;
+						words[++depth] = next;
+						nextBit[depth] = 0;
+
+						if ( (++nodes & 0xFFFF) == 0 && control.Expired() )
+						{
+							return;
+						}
+					}
+				}
+			} );
+
+			if ( control.found )
+			{
+				out = std::move( control.result );
+			}
+
+			return control.found;
+		}
+
+		//------------------------------------------------------------------------------
+		//------------------------------------------------------------------------------
+		static void Expand( int n, uint32_t block, const std::vector<unsigned int>& words, GeneratedCode& out )
+		{
+			const uint32_t period = block * n;
+
+			out.codes.resize( period );
+			out.ring.resize( period );
+			out.headOffsets.resize( n );
+
+			for ( uint32_t i = 0; i < block; ++i )
+			{
+				unsigned int word = words[i];
+				for ( int rotation = 0; rotation < n; ++rotation, word = RotateRight( word, n ) )
+				{
+					out.codes[i + rotation * block] = word;
+				}
+			}
+
+			// Head h reads bit h of codeword p at ring position p + h * block.
+			for ( uint32_t sector = 0; sector < period; ++sector )
+			{
+				out.ring[sector] = (words[sector % block] >> (sector / block)) & 1u;
+			}
+
+			for ( int head = 0; head < n; ++head )
+			{
+				out.headOffsets[head] = head * block;
+			}
+		}
+
+	};
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::unique_ptr<CodeFamily> CreateBalancedFamily()
+{
+	return std::make_unique<BalancedFamily>();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::unique_ptr<CodeFamily> CreateMaxRunLengthFamily()
+{
+	return std::make_unique<MaxRunLengthFamily>();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::unique_ptr<CodeFamily> CreateSingleTrackFamily()
+{
+	return std::make_unique<SingleTrackFamily>();
+}
@@ -0,0 +1,223 @@
+/*------------------------------------------------------------------------------
+	()      File:   code_validator.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Parallel exhaustive validator for the single bit change property.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <memory>
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "application/core/code_validator.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	// Workers poll the shared failure flag once per block.
+	constexpr uint64_t BlockSize = 1 << 16;
+
+	//------------------------------------------------------------------------------
+	// True if a ^ b has exactly one bit set and a has no bits above the mask.
+	//------------------------------------------------------------------------------
+	inline bool IsSingleBitStep( uint32_t a, uint32_t b )
+	{
+		const uint32_t diff = a ^ b;
+		return diff != 0 && (diff & (diff - 1)) == 0;
+	}
+
+	//------------------------------------------------------------------------------
+	// Scalar transition check over [begin, end), end exclusive and < count.
+	// Returns the first failing index or NoIndex.
+	//------------------------------------------------------------------------------
+	uint64_t CheckTransitionsScalar( const unsigned int* codes, uint64_t count, uint64_t begin, uint64_t end, uint32_t highMask )
+	{
+		for ( uint64_t i = begin; i < end; ++i )
+		{
+			const uint64_t next = (i + 1 == count) ? 0 : i + 1;
+			if ( (codes[i] & highMask) != 0 || !IsSingleBitStep( codes[i], codes[next] ) )
+			{
+				return i;
+			}
+		}
+
+		return CodeValidationResult::NoIndex;
+	}
+
+#if defined(_M_X64) || defined(__x86_64__)
+	//------------------------------------------------------------------------------
+	// AVX2 transition check, 8 neighbouring pairs per iteration. x & (x - 1) == 0
+	// with x != 0 is the popcount( x ) == 1 test without needing a vector popcount.
+	//------------------------------------------------------------------------------
+	uint64_t CheckTransitionsAvx2( const unsigned int* codes, uint64_t count, uint64_t begin, uint64_t end, uint32_t highMask )
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i ones = _mm256_set1_epi32( -1 );
+		const __m256i high = _mm256_set1_epi32( static_cast<int>( highMask ) );
+
+		// Last vector must not read past codes[count - 1] via the i + 1 load.
+		const uint64_t vecEnd = std::min( end, count - 1 );
+
+		uint64_t i = begin;
+		for ( ; i + 8 <= vecEnd; i += 8 )
+		{
+			const __m256i a = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( codes + i ) );
+			const __m256i b = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( codes + i + 1 ) );
+
+			const __m256i diff = _mm256_xor_si256( a, b );
+			const __m256i lowest = _mm256_and_si256( diff, _mm256_add_epi32( diff, ones ) );
+
+			const __m256i noChange = _mm256_cmpeq_epi32( diff, zero );
+			const __m256i oneBit = _mm256_cmpeq_epi32( lowest, zero );
+			const __m256i inRange = _mm256_cmpeq_epi32( _mm256_and_si256( a, high ), zero );
+
+			const __m256i bad = _mm256_or_si256( noChange, _mm256_andnot_si256( _mm256_and_si256( oneBit, inRange ), ones ) );
+			if ( _mm256_movemask_epi8( bad ) != 0 )
+			{
+				return CheckTransitionsScalar( codes, count, i, i + 8, highMask );
+			}
+		}
+
+		return CheckTransitionsScalar( codes, count, i, end, highMask );
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// CodeValidator
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+CodeValidationResult CodeValidator::Validate( const std::vector<unsigned int>& codes, int bitCount, uint32_t threads /*= 0*/ )
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	CodeValidationResult result;
+	result.codeCount = codes.size();
+
+	if ( bitCount < 1 || bitCount > 32 || codes.size() < 2 || codes.size() > (uint64_t( 1 ) << bitCount) )
+	{
+		return result;
+	}
+
+	const uint64_t count = codes.size();
+	const uint32_t highMask = bitCount == 32 ? 0u : ~((1u << bitCount) - 1u);
+
+#if defined(_M_X64) || defined(__x86_64__)
+	result.usedAvx2 = parallel::HasAvx2();
+#endif
+
+	// One bit per possible codeword, n=28 is 32MiB.
+	const uint64_t bitmapWords = ((uint64_t( 1 ) << bitCount) + 63) / 64;
+	std::unique_ptr<std::atomic<uint64_t>[]> seen( new std::atomic<uint64_t>[bitmapWords] );
+
+	std::atomic<bool> failed = false;
+	std::vector<uint64_t> badTransitions;
+	std::vector<uint64_t> duplicates;
+
+	// Clear the bitmap in parallel too, it's a large share of the work at high n.
+	parallel::ForRange( bitmapWords, threads, [&]( uint64_t begin, uint64_t end, uint32_t )
+	{
+		for ( uint64_t word = begin; word < end; ++word )
+		{
+			seen[word].store( 0, std::memory_order_relaxed );
+		}
+	} );
+
+	const uint32_t workerCount = std::max( 1u, threads == 0 ? parallel::HardwareThreadCount() : threads );
+	badTransitions.assign( workerCount, CodeValidationResult::NoIndex );
+	duplicates.assign( workerCount, CodeValidationResult::NoIndex );
+
+	result.threadsUsed = parallel::ForRange( count, workerCount, [&]( uint64_t begin, uint64_t end, uint32_t worker )
+	{
+		for ( uint64_t block = begin; block < end && !failed.load( std::memory_order_relaxed ); block += BlockSize )
+		{
+			const uint64_t blockEnd = std::min( end, block + BlockSize );
+
+		#if defined(_M_X64) || defined(__x86_64__)
+			const uint64_t bad = result.usedAvx2
+				? CheckTransitionsAvx2( codes.data(), count, block, blockEnd, highMask )
+				: CheckTransitionsScalar( codes.data(), count, block, blockEnd, highMask );
+		#else
+			const uint64_t bad = CheckTransitionsScalar( codes.data(), count, block, blockEnd, highMask );
+		#endif
+
+			if ( bad != CodeValidationResult::NoIndex )
+			{
+				badTransitions[worker] = bad;
+				failed = true;
+				return;
+			}
+
+			for ( uint64_t i = block; i < blockEnd; ++i )
+			{
+				const uint32_t code = codes[i];
+				const uint64_t mask = uint64_t( 1 ) << (code & 63);
+
+				if ( seen[code >> 6].fetch_or( mask, std::memory_order_relaxed ) & mask )
+				{
+					duplicates[worker] = i;
+					failed = true;
+					return;
+				}
+			}
+		}
+	} );
+
+	for ( uint32_t worker = 0; worker < workerCount; ++worker )
+	{
+		result.badTransition = std::min( result.badTransition, badTransitions[worker] );
+		result.duplicate = std::min( result.duplicate, duplicates[worker] );
+	}
+
+	// A codeword with stray high bits also breaks both transitions around it.
+	if ( result.badTransition != CodeValidationResult::NoIndex )
+	{
+		const uint64_t next = (result.badTransition + 1 == count) ? 0 : result.badTransition + 1;
+
+		if ( (codes[result.badTransition] & highMask) != 0 )
+		{
+			result.outOfRange = result.badTransition;
+		}
+		else if ( (codes[next] & highMask) != 0 )
+		{
+			result.outOfRange = next;
+		}
+	}
+
+	result.valid = !failed;
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	return result;
+}
@@ -0,0 +1,74 @@
+/*------------------------------------------------------------------------------
+	()      File:   code_validator.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Parallel exhaustive validator for the single bit change property.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// CodeValidationResult
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct CodeValidationResult
+{
+	static constexpr uint64_t NoIndex = UINT64_MAX;
+
+	bool valid = false;
+	uint64_t codeCount = 0;
+
+	// Index i where code[i] -> code[i + 1] (wrapping) is not a single bit change.
+	uint64_t badTransition = NoIndex;
+	// Index of a codeword that has already been seen earlier in the sequence.
+	uint64_t duplicate = NoIndex;
+	// Index of a codeword with bits set above the requested bit count.
+	uint64_t outOfRange = NoIndex;
+
+	uint32_t threadsUsed = 0;
+	bool usedAvx2 = false;
+	double elapsedMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// CodeValidator
+//	Exhaustively checks that a codeword sequence is a cyclic Gray code:
+//	 * every codeword fits in bitCount bits,
+//	 * neighbouring codewords (including last -> first) differ in exactly one bit,
+//	 * no codeword appears twice.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class CodeValidator
+{
+public:
+	static CodeValidationResult Validate( const std::vector<unsigned int>& codes, int bitCount, uint32_t threads = 0 );
+};
@@ -0,0 +1,529 @@
+/*------------------------------------------------------------------------------
+	()      File:   firmware_tables.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Decode table header generator for encoder firmware.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include "application/core/firmware_tables.h"
+#include "utility/version.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	// Direct and packed tables stop at a million entries.
+	constexpr int MaxTableBits = 20;
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	void Append( std::string& out, const char* format, ... )
+	{
+		char buffer[512];
+
+		va_list args;
+		va_start( args, format );
+		const int written = vsnprintf( buffer, sizeof( buffer ), format, args );
+		va_end( args );
+
+		if ( written > 0 )
+		{
+			out.append( buffer, std::min<size_t>( written, sizeof( buffer ) - 1 ) );
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	// Bits needed to hold value.
+	//------------------------------------------------------------------------------
+	uint32_t BitWidth( uint64_t value )
+	{
+		uint32_t width = 0;
+		while ( value >> width )
+		{
+			++width;
+		}
+
+		return std::max( width, 1u );
+	}
+
+	//------------------------------------------------------------------------------
+	// Signed track offset folded into 0..period-1.
+	//------------------------------------------------------------------------------
+	uint32_t WrapOffset( int32_t offset, uint32_t period )
+	{
+		const int64_t wrapped = int64_t( offset ) % int64_t( period );
+		return static_cast<uint32_t>( wrapped < 0 ? wrapped + period : wrapped );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	bool HasTrackOffsets( const std::vector<int32_t>& offsets, uint32_t period )
+	{
+		return std::any_of( offsets.begin(), offsets.end(), [period]( int32_t offset ) { return WrapOffset( offset, period ) != 0; } );
+	}
+
+	//------------------------------------------------------------------------------
+	// Prefix reduced to something that is a valid C identifier.
+	//------------------------------------------------------------------------------
+	std::string Identifier( const std::string& prefix, bool upper )
+	{
+		std::string out;
+		for ( const char c : prefix )
+		{
+			const bool valid = isalnum( static_cast<unsigned char>( c ) ) || c == '_';
+			out.push_back( valid ? static_cast<char>( upper ? toupper( c ) : tolower( c ) ) : '_' );
+		}
+
+		if ( out.empty() || isdigit( static_cast<unsigned char>( out.front() ) ) )
+		{
+			out.insert( out.begin(), '_' );
+		}
+
+		return out;
+	}
+
+	//------------------------------------------------------------------------------
+	// Everything the emitters share.
+	//------------------------------------------------------------------------------
+	struct Layout
+	{
+		uint32_t bits = 0;
+		uint32_t period = 0;
+		uint32_t readingMask = 0;
+		// Every reading maps to a position, so no invalid entries or checks.
+		bool complete = false;
+		bool reflected = false;
+		bool powerOfTwo = false;
+
+		// Direct table element, 1, 2 or 4 bytes.
+		uint32_t lookupBytes = 0;
+		// Packed table entry width in bits.
+		uint32_t packedWidth = 0;
+		uint32_t packedWords = 0;
+
+		std::vector<uint32_t> positions;
+	};
+
+	//------------------------------------------------------------------------------
+	// Ops shared by every decoder: polarity, reading mask, zero offset and the
+	// invalid check for incomplete codes.
+	//------------------------------------------------------------------------------
+	uint32_t CommonAluOps( const Layout& layout, const FirmwareOptions& options, bool hasInvalid )
+	{
+		const bool polarity = options.emitCalibration && options.polarityMask != 0;
+		const bool offset = options.emitCalibration && options.zeroOffset % layout.period != 0;
+
+		uint32_t ops = 1 + (polarity ? 1 : 0);
+		ops += offset ? (layout.powerOfTwo ? 2 : 3) : 0;
+		ops += hasInvalid && offset ? 2 : 0;
+		return ops;
+	}
+
+	//------------------------------------------------------------------------------
+	// Cycle model for a Cortex-M class core: shifted operands are free on
+	// Thumb-2 so each xor/shift stage is a single op.
+	//------------------------------------------------------------------------------
+	FirmwareVariantReport Report( FirmwareDecoder decoder, const Layout& layout, const FirmwareOptions& options )
+	{
+		FirmwareVariantReport report;
+		report.decoder = decoder;
+
+		switch ( decoder )
+		{
+		case FirmwareDecoder::Lookup:
+			report.available = layout.bits <= MaxTableBits;
+			report.tableBytes = (1u << std::min<uint32_t>( layout.bits, MaxTableBits )) * layout.lookupBytes;
+			report.loads = 1;
+			report.aluOps = CommonAluOps( layout, options, !layout.complete );
+			break;
+
+		case FirmwareDecoder::PackedLookup:
+			report.available = layout.bits <= MaxTableBits;
+			report.tableBytes = layout.packedWords * 4;
+			report.loads = 2;
+			// mul, word, shift, 2 x shift + rsb + orr for the straddling entry, extract.
+			report.aluOps = 8 + CommonAluOps( layout, options, !layout.complete );
+			break;
+
+		case FirmwareDecoder::XorPrefix:
+			report.available = layout.reflected;
+			report.tableBytes = 0;
+			report.loads = 0;
+			report.aluOps = BitWidth( layout.bits - 1 ) - (layout.bits == 1 ? 1 : 0) + CommonAluOps( layout, options, false );
+			break;
+
+		default:
+			break;
+		}
+
+		report.estimatedCycles = report.aluOps + report.loads * (2 + options.flashWaitStates);
+		return report;
+	}
+
+	//------------------------------------------------------------------------------
+	// Tail of every decode function: zero offset and the return.
+	//------------------------------------------------------------------------------
+	void EmitReturn( std::string& out, const std::string& macro, const Layout& layout, const FirmwareOptions& options, const char* value )
+	{
+		if ( !options.emitCalibration || options.zeroOffset % layout.period == 0 )
+		{
+			Append( out, "\treturn %s;\n", value );
+		}
+		else if ( layout.powerOfTwo )
+		{
+			Append( out, "\treturn (%s + %s_ZERO_OFFSET) & (%s_POSITIONS - 1u);\n", value, macro.c_str(), macro.c_str() );
+		}
+		else
+		{
+			Append( out, "\tconst uint32_t shifted = %s + %s_ZERO_OFFSET;\n", value, macro.c_str() );
+			Append( out, "\treturn shifted >= %s_POSITIONS ? shifted - %s_POSITIONS : shifted;\n", macro.c_str(), macro.c_str() );
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	void EmitReading( std::string& out, const std::string& macro, const FirmwareOptions& options )
+	{
+		if ( options.emitCalibration )
+		{
+			Append( out, "\tconst uint32_t index = (reading ^ %s_POLARITY_MASK) & %s_READING_MASK;\n", macro.c_str(), macro.c_str() );
+		}
+		else
+		{
+			Append( out, "\tconst uint32_t index = reading & %s_READING_MASK;\n", macro.c_str() );
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	void EmitLookup( std::string& out, const std::string& macro, const std::string& symbol, const Layout& layout, const FirmwareOptions& options )
+	{
+		const char* type = layout.lookupBytes == 1 ? "uint8_t" : layout.lookupBytes == 2 ? "uint16_t" : "uint32_t";
+		const uint32_t perLine = layout.lookupBytes == 1 ? 16 : 8;
+		const int digits = static_cast<int>( layout.lookupBytes * 2 );
+		const uint32_t invalid = layout.lookupBytes == 4 ? UINT32_MAX : (1u << (layout.lookupBytes * 8)) - 1;
+
+		Append( out, "static const %s %s_table[%u] =\n{\n", type, symbol.c_str(), layout.readingMask + 1 );
+		for ( uint32_t reading = 0; reading <= layout.readingMask; ++reading )
+		{
+			const uint32_t position = layout.positions[reading];
+
+			Append( out, "%s0x%0*Xu,%s",
+				reading % perLine == 0 ? "\t" : "",
+				digits, position == UINT32_MAX ? invalid : position,
+				(reading % perLine == perLine - 1 || reading == layout.readingMask) ? "\n" : " " );
+		}
+		Append( out, "};\n\n" );
+
+		Append( out, "static inline uint32_t %s_decode( uint32_t reading )\n{\n", symbol.c_str() );
+		EmitReading( out, macro, options );
+		Append( out, "\tconst uint32_t position = %s_table[index];\n", symbol.c_str() );
+
+		if ( !layout.complete )
+		{
+			Append( out, "\tif ( position == 0x%0*Xu )\n\t{\n\t\treturn %s_INVALID;\n\t}\n", digits, invalid, macro.c_str() );
+		}
+
+		EmitReturn( out, macro, layout, options, "position" );
+		Append( out, "}\n" );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	void EmitPackedLookup( std::string& out, const std::string& macro, const std::string& symbol, const Layout& layout, const FirmwareOptions& options )
+	{
+		const uint32_t width = layout.packedWidth;
+		const uint32_t entryMask = width == 32 ? UINT32_MAX : (1u << width) - 1;
+
+		std::vector<uint32_t> words( layout.packedWords, 0 );
+		for ( uint32_t reading = 0; reading <= layout.readingMask; ++reading )
+		{
+			const uint64_t value = std::min( layout.positions[reading], entryMask );
+			const uint64_t bit = uint64_t( reading ) * width;
+
+			words[bit >> 5] |= static_cast<uint32_t>( value << (bit & 31) );
+			if ( (bit & 31) + width > 32 )
+			{
+				words[(bit >> 5) + 1] |= static_cast<uint32_t>( value >> (32 - (bit & 31)) );
+			}
+		}
+
+		Append( out, "#define %s_ENTRY_BITS %uu\n\n", macro.c_str(), width );
+		Append( out, "/* %u bit entries, the last word is padding so the decoder can always read two. */\n", width );
+		Append( out, "static const uint32_t %s_table[%u] =\n{\n", symbol.c_str(), layout.packedWords );
+		for ( uint32_t word = 0; word < words.size(); ++word )
+		{
+			Append( out, "%s0x%08Xu,%s",
+				word % 8 == 0 ? "\t" : "",
+				words[word],
+				(word % 8 == 7 || word + 1 == words.size()) ? "\n" : " " );
+		}
+		Append( out, "};\n\n" );
+
+		Append( out, "static inline uint32_t %s_decode( uint32_t reading )\n{\n", symbol.c_str() );
+		EmitReading( out, macro, options );
+		Append( out, "\tconst uint32_t bit = index * %s_ENTRY_BITS;\n", macro.c_str() );
+		Append( out, "\tconst uint32_t shift = bit & 31u;\n" );
+		Append( out, "\tconst uint32_t low = %s_table[bit >> 5] >> shift;\n", symbol.c_str() );
+		Append( out, "\tconst uint32_t high = (%s_table[(bit >> 5) + 1] << 1) << (31u - shift);\n", symbol.c_str() );
+		Append( out, "\tconst uint32_t position = (low | high) & 0x%Xu;\n", entryMask );
+
+		if ( !layout.complete )
+		{
+			Append( out, "\tif ( position == 0x%Xu )\n\t{\n\t\treturn %s_INVALID;\n\t}\n", entryMask, macro.c_str() );
+		}
+
+		EmitReturn( out, macro, layout, options, "position" );
+		Append( out, "}\n" );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	void EmitXorPrefix( std::string& out, const std::string& macro, const std::string& symbol, const Layout& layout, const FirmwareOptions& options )
+	{
+		Append( out, "/* Reflected binary: binary = gray ^ (gray >> 1) ^ (gray >> 2) ^ ..., folded into log2(bits) steps. */\n" );
+		Append( out, "static inline uint32_t %s_decode( uint32_t reading )\n{\n", symbol.c_str() );
+		EmitReading( out, macro, options );
+		Append( out, "\tuint32_t position = index;\n" );
+
+		for ( uint32_t shift = 1; shift < layout.bits; shift <<= 1 )
+		{
+			Append( out, "\tposition ^= position >> %u;\n", shift );
+		}
+
+		EmitReturn( out, macro, layout, options, "position" );
+		Append( out, "}\n" );
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// FirmwareTableGenerator
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+FirmwareTables FirmwareTableGenerator::Generate( const std::vector<unsigned int>& codes, int bitCount, const FirmwareOptions& options )
+{
+	FirmwareTables tables;
+
+	if ( bitCount < 1 || bitCount > 31 || codes.size() < 2 || codes.size() > (uint64_t( 1 ) << bitCount) )
+	{
+		return tables;
+	}
+
+	//------------------------------------------------------
+	// Skew the readings by the per track sensor offsets.
+	//------------------------------------------------------
+	const uint32_t period = static_cast<uint32_t>( codes.size() );
+	const bool skewed = options.emitCalibration && HasTrackOffsets( options.trackOffsets, period );
+
+	std::vector<unsigned int> skewedCodes;
+	if ( skewed )
+	{
+		skewedCodes.assign( period, 0 );
+		for ( uint32_t track = 0; track < static_cast<uint32_t>( bitCount ) && track < options.trackOffsets.size(); ++track )
+		{
+			const uint32_t shift = WrapOffset( options.trackOffsets[track], period );
+			for ( uint32_t position = 0; position < period; ++position )
+			{
+				skewedCodes[position] |= codes[(position + shift) % period] & (1u << track);
+			}
+		}
+
+		for ( uint32_t track = static_cast<uint32_t>( options.trackOffsets.size() ); track < static_cast<uint32_t>( bitCount ); ++track )
+		{
+			for ( uint32_t position = 0; position < period; ++position )
+			{
+				skewedCodes[position] |= codes[position] & (1u << track);
+			}
+		}
+	}
+
+	const std::vector<unsigned int>& readings = skewed ? skewedCodes : codes;
+
+	Layout layout;
+	layout.bits = static_cast<uint32_t>( bitCount );
+	layout.period = period;
+	layout.readingMask = (1u << layout.bits) - 1;
+	layout.complete = layout.period == (1u << layout.bits);
+	layout.powerOfTwo = (layout.period & (layout.period - 1)) == 0;
+
+	layout.reflected = layout.complete;
+	for ( uint32_t position = 0; position < layout.period && layout.reflected; ++position )
+	{
+		layout.reflected = readings[position] == (position ^ (position >> 1));
+	}
+
+	// Largest stored value, incomplete codes also need an all ones sentinel above the last position.
+	const uint32_t largest = layout.complete ? layout.period - 1 : layout.period;
+	layout.lookupBytes = largest <= 0xFF ? 1 : largest <= 0xFFFF ? 2 : 4;
+	layout.packedWidth = BitWidth( largest );
+
+	if ( layout.bits <= MaxTableBits )
+	{
+		layout.positions.assign( size_t( 1 ) << layout.bits, UINT32_MAX );
+		for ( uint32_t position = 0; position < layout.period; ++position )
+		{
+			// Offsets that make two positions read the same can't be decoded.
+			if ( readings[position] > layout.readingMask || layout.positions[readings[position]] != UINT32_MAX )
+			{
+				return tables;
+			}
+
+			layout.positions[readings[position]] = position;
+		}
+
+		layout.packedWords = static_cast<uint32_t>( ((uint64_t( 1 ) << layout.bits) * layout.packedWidth + 31) / 32 ) + 1;
+	}
+
+	//------------------------------------------------------
+	// Cost of every decoder, then pick one.
+	//------------------------------------------------------
+	tables.variants.resize( static_cast<size_t>( FirmwareDecoder::Count ) );
+	for ( uint32_t decoder = static_cast<uint32_t>( FirmwareDecoder::Lookup ); decoder < static_cast<uint32_t>( FirmwareDecoder::Count ); ++decoder )
+	{
+		tables.variants[decoder] = Report( static_cast<FirmwareDecoder>( decoder ), layout, options );
+	}
+
+	const auto available = [&tables]( FirmwareDecoder decoder ) { return tables.variants[static_cast<size_t>( decoder )].available; };
+
+	if ( options.decoder != FirmwareDecoder::Auto )
+	{
+		if ( options.decoder >= FirmwareDecoder::Count || !available( options.decoder ) )
+		{
+			return tables;
+		}
+
+		tables.chosen = options.decoder;
+	}
+	else if ( available( FirmwareDecoder::Lookup ) && tables.variants[static_cast<size_t>( FirmwareDecoder::Lookup )].tableBytes <= options.maxLookupBytes )
+	{
+		tables.chosen = FirmwareDecoder::Lookup;
+	}
+	else if ( available( FirmwareDecoder::XorPrefix ) )
+	{
+		tables.chosen = FirmwareDecoder::XorPrefix;
+	}
+	else if ( available( FirmwareDecoder::PackedLookup ) )
+	{
+		tables.chosen = FirmwareDecoder::PackedLookup;
+	}
+	else
+	{
+		return tables;
+	}
+
+	//------------------------------------------------------
+	// Header.
+	//------------------------------------------------------
+	const std::string macro = Identifier( options.symbolPrefix, true );
+	const std::string symbol = Identifier( options.symbolPrefix, false );
+	const FirmwareVariantReport& chosen = tables.variants[static_cast<size_t>( tables.chosen )];
+
+	std::string& out = tables.header;
+	Append( out, "/*\n * Generated by Grays Code Generator, %s. Do not edit.\n *\n", APP_VERSION );
+	Append( out, " * Code:    %s, %u bits, %u positions\n", options.familyName.empty() ? "custom" : options.familyName.c_str(), layout.bits, layout.period );
+	Append( out, " * Decoder: %s, %u bytes of table, ~%u cycles (%u flash wait states)\n", GetDecoderName( tables.chosen ), chosen.tableBytes, chosen.estimatedCycles, options.flashWaitStates );
+	Append( out, " *\n * Decoder          available  table bytes  loads  alu ops  est. cycles\n" );
+
+	for ( size_t decoder = static_cast<size_t>( FirmwareDecoder::Lookup ); decoder < tables.variants.size(); ++decoder )
+	{
+		const FirmwareVariantReport& variant = tables.variants[decoder];
+		Append( out, " * %-16s %-9s  %11u  %5u  %7u  %11u\n", GetDecoderName( variant.decoder ), variant.available ? "yes" : "no",
+			variant.tableBytes, variant.loads, variant.aluOps, variant.estimatedCycles );
+	}
+
+	Append( out, " */\n#ifndef %s_DECODE_H\n#define %s_DECODE_H\n\n#include <stdint.h>\n\n", macro.c_str(), macro.c_str() );
+	Append( out, "#define %s_BITS %uu\n", macro.c_str(), layout.bits );
+	Append( out, "#define %s_POSITIONS %uu\n", macro.c_str(), layout.period );
+	Append( out, "#define %s_READING_MASK 0x%Xu\n", macro.c_str(), layout.readingMask );
+
+	if ( !layout.complete && tables.chosen != FirmwareDecoder::XorPrefix )
+	{
+		Append( out, "/* Returned for readings that are not part of the code. */\n" );
+		Append( out, "#define %s_INVALID 0xFFFFFFFFu\n", macro.c_str() );
+	}
+
+	if ( options.emitCalibration )
+	{
+		Append( out, "\n/* Calibration: bit t inverts the sensor on track t, offset moves position 0. */\n" );
+		Append( out, "#define %s_POLARITY_MASK 0x%Xu\n", macro.c_str(), options.polarityMask & layout.readingMask );
+		Append( out, "#define %s_ZERO_OFFSET %uu\n", macro.c_str(), options.zeroOffset % layout.period );
+
+		if ( skewed )
+		{
+			Append( out, "/* Track offsets, already folded into the table:" );
+			for ( uint32_t track = 0; track < layout.bits; ++track )
+			{
+				Append( out, " %u:%u", track, track < options.trackOffsets.size() ? WrapOffset( options.trackOffsets[track], layout.period ) : 0u );
+			}
+			Append( out, " */\n" );
+		}
+	}
+
+	Append( out, "\n" );
+
+	switch ( tables.chosen )
+	{
+	case FirmwareDecoder::Lookup:
+		EmitLookup( out, macro, symbol, layout, options );
+		break;
+	case FirmwareDecoder::PackedLookup:
+		EmitPackedLookup( out, macro, symbol, layout, options );
+		break;
+	case FirmwareDecoder::XorPrefix:
+		EmitXorPrefix( out, macro, symbol, layout, options );
+		break;
+	default:
+		break;
+	}
+
+	Append( out, "\n#endif /* %s_DECODE_H */\n", macro.c_str() );
+
+	tables.valid = true;
+	return tables;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const char* FirmwareTableGenerator::GetDecoderName( FirmwareDecoder decoder )
+{
+	switch ( decoder )
+	{
+	case FirmwareDecoder::Auto: return "auto";
+	case FirmwareDecoder::Lookup: return "lookup table";
+	case FirmwareDecoder::PackedLookup: return "packed table";
+	case FirmwareDecoder::XorPrefix: return "xor prefix";
+	default: return "unknown";
+	}
+}
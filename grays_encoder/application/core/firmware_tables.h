@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------------
+	()      File:   firmware_tables.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Decode table header generator for encoder firmware.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class FirmwareDecoder : uint32_t
+{
+	Auto,
+	// Direct reading -> position table, one byte/halfword/word per entry.
+	Lookup,
+	// Same table with entries bit packed into 32 bit words.
+	PackedLookup,
+	// Branch free shift/xor prefix, reflected binary codes only, no table.
+	XorPrefix,
+
+	Count
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// FirmwareOptions
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct FirmwareOptions
+{
+	// Used for the include guard, the macros and the symbol names.
+	std::string symbolPrefix = "grays";
+	std::string familyName;
+
+	FirmwareDecoder decoder = FirmwareDecoder::Auto;
+
+	// Auto keeps direct tables up to this many bytes.
+	uint32_t maxLookupBytes = 1024;
+
+	// Per track calibration. Bit t set inverts the sensor on track t before decoding.
+	bool emitCalibration = false;
+	uint32_t polarityMask = 0;
+	// Added to every decoded position, so position 0 can be moved to the mechanical zero.
+	uint32_t zeroOffset = 0;
+	// Measured sensor misplacement in positions, entry t for track t. The sensor on track t
+	// reads the code at position + offset, the table is built from those skewed readings so
+	// the firmware decodes them without any extra work. Missing entries are 0.
+	std::vector<int32_t> trackOffsets;
+
+	// Cycle model: single cycle ALU ops, loads cost 2 plus the flash wait states.
+	uint32_t flashWaitStates = 0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// FirmwareVariantReport
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct FirmwareVariantReport
+{
+	FirmwareDecoder decoder = FirmwareDecoder::Lookup;
+	bool available = false;
+
+	uint32_t tableBytes = 0;
+	uint32_t loads = 0;
+	uint32_t aluOps = 0;
+	uint32_t estimatedCycles = 0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// FirmwareTables
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct FirmwareTables
+{
+	bool valid = false;
+	FirmwareDecoder chosen = FirmwareDecoder::Lookup;
+
+	// One entry per decoder, indexed by FirmwareDecoder (Auto is left empty).
+	std::vector<FirmwareVariantReport> variants;
+
+	// Complete C/C++ header for the chosen decoder.
+	std::string header;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// FirmwareTableGenerator
+//	Emits a header that decodes sensor readings back to positions on a
+//	microcontroller, and reports the ROM and cycle cost of each decoder so the
+//	trade off can be made per part.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class FirmwareTableGenerator
+{
+public:
+	// codes[i] is the reading over position i, bitCount the number of sensor bits.
+	static FirmwareTables Generate( const std::vector<unsigned int>& codes, int bitCount, const FirmwareOptions& options );
+
+	static const char* GetDecoderName( FirmwareDecoder decoder );
+};
@@ -0,0 +1,276 @@
+/*------------------------------------------------------------------------------
+	()      File:   image_diff.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				SSE2/AVX2 per pixel diff with changed pixel bounds.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "application/core/image_diff.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	// Changed pixels and their extent found by one worker.
+	//------------------------------------------------------------------------------
+	struct DiffTally
+	{
+		uint64_t changed = 0;
+		uint32_t maxDelta = 0;
+		int x0 = INT32_MAX;
+		int y0 = INT32_MAX;
+		int x1 = INT32_MIN;
+		int y1 = INT32_MIN;
+
+		void AddRow( int y, int first, int last, uint64_t count )
+		{
+			changed += count;
+			x0 = std::min( x0, first );
+			x1 = std::max( x1, last + 1 );
+			y0 = std::min( y0, y );
+			y1 = std::max( y1, y + 1 );
+		}
+	};
+
+	//------------------------------------------------------------------------------
+	// Row state shared by the scalar tail and the vector loops.
+	//------------------------------------------------------------------------------
+	struct RowScan
+	{
+		uint64_t count = 0;
+		int first = -1;
+		int last = -1;
+
+		void AddMask( int x, uint32_t mask )
+		{
+			if ( mask == 0 )
+			{
+				return;
+			}
+
+			count += std::popcount( mask );
+			if ( first < 0 )
+			{
+				first = x + std::countr_zero( mask );
+			}
+			last = x + 31 - std::countl_zero( mask );
+		}
+	};
+
+	//------------------------------------------------------------------------------
+	// Pixels [begin, end) of one row, returns the largest channel delta.
+	//------------------------------------------------------------------------------
+	uint32_t CompareRowScalar( const uint32_t* a, const uint32_t* b, int begin, int end, uint32_t tolerance, RowScan& scan )
+	{
+		uint32_t maxDelta = 0;
+		for ( int x = begin; x < end; ++x )
+		{
+			uint32_t delta = 0;
+			for ( int shift = 0; shift < 32; shift += 8 )
+			{
+				const int ca = (a[x] >> shift) & 0xFF;
+				const int cb = (b[x] >> shift) & 0xFF;
+				delta = std::max<uint32_t>( delta, static_cast<uint32_t>( std::abs( ca - cb ) ) );
+			}
+
+			maxDelta = std::max( maxDelta, delta );
+			scan.AddMask( x, delta > tolerance ? 1u : 0u );
+		}
+
+		return maxDelta;
+	}
+
+#if defined(_M_X64) || defined(__x86_64__)
+	//------------------------------------------------------------------------------
+	// |a - b| per byte is the or of both saturating differences, and subtracting
+	// the tolerance with saturation leaves a non zero lane only where it is exceeded.
+	//------------------------------------------------------------------------------
+	uint32_t CompareRowSse2( const uint32_t* a, const uint32_t* b, int width, uint32_t tolerance, RowScan& scan )
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i tol = _mm_set1_epi8( static_cast<char>( tolerance ) );
+		__m128i peak = zero;
+
+		int x = 0;
+		for ( ; x + 4 <= width; x += 4 )
+		{
+			const __m128i va = _mm_loadu_si128( reinterpret_cast<const __m128i*>( a + x ) );
+			const __m128i vb = _mm_loadu_si128( reinterpret_cast<const __m128i*>( b + x ) );
+
+			const __m128i delta = _mm_or_si128( _mm_subs_epu8( va, vb ), _mm_subs_epu8( vb, va ) );
+			peak = _mm_max_epu8( peak, delta );
+
+			const __m128i same = _mm_cmpeq_epi32( _mm_subs_epu8( delta, tol ), zero );
+			scan.AddMask( x, ~static_cast<uint32_t>( _mm_movemask_ps( _mm_castsi128_ps( same ) ) ) & 0xFu );
+		}
+
+		alignas( 16 ) uint8_t lanes[16];
+		_mm_store_si128( reinterpret_cast<__m128i*>( lanes ), peak );
+
+		uint32_t maxDelta = *std::max_element( lanes, lanes + 16 );
+		return std::max( maxDelta, CompareRowScalar( a, b, x, width, tolerance, scan ) );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	uint32_t CompareRowAvx2( const uint32_t* a, const uint32_t* b, int width, uint32_t tolerance, RowScan& scan )
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i tol = _mm256_set1_epi8( static_cast<char>( tolerance ) );
+		__m256i peak = zero;
+
+		int x = 0;
+		for ( ; x + 8 <= width; x += 8 )
+		{
+			const __m256i va = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + x ) );
+			const __m256i vb = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + x ) );
+
+			const __m256i delta = _mm256_or_si256( _mm256_subs_epu8( va, vb ), _mm256_subs_epu8( vb, va ) );
+			peak = _mm256_max_epu8( peak, delta );
+
+			const __m256i same = _mm256_cmpeq_epi32( _mm256_subs_epu8( delta, tol ), zero );
+			scan.AddMask( x, ~static_cast<uint32_t>( _mm256_movemask_ps( _mm256_castsi256_ps( same ) ) ) & 0xFFu );
+		}
+
+		alignas( 32 ) uint8_t lanes[32];
+		_mm256_store_si256( reinterpret_cast<__m256i*>( lanes ), peak );
+
+		uint32_t maxDelta = *std::max_element( lanes, lanes + 32 );
+		return std::max( maxDelta, CompareRowScalar( a, b, x, width, tolerance, scan ) );
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ImageDiff
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ImageDiffResult ImageDiff::Compare( const BLImage& a, const BLImage& b, uint8_t tolerance, uint32_t threads /*= 0*/ )
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	ImageDiffResult result;
+
+	if ( a.empty() || a.size() != b.size() )
+	{
+		return result;
+	}
+
+	//decoded goldens come back as XRGB32 when they are opaque.
+	BLImage convertedA = a;
+	BLImage convertedB = b;
+	if ( convertedA.format() != BL_FORMAT_PRGB32 )
+	{
+		convertedA.convert( BL_FORMAT_PRGB32 );
+	}
+	if ( convertedB.format() != BL_FORMAT_PRGB32 )
+	{
+		convertedB.convert( BL_FORMAT_PRGB32 );
+	}
+
+	BLImageData dataA;
+	BLImageData dataB;
+	if ( convertedA.getData( &dataA ) != BL_SUCCESS || convertedB.getData( &dataB ) != BL_SUCCESS )
+	{
+		return result;
+	}
+
+	const int width = dataA.size.w;
+	const int height = dataA.size.h;
+
+	result.comparable = true;
+	result.pixelCount = uint64_t( width ) * uint64_t( height );
+
+#if defined(_M_X64) || defined(__x86_64__)
+	result.usedAvx2 = parallel::HasAvx2();
+#endif
+
+	const uint32_t workerCount = std::max( 1u, threads == 0 ? parallel::HardwareThreadCount() : threads );
+	std::vector<DiffTally> tallies( workerCount );
+
+	result.threadsUsed = parallel::ForRange( height, workerCount, [&]( uint64_t begin, uint64_t end, uint32_t worker )
+	{
+		DiffTally& tally = tallies[worker];
+
+		for ( uint64_t y = begin; y < end; ++y )
+		{
+			const uint32_t* rowA = reinterpret_cast<const uint32_t*>( static_cast<const uint8_t*>( dataA.pixelData ) + intptr_t( y ) * dataA.stride );
+			const uint32_t* rowB = reinterpret_cast<const uint32_t*>( static_cast<const uint8_t*>( dataB.pixelData ) + intptr_t( y ) * dataB.stride );
+
+			RowScan scan;
+		#if defined(_M_X64) || defined(__x86_64__)
+			const uint32_t delta = result.usedAvx2
+				? CompareRowAvx2( rowA, rowB, width, tolerance, scan )
+				: CompareRowSse2( rowA, rowB, width, tolerance, scan );
+		#else
+			const uint32_t delta = CompareRowScalar( rowA, rowB, 0, width, tolerance, scan );
+		#endif
+
+			tally.maxDelta = std::max( tally.maxDelta, delta );
+			if ( scan.count != 0 )
+			{
+				tally.AddRow( static_cast<int>( y ), scan.first, scan.last, scan.count );
+			}
+		}
+	} );
+
+	DiffTally total;
+	for ( const DiffTally& tally : tallies )
+	{
+		total.changed += tally.changed;
+		total.maxDelta = std::max( total.maxDelta, tally.maxDelta );
+		total.x0 = std::min( total.x0, tally.x0 );
+		total.y0 = std::min( total.y0, tally.y0 );
+		total.x1 = std::max( total.x1, tally.x1 );
+		total.y1 = std::max( total.y1, tally.y1 );
+	}
+
+	result.changedPixels = total.changed;
+	result.maxDelta = total.maxDelta;
+	if ( total.changed != 0 )
+	{
+		result.bounds = BLBoxI( total.x0, total.y0, total.x1, total.y1 );
+	}
+
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	return result;
+}
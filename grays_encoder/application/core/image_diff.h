@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------
+	()      File:   image_diff.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Tolerant per pixel image comparison.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <blend2d.h>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ImageDiffResult
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct ImageDiffResult
+{
+	// False if the images differ in size, nothing else is filled in.
+	bool comparable = false;
+
+	uint64_t pixelCount = 0;
+	uint64_t changedPixels = 0;
+	// Largest per channel difference seen, including ones within tolerance.
+	uint32_t maxDelta = 0;
+	// Pixels outside tolerance, empty (x0 == x1) when nothing changed.
+	BLBoxI bounds = BLBoxI( 0, 0, 0, 0 );
+
+	uint32_t threadsUsed = 0;
+	bool usedAvx2 = false;
+	double elapsedMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ImageDiff
+//	Per pixel comparison of two 32-bit images. A pixel counts as changed when
+//	any channel differs by more than the tolerance, which absorbs the small
+//	anti-aliasing drift between rasterizer versions. Rows are split across
+//	threads and compared eight pixels at a time with AVX2 (four with SSE2).
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class ImageDiff
+{
+public:
+	// Both images are converted to PRGB32 if they are not already.
+	static ImageDiffResult Compare( const BLImage& a, const BLImage& b, uint8_t tolerance, uint32_t threads = 0 );
+};
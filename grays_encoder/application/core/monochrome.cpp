@@ -0,0 +1,210 @@
+/*------------------------------------------------------------------------------
+	()      File:   monochrome.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				SSE2 thresholding and ordered dithering of A8 coverage.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <array>
+#if defined(_M_X64) || defined(__x86_64__)
+#include <emmintrin.h>
+#endif
+#include "application/core/monochrome.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	// 8x8 Bayer matrix scaled to grey thresholds, (2b + 1) * 255 / 128, so flat
+	// 0 and 255 stay solid.
+	//------------------------------------------------------------------------------
+	constexpr std::array<std::array<uint8_t, 8>, 8> MakeDitherThresholds()
+	{
+		constexpr uint8_t bayer[8][8] = {
+			{  0, 32,  8, 40,  2, 34, 10, 42 },
+			{ 48, 16, 56, 24, 50, 18, 58, 26 },
+			{ 12, 44,  4, 36, 14, 46,  6, 38 },
+			{ 60, 28, 52, 20, 62, 30, 54, 22 },
+			{  3, 35, 11, 43,  1, 33,  9, 41 },
+			{ 51, 19, 59, 27, 49, 17, 57, 25 },
+			{ 15, 47,  7, 39, 13, 45,  5, 37 },
+			{ 63, 31, 55, 23, 61, 29, 53, 21 },
+		};
+
+		std::array<std::array<uint8_t, 8>, 8> thresholds{};
+		for ( size_t y = 0; y < 8; ++y )
+		{
+			for ( size_t x = 0; x < 8; ++x )
+			{
+				thresholds[y][x] = static_cast<uint8_t>( ((2 * bayer[y][x] + 1) * 255) / 128 );
+			}
+		}
+
+		return thresholds;
+	}
+
+	constexpr std::array<std::array<uint8_t, 8>, 8> DitherThresholds = MakeDitherThresholds();
+
+	//------------------------------------------------------------------------------
+	// Scalar packing against a repeating row of 8 thresholds.
+	//------------------------------------------------------------------------------
+	void PackScalar( const uint8_t* coverage, uint32_t begin, uint32_t pixels, uint8_t* packed, const uint8_t* thresholds )
+	{
+		for ( uint32_t x = begin; x < pixels; x += 8 )
+		{
+			uint8_t bits = 0;
+			for ( uint32_t bit = 0; bit < 8 && x + bit < pixels; ++bit )
+			{
+				const uint8_t grey = static_cast<uint8_t>( 255 - coverage[x + bit] );
+				bits |= static_cast<uint8_t>( grey >= thresholds[bit] ) << (7 - bit);
+			}
+
+			packed[x / 8] = bits;
+		}
+	}
+
+#if defined(_M_X64) || defined(__x86_64__)
+	//------------------------------------------------------------------------------
+	// movemask puts pixel 0 in bit 0, packed rows want it in bit 7.
+	//------------------------------------------------------------------------------
+	constexpr std::array<uint8_t, 256> MakeReversedBytes()
+	{
+		std::array<uint8_t, 256> reversed{};
+		for ( uint32_t value = 0; value < 256; ++value )
+		{
+			uint32_t bits = 0;
+			for ( uint32_t bit = 0; bit < 8; ++bit )
+			{
+				bits |= ((value >> bit) & 1u) << (7 - bit);
+			}
+
+			reversed[value] = static_cast<uint8_t>( bits );
+		}
+
+		return reversed;
+	}
+
+	constexpr std::array<uint8_t, 256> ReversedBytes = MakeReversedBytes();
+
+	//------------------------------------------------------------------------------
+	// SSE2 packing, 16 pixels to 2 bytes. grey >= t is max( grey, t ) == grey
+	// since SSE2 has no unsigned byte compare.
+	//------------------------------------------------------------------------------
+	uint32_t PackSse2( const uint8_t* coverage, uint32_t pixels, uint8_t* packed, const uint8_t* thresholds )
+	{
+		const __m128i row = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( thresholds ) );
+		const __m128i limit = _mm_unpacklo_epi64( row, row );
+		const __m128i ones = _mm_set1_epi8( -1 );
+
+		uint32_t x = 0;
+		for ( ; x + 16 <= pixels; x += 16 )
+		{
+			const __m128i grey = _mm_xor_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( coverage + x ) ), ones );
+			const __m128i paper = _mm_cmpeq_epi8( _mm_max_epu8( grey, limit ), grey );
+			const uint32_t mask = static_cast<uint32_t>( _mm_movemask_epi8( paper ) );
+
+			packed[x / 8] = ReversedBytes[mask & 0xFF];
+			packed[x / 8 + 1] = ReversedBytes[mask >> 8];
+		}
+
+		return x;
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Monochrome
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BLRgba32 Monochrome::GetPaperColour( BLContext& ctx )
+{
+	const BLImage* target = ctx.targetImage();
+	return target && target->format() == BL_FORMAT_A8 ? BLRgba32( 0x00000000 ) : BLRgba32( 0xFFFFFFFF );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Monochrome::CoverageToGrey( const uint8_t* coverage, uint32_t pixels, uint8_t* grey )
+{
+	uint32_t x = 0;
+
+#if defined(_M_X64) || defined(__x86_64__)
+	const __m128i ones = _mm_set1_epi8( -1 );
+	for ( ; x + 16 <= pixels; x += 16 )
+	{
+		const __m128i value = _mm_loadu_si128( reinterpret_cast<const __m128i*>( coverage + x ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( grey + x ), _mm_xor_si128( value, ones ) );
+	}
+#endif
+
+	for ( ; x < pixels; ++x )
+	{
+		grey[x] = static_cast<uint8_t>( 255 - coverage[x] );
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Monochrome::PackCoverage( const uint8_t* coverage, uint32_t pixels, uint8_t* packed, uint32_t y, MonoPacking packing, uint8_t threshold /*= 128*/ )
+{
+	std::array<uint8_t, 8> flat;
+	flat.fill( threshold );
+
+	const uint8_t* thresholds = packing == MonoPacking::OrderedDither ? DitherThresholds[y & 7].data() : flat.data();
+
+#if defined(_M_X64) || defined(__x86_64__)
+	const uint32_t done = PackSse2( coverage, pixels, packed, thresholds );
+#else
+	const uint32_t done = 0;
+#endif
+
+	PackScalar( coverage, done, pixels, packed, thresholds );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+size_t Monochrome::GetPackedBytes( uint32_t pixels )
+{
+	return (size_t( pixels ) + 7) / 8;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const char* Monochrome::GetPackingName( MonoPacking packing )
+{
+	switch ( packing )
+	{
+	case MonoPacking::Threshold: return "threshold";
+	case MonoPacking::OrderedDither: return "ordered dither";
+	default: return "unknown";
+	}
+}
@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------
+	()      File:   monochrome.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Coverage to grey and packed 1-bpp conversion for A8 renders.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <blend2d.h>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class MonoPacking : uint32_t
+{
+	Threshold,
+	OrderedDither,
+
+	Count
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Monochrome
+//	Artwork is rendered as ink coverage into BL_FORMAT_A8 targets, with paper
+//	left at 0. These reduce coverage rows to 8-bit grey or to packed 1-bpp,
+//	msb first with 1 as paper, which is what PNG, TIFF and QImage::Format_Mono
+//	all expect. The x64 paths compare 16 pixels at a time and pack them with
+//	movemask.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class Monochrome
+{
+public:
+	// Paper colour for the target, coverage targets need it transparent so only ink registers.
+	static BLRgba32 GetPaperColour( BLContext& ctx );
+
+	// Grey is 255 - coverage.
+	static void CoverageToGrey( const uint8_t* coverage, uint32_t pixels, uint8_t* grey );
+
+	// Packs a row of coverage, y picks the dither row. Threshold is the grey level
+	// at or above which a pixel is paper and is ignored when dithering.
+	static void PackCoverage( const uint8_t* coverage, uint32_t pixels, uint8_t* packed, uint32_t y, MonoPacking packing, uint8_t threshold = 128 );
+
+	static size_t GetPackedBytes( uint32_t pixels );
+	static const char* GetPackingName( MonoPacking packing );
+};
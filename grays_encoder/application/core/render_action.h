@@ -35,6 +35,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // Forwards
 //------------------------------------------------------------------------------
 class BLContext;
+class FrameProfiler;
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -50,6 +51,9 @@ namespace actions
 
 		std::unordered_map<const char*, bool> options;
 		std::unordered_map<const char*, double> parameters;
+
+		// Set by the caller for the duration of one Render, stages and counters inside report to it.
+		FrameProfiler* profiler = nullptr;
 	};
 
 	template<class Base, void (Base::*renderFn)(BLContext&) >
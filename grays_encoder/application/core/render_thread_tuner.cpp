@@ -0,0 +1,303 @@
+/*------------------------------------------------------------------------------
+	()      File:   render_thread_tuner.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Picks and calibrates blend2d render thread counts.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <blend2d.h>
+#include "application/core/render_thread_tuner.h"
+#include "application/core/render_action.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	using clock = std::chrono::steady_clock;
+
+	// Square frame edges tried during calibration, a small widget up to a maximised window.
+	constexpr uint32_t CalibrationSizes[] = { 128, 256, 512, 1024, 1536 };
+	constexpr uint32_t CalibrationRuns = 3;
+
+	// Width of the default disc in pixels at scale 1, the calibration frames are filled by it.
+	constexpr double DiscPixels = 402.0;
+
+	// A thread count has to beat the best so far by 10% to be picked, so timing noise
+	// doesn't add workers that don't help.
+	constexpr double WinMargin = 0.9;
+
+	//------------------------------------------------------------------------------
+	// Best of CalibrationRuns, drawn the way Blend2DRenderWidget draws a frame.
+	//------------------------------------------------------------------------------
+	double TimeRender( actions::RenderAction& renderer, BLImage& target, uint32_t threads )
+	{
+		double bestMs = std::numeric_limits<double>::max();
+
+		for ( uint32_t run = 0; run < CalibrationRuns; ++run )
+		{
+			const clock::time_point start = clock::now();
+
+			BLContextCreateInfo createInfo{};
+			createInfo.threadCount = threads;
+
+			BLContext ctx( target, createInfo );
+			ctx.setFillStyle( BLRgba32( 0xFFFFFFFF ) );
+			ctx.fillAll();
+
+			ctx.translate( target.width() * 0.5, target.height() * 0.5 );
+			ctx.scale( target.width() / DiscPixels );
+
+			renderer.Render( ctx );
+			ctx.end();
+
+			bestMs = std::min( bestMs, std::chrono::duration<double, std::milli>( clock::now() - start ).count() );
+		}
+
+		return bestMs;
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// RenderThreadTuner
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+RenderThreadTuner::RenderThreadTuner()
+{
+	m_tuning.hardwareThreads = parallel::HardwareThreadCount();
+	m_tuning.maxThreads = m_tuning.hardwareThreads;
+	m_tuning.syncPixels = 256 * 256;
+	m_tuning.minCommands = 32;
+	m_tuning.pixelsPerThread = 64 * 1024;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const ThreadTuning& RenderThreadTuner::Calibrate( actions::RenderAction& renderer, double budgetMs /*= 1500.0*/ )
+{
+	const clock::time_point start = clock::now();
+
+	ThreadTuning tuning;
+	tuning.hardwareThreads = parallel::HardwareThreadCount();
+	tuning.minCommands = m_tuning.minCommands;
+
+	std::vector<uint32_t> candidates;
+	for ( uint32_t threads = 2; threads < tuning.hardwareThreads; threads *= 2 )
+	{
+		candidates.push_back( threads );
+	}
+
+	if ( tuning.hardwareThreads >= 2 )
+	{
+		candidates.push_back( tuning.hardwareThreads );
+	}
+
+	// The first render may generate the pattern, keep that out of the timings.
+	{
+		BLImage warmup( 64, 64, BL_FORMAT_PRGB32 );
+		TimeRender( renderer, warmup, 0 );
+	}
+
+	const auto overBudget = [&]()
+	{
+		return std::chrono::duration<double, std::milli>( clock::now() - start ).count() > budgetMs;
+	};
+
+	bool threadedWon = false;
+	uint64_t largestPixels = 0;
+
+	for ( const uint32_t size : CalibrationSizes )
+	{
+		if ( largestPixels != 0 && overBudget() )
+		{
+			break;
+		}
+
+		BLImage target( size, size, BL_FORMAT_PRGB32 );
+		const uint64_t pixels = uint64_t( size ) * size;
+		largestPixels = pixels;
+
+		uint32_t bestThreads = 0;
+		double bestMs = TimeRender( renderer, target, 0 );
+
+		for ( const uint32_t threads : candidates )
+		{
+			// A large frame on a slow machine can spend the budget by itself, keep the counts timed so far.
+			if ( overBudget() )
+			{
+				break;
+			}
+
+			const double ms = TimeRender( renderer, target, threads );
+			if ( ms < bestMs * WinMargin )
+			{
+				bestMs = ms;
+				bestThreads = threads;
+			}
+		}
+
+		if ( bestThreads == 0 )
+		{
+			// Synchronous still wins, a later loss after threading has won is noise.
+			if ( !threadedWon )
+			{
+				tuning.syncPixels = pixels + 1;
+			}
+
+			continue;
+		}
+
+		threadedWon = true;
+		tuning.maxThreads = bestThreads;
+		tuning.pixelsPerThread = std::max( tuning.pixelsPerThread, pixels / bestThreads );
+	}
+
+	if ( !threadedWon )
+	{
+		// Never paid off at the sizes tried, only frames larger than those get workers.
+		tuning.maxThreads = tuning.hardwareThreads;
+		tuning.pixelsPerThread = std::max<uint64_t>( largestPixels / 2, 1 );
+	}
+
+	tuning.calibrated = true;
+	tuning.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+
+	m_tuning = tuning;
+	return m_tuning;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool RenderThreadTuner::Load( const std::filesystem::path& path )
+{
+	std::ifstream file( path );
+	if ( !file )
+	{
+		return false;
+	}
+
+	ThreadTuning tuning;
+	tuning.minCommands = m_tuning.minCommands;
+
+	std::string key;
+	uint64_t value = 0;
+	while ( file >> key >> value )
+	{
+		if ( key == "hardwareThreads" )
+		{
+			tuning.hardwareThreads = static_cast<uint32_t>( value );
+		}
+		else if ( key == "maxThreads" )
+		{
+			tuning.maxThreads = static_cast<uint32_t>( value );
+		}
+		else if ( key == "syncPixels" )
+		{
+			tuning.syncPixels = value;
+		}
+		else if ( key == "minCommands" )
+		{
+			tuning.minCommands = value;
+		}
+		else if ( key == "pixelsPerThread" )
+		{
+			tuning.pixelsPerThread = value;
+		}
+	}
+
+	// Tuning from another machine, or a different core count, is no use.
+	if ( tuning.hardwareThreads != parallel::HardwareThreadCount() || tuning.maxThreads == 0 || tuning.maxThreads > tuning.hardwareThreads || tuning.pixelsPerThread == 0 )
+	{
+		return false;
+	}
+
+	tuning.calibrated = true;
+	m_tuning = tuning;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool RenderThreadTuner::Save( const std::filesystem::path& path ) const
+{
+	std::ofstream file( path );
+	if ( !file )
+	{
+		return false;
+	}
+
+	file << "hardwareThreads " << m_tuning.hardwareThreads << '\n'
+		<< "maxThreads " << m_tuning.maxThreads << '\n'
+		<< "syncPixels " << m_tuning.syncPixels << '\n'
+		<< "minCommands " << m_tuning.minCommands << '\n'
+		<< "pixelsPerThread " << m_tuning.pixelsPerThread << '\n';
+
+	return static_cast<bool>( file );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const ThreadTuning& RenderThreadTuner::LoadOrCalibrate( const std::filesystem::path& path, actions::RenderAction& renderer )
+{
+	if ( !Load( path ) )
+	{
+		Calibrate( renderer );
+		Save( path );
+	}
+
+	return m_tuning;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+uint32_t RenderThreadTuner::GetThreadCount( uint64_t pixels, uint64_t commands /*= 0*/ ) const
+{
+	if ( m_tuning.maxThreads < 2 || pixels < m_tuning.syncPixels || (commands != 0 && commands < m_tuning.minCommands) )
+	{
+		return 0;
+	}
+
+	const uint64_t threads = pixels / std::max<uint64_t>( m_tuning.pixelsPerThread, 1 );
+	return static_cast<uint32_t>( std::clamp<uint64_t>( threads, 2, m_tuning.maxThreads ) );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+uint32_t RenderThreadTuner::GetPrintThreadCount() const
+{
+	return m_tuning.hardwareThreads > 1 ? m_tuning.hardwareThreads : 0;
+}
@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+	()      File:   render_thread_tuner.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Picks and calibrates blend2d render thread counts.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <filesystem>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Forwards
+//------------------------------------------------------------------------------
+namespace actions
+{
+	class RenderAction;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ThreadTuning
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct ThreadTuning
+{
+	uint32_t hardwareThreads = 0;
+
+	// Fastest thread count for the largest calibrated frame, at most hardwareThreads.
+	uint32_t maxThreads = 0;
+
+	// Frames smaller than this, or with fewer fill and stroke calls than
+	// minCommands, render synchronously. Below that the worker hand off costs more than it saves.
+	uint64_t syncPixels = 0;
+	uint64_t minCommands = 0;
+
+	// Every worker needs about this many pixels of frame to pay for itself.
+	uint64_t pixelsPerThread = 0;
+
+	bool calibrated = false;
+	double elapsedMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// RenderThreadTuner
+//	Picks a blend2d thread count per frame from its size and command count.
+//	Starts from the CPU count; Calibrate times a renderer at a few frame sizes
+//	against synchronous and 2..N thread contexts to find where threading
+//	starts to pay and where it stops scaling. Results are saved as plain
+//	"key value" lines and reused while the thread count of the machine matches.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class RenderThreadTuner
+{
+public:
+	RenderThreadTuner();
+
+	// Stops timing further thread counts and frame sizes once budgetMs has been spent.
+	const ThreadTuning& Calibrate( actions::RenderAction& renderer, double budgetMs = 1500.0 );
+
+	bool Load( const std::filesystem::path& path );
+	bool Save( const std::filesystem::path& path ) const;
+
+	// Loads the saved tuning, or calibrates and saves it when there is none for this machine.
+	const ThreadTuning& LoadOrCalibrate( const std::filesystem::path& path, actions::RenderAction& renderer );
+
+	// 0 means synchronous. Pass commands = 0 when the count isn't known yet.
+	uint32_t GetThreadCount( uint64_t pixels, uint64_t commands = 0 ) const;
+	// Print pages are large enough that every core pays off.
+	uint32_t GetPrintThreadCount() const;
+
+	inline const ThreadTuning& GetTuning() const;
+
+private:
+	ThreadTuning m_tuning;
+};
+
+//------------------------------------------------------------------------------
+// Inline for RenderThreadTuner
+//------------------------------------------------------------------------------
+
+inline const ThreadTuning& RenderThreadTuner::GetTuning() const
+{
+	return m_tuning;
+}
@@ -0,0 +1,355 @@
+/*------------------------------------------------------------------------------
+	()      File:   sensor_simulator.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Virtual photo sensor sweep over a rendered encoder disc.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "application/core/sensor_simulator.h"
+#include "utility/globals.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	// Lookup table is 1 << heads entries.
+	constexpr size_t MaxHeads = 24;
+
+	// Sensor spot is approximated by its centre plus a ring of taps.
+	constexpr uint32_t ApertureRingTaps = 6;
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	struct Tap
+	{
+		float dx = 0.0f;
+		float dy = 0.0f;
+	};
+
+	//------------------------------------------------------------------------------
+	// Everything the inner loop needs, in pixels.
+	//------------------------------------------------------------------------------
+	struct Sampler
+	{
+		const uint32_t* pixels = nullptr;
+		int32_t stride = 0;
+		float maxX = 0.0f;
+		float maxY = 0.0f;
+
+		float axisX = 0.0f;
+		float axisY = 0.0f;
+
+		// Head positions relative to the axis at rotation 0.
+		std::vector<float> headX;
+		std::vector<float> headY;
+		std::vector<Tap> taps;
+
+		// threshold * taps.size(), compared against the summed green levels.
+		uint32_t thresholdSum = 0;
+	};
+
+	//------------------------------------------------------------------------------
+	// Reads every head with the disc rotated by the angle given as cos/sin.
+	//------------------------------------------------------------------------------
+	unsigned int ReadScalar( const Sampler& s, float cosR, float sinR )
+	{
+		unsigned int reading = 0;
+
+		for ( size_t head = 0; head < s.headX.size(); ++head )
+		{
+			const float px = s.axisX + cosR * s.headX[head] - sinR * s.headY[head];
+			const float py = s.axisY + sinR * s.headX[head] + cosR * s.headY[head];
+
+			uint32_t sum = 0;
+			for ( const Tap& tap : s.taps )
+			{
+				const int32_t x = static_cast<int32_t>( std::clamp( px + tap.dx, 0.0f, s.maxX ) );
+				const int32_t y = static_cast<int32_t>( std::clamp( py + tap.dy, 0.0f, s.maxY ) );
+
+				sum += (s.pixels[y * s.stride + x] >> 8) & 0xFF;
+			}
+
+			reading |= static_cast<unsigned int>( sum < s.thresholdSum ) << head;
+		}
+
+		return reading;
+	}
+
+#if defined(_M_X64) || defined(__x86_64__)
+	//------------------------------------------------------------------------------
+	// Eight rotations at once, pixels fetched with a gather per head and tap.
+	//------------------------------------------------------------------------------
+	__m256i ReadAvx2( const Sampler& s, __m256 cosR, __m256 sinR )
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 maxX = _mm256_set1_ps( s.maxX );
+		const __m256 maxY = _mm256_set1_ps( s.maxY );
+		const __m256i stride = _mm256_set1_epi32( s.stride );
+		const __m256i greenMask = _mm256_set1_epi32( 0xFF );
+		const __m256i thresholdSum = _mm256_set1_epi32( static_cast<int>( s.thresholdSum ) );
+		const int* pixels = reinterpret_cast<const int*>( s.pixels );
+
+		__m256i reading = _mm256_setzero_si256();
+
+		for ( size_t head = 0; head < s.headX.size(); ++head )
+		{
+			const __m256 hx = _mm256_set1_ps( s.headX[head] );
+			const __m256 hy = _mm256_set1_ps( s.headY[head] );
+
+			const __m256 px = _mm256_add_ps( _mm256_set1_ps( s.axisX ), _mm256_sub_ps( _mm256_mul_ps( cosR, hx ), _mm256_mul_ps( sinR, hy ) ) );
+			const __m256 py = _mm256_add_ps( _mm256_set1_ps( s.axisY ), _mm256_add_ps( _mm256_mul_ps( sinR, hx ), _mm256_mul_ps( cosR, hy ) ) );
+
+			__m256i sum = _mm256_setzero_si256();
+			for ( const Tap& tap : s.taps )
+			{
+				const __m256 x = _mm256_min_ps( _mm256_max_ps( _mm256_add_ps( px, _mm256_set1_ps( tap.dx ) ), zero ), maxX );
+				const __m256 y = _mm256_min_ps( _mm256_max_ps( _mm256_add_ps( py, _mm256_set1_ps( tap.dy ) ), zero ), maxY );
+
+				const __m256i index = _mm256_add_epi32( _mm256_mullo_epi32( _mm256_cvttps_epi32( y ), stride ), _mm256_cvttps_epi32( x ) );
+				const __m256i pixel = _mm256_i32gather_epi32( pixels, index, 4 );
+
+				sum = _mm256_add_epi32( sum, _mm256_and_si256( _mm256_srli_epi32( pixel, 8 ), greenMask ) );
+			}
+
+			const __m256i dark = _mm256_cmpgt_epi32( thresholdSum, sum );
+			reading = _mm256_or_si256( reading, _mm256_and_si256( dark, _mm256_set1_epi32( 1 << head ) ) );
+		}
+
+		return reading;
+	}
+#endif
+
+	//------------------------------------------------------------------------------
+	// Per worker tallies, merged once the sweep is done.
+	//------------------------------------------------------------------------------
+	struct SweepTally
+	{
+		uint64_t exact = 0;
+		uint64_t boundary = 0;
+		uint64_t failures = 0;
+		uint64_t invalidReadings = 0;
+		uint64_t firstFailure = SensorSimulationResult::NoIndex;
+		double maxErrorDeg = 0.0;
+	};
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// SensorSimulator
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+SensorSimulationResult SensorSimulator::Run( const BLImage& image,
+	const SensorRaster& raster,
+	const SensorModel& model,
+	const std::vector<unsigned int>& codes,
+	uint32_t samplesPerSector /*= 1*/,
+	uint32_t threads /*= 0*/
+)
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	SensorSimulationResult result;
+
+	BLImageData data{};
+	if ( codes.size() < 2 || model.heads.empty() || model.heads.size() > MaxHeads || samplesPerSector == 0
+		|| (image.format() != BL_FORMAT_PRGB32 && image.format() != BL_FORMAT_XRGB32)
+		|| image.getData( &data ) != BL_SUCCESS || data.size.w < 1 || data.size.h < 1 )
+	{
+		return result;
+	}
+
+	//------------------------------------------------------
+	// Reading -> sector table.
+	//------------------------------------------------------
+	const uint32_t period = static_cast<uint32_t>( codes.size() );
+	const std::vector<uint32_t> positions = BuildDecodeTable( codes, model.heads.size() );
+
+	//------------------------------------------------------
+	// Sensor geometry in pixels.
+	//------------------------------------------------------
+	Sampler sampler;
+	sampler.pixels = static_cast<const uint32_t*>( data.pixelData );
+	sampler.stride = static_cast<int32_t>( data.stride / 4 );
+	sampler.maxX = std::nextafter( static_cast<float>( data.size.w - 1 ), 0.0f );
+	sampler.maxY = std::nextafter( static_cast<float>( data.size.h - 1 ), 0.0f );
+	sampler.axisX = static_cast<float>( raster.centreX + model.eccentricityX * raster.pixelsPerUnit );
+	sampler.axisY = static_cast<float>( raster.centreY + model.eccentricityY * raster.pixelsPerUnit );
+
+	for ( const SensorHead& head : model.heads )
+	{
+		const double radius = (head.radius + model.radialMisalignment) * raster.pixelsPerUnit;
+		const double angleRad = DegToRad( (head.angleDeg + model.angularMisalignmentDeg) );
+
+		sampler.headX.push_back( static_cast<float>( radius * cos( angleRad ) ) );
+		sampler.headY.push_back( static_cast<float>( radius * sin( angleRad ) ) );
+	}
+
+	sampler.taps.push_back( {} );
+
+	const double aperture = model.aperture * raster.pixelsPerUnit;
+	if ( aperture >= 0.5 )
+	{
+		for ( uint32_t tap = 0; tap < ApertureRingTaps; ++tap )
+		{
+			const double tapRad = DegToRad( tap * 360.0 / ApertureRingTaps );
+			sampler.taps.push_back( { static_cast<float>( aperture * cos( tapRad ) ), static_cast<float>( aperture * sin( tapRad ) ) } );
+		}
+	}
+
+	sampler.thresholdSum = uint32_t( model.threshold ) * static_cast<uint32_t>( sampler.taps.size() );
+
+	//------------------------------------------------------
+	// Sweep.
+	//------------------------------------------------------
+#if defined(_M_X64) || defined(__x86_64__)
+	result.usedAvx2 = parallel::HasAvx2();
+#endif
+
+	const uint64_t sampleCount = uint64_t( period ) * samplesPerSector;
+	const double sampleStepDeg = 360.0 / sampleCount;
+	const double sectorDeg = 360.0 / period;
+
+	const uint32_t workerCount = std::max( 1u, threads == 0 ? parallel::HardwareThreadCount() : threads );
+	std::vector<SweepTally> tallies( workerCount );
+
+	result.threadsUsed = parallel::ForRange( sampleCount, workerCount, [&]( uint64_t begin, uint64_t end, uint32_t worker )
+	{
+		SweepTally& tally = tallies[worker];
+
+		alignas( 32 ) float cosR[8];
+		alignas( 32 ) float sinR[8];
+		alignas( 32 ) uint32_t readings[8];
+
+		for ( uint64_t block = begin; block < end; block += 8 )
+		{
+			const uint32_t lanes = static_cast<uint32_t>( std::min<uint64_t>( 8, end - block ) );
+
+			for ( uint32_t lane = 0; lane < 8; ++lane )
+			{
+				const double angleRad = DegToRad( (block + std::min( lane, lanes - 1 ) + 0.5) * sampleStepDeg );
+				cosR[lane] = static_cast<float>( cos( angleRad ) );
+				sinR[lane] = static_cast<float>( sin( angleRad ) );
+			}
+
+		#if defined(_M_X64) || defined(__x86_64__)
+			if ( result.usedAvx2 )
+			{
+				_mm256_store_si256( reinterpret_cast<__m256i*>( readings ), ReadAvx2( sampler, _mm256_load_ps( cosR ), _mm256_load_ps( sinR ) ) );
+			}
+			else
+		#endif
+			{
+				for ( uint32_t lane = 0; lane < lanes; ++lane )
+				{
+					readings[lane] = ReadScalar( sampler, cosR[lane], sinR[lane] );
+				}
+			}
+
+			for ( uint32_t lane = 0; lane < lanes; ++lane )
+			{
+				const uint64_t sample = block + lane;
+				const uint32_t truth = static_cast<uint32_t>( sample / samplesPerSector );
+				const double within = ((sample % samplesPerSector) + 0.5) / samplesPerSector;
+
+				const uint32_t decoded = positions[readings[lane]];
+				if ( decoded == NoPosition )
+				{
+					tally.invalidReadings++;
+					tally.failures++;
+					tally.firstFailure = std::min( tally.firstFailure, sample );
+					continue;
+				}
+
+				double errorSectors = 0.0;
+				const DecodeVerdict verdict = Classify( decoded, truth, within, period, errorSectors );
+				tally.maxErrorDeg = std::max( tally.maxErrorDeg, errorSectors * sectorDeg );
+
+				if ( verdict == DecodeVerdict::Exact )
+				{
+					tally.exact++;
+				}
+				else if ( verdict == DecodeVerdict::Boundary )
+				{
+					tally.boundary++;
+				}
+				else
+				{
+					tally.failures++;
+					tally.firstFailure = std::min( tally.firstFailure, sample );
+				}
+			}
+		}
+	} );
+
+	for ( const SweepTally& tally : tallies )
+	{
+		result.exact += tally.exact;
+		result.boundary += tally.boundary;
+		result.failures += tally.failures;
+		result.invalidReadings += tally.invalidReadings;
+		result.firstFailure = std::min( result.firstFailure, tally.firstFailure );
+		result.maxErrorDeg = std::max( result.maxErrorDeg, tally.maxErrorDeg );
+	}
+
+	if ( result.firstFailure != SensorSimulationResult::NoIndex )
+	{
+		result.firstFailureDeg = (result.firstFailure + 0.5) * sampleStepDeg;
+	}
+
+	result.sampleCount = sampleCount;
+	result.passed = result.failures == 0;
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::vector<uint32_t> SensorSimulator::BuildDecodeTable( const std::vector<unsigned int>& codes, size_t headCount )
+{
+	std::vector<uint32_t> positions( size_t( 1 ) << std::min( headCount, MaxHeads ), NoPosition );
+
+	for ( uint32_t position = 0; position < codes.size(); ++position )
+	{
+		if ( codes[position] < positions.size() )
+		{
+			positions[codes[position]] = position;
+		}
+	}
+
+	return positions;
+}
@@ -0,0 +1,182 @@
+/*------------------------------------------------------------------------------
+	()      File:   sensor_simulator.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Virtual photo sensor sweep over a rendered encoder disc.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <blend2d.h>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// SensorHead
+//	One photo sensor, placed in disc units relative to the rotation axis at
+//	rotation 0. Head i produces bit i of the reading.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct SensorHead
+{
+	double radius = 0.0;
+	double angleDeg = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// SensorModel
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct SensorModel
+{
+	std::vector<SensorHead> heads;
+
+	// Radius of the sensor spot in disc units, 0 samples a single pixel.
+	double aperture = 0.0;
+
+	// Mounting errors applied to every head.
+	double radialMisalignment = 0.0;
+	double angularMisalignmentDeg = 0.0;
+
+	// Where the rotation axis sits relative to the printed centre, in disc units.
+	double eccentricityX = 0.0;
+	double eccentricityY = 0.0;
+
+	// Mean green level below which a head reads 1 (dark mark on a light disc).
+	uint8_t threshold = 128;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// SensorRaster
+//	Maps disc units onto the pixels of the rendered image.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct SensorRaster
+{
+	double centreX = 0.0;
+	double centreY = 0.0;
+	double pixelsPerUnit = 1.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// SensorSimulationResult
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct SensorSimulationResult
+{
+	static constexpr uint64_t NoIndex = UINT64_MAX;
+
+	bool passed = false;
+	uint64_t sampleCount = 0;
+
+	// Decoded to the sector under the heads.
+	uint64_t exact = 0;
+	// Decoded to the neighbouring sector while within a quarter sector of the edge between them.
+	uint64_t boundary = 0;
+	// Anything else, including readings that are not in the code.
+	uint64_t failures = 0;
+	uint64_t invalidReadings = 0;
+
+	uint64_t firstFailure = NoIndex;
+	double firstFailureDeg = 0.0;
+	double maxErrorDeg = 0.0;
+
+	uint32_t threadsUsed = 0;
+	bool usedAvx2 = false;
+	double elapsedMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class DecodeVerdict
+{
+	Exact,
+	Boundary,
+	Failure,
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// SensorSimulator
+//	Reads a rendered encoder image through a set of virtual sensors while
+//	sweeping the disc through a full turn, and decodes every reading back to
+//	a sector to compare against the true angle.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class SensorSimulator
+{
+public:
+	// codes[i] is the reading expected over sector i. samplesPerSector = 1 samples
+	// each sector centre, larger values sweep sub-sector angles.
+	static SensorSimulationResult Run( const BLImage& image,
+		const SensorRaster& raster,
+		const SensorModel& model,
+		const std::vector<unsigned int>& codes,
+		uint32_t samplesPerSector = 1,
+		uint32_t threads = 0
+	);
+
+	static constexpr uint32_t NoPosition = UINT32_MAX;
+
+	// Reading -> sector table, NoPosition for readings that are not in the code.
+	static std::vector<uint32_t> BuildDecodeTable( const std::vector<unsigned int>& codes, size_t headCount );
+
+	// Compares a decoded sector against the true one. within is how far through the
+	// true sector the disc is, in [0, 1). errorSectors is the distance from the
+	// decoded sector's centre to the true angle.
+	static inline DecodeVerdict Classify( uint32_t decoded, uint32_t truth, double within, uint32_t period, double& errorSectors );
+};
+
+//------------------------------------------------------------------------------
+// Inline for SensorSimulator
+//------------------------------------------------------------------------------
+
+inline DecodeVerdict SensorSimulator::Classify( uint32_t decoded, uint32_t truth, double within, uint32_t period, double& errorSectors )
+{
+	const uint32_t ahead = (decoded + period - truth) % period;
+	const uint32_t distance = ahead < period - ahead ? ahead : period - ahead;
+
+	const double signedSectors = (ahead == distance ? double( distance ) : -double( distance )) + 0.5 - within;
+	errorSectors = signedSectors < 0.0 ? -signedSectors : signedSectors;
+
+	if ( ahead == 0 )
+	{
+		return DecodeVerdict::Exact;
+	}
+
+	// Off by one is expected within a quarter sector of the edge between them.
+	if ( (ahead == 1 && within >= 0.75) || (ahead == period - 1 && within < 0.25) )
+	{
+		return DecodeVerdict::Boundary;
+	}
+
+	return DecodeVerdict::Failure;
+}
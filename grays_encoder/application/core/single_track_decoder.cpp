@@ -0,0 +1,168 @@
+/*------------------------------------------------------------------------------
+	()      File:   single_track_decoder.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Table decoder for single track codes read by several heads.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include "application/core/single_track_decoder.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// SingleTrackDecoder
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool SingleTrackDecoder::Build( const std::vector<uint8_t>& ring, const std::vector<uint32_t>& headOffsets, uint32_t threads /*= 0*/ )
+{
+	m_ring = ring;
+	m_headOffsets = headOffsets;
+	m_positions.clear();
+	m_unique = false;
+
+	const int heads = GetHeadCount();
+	if ( m_ring.empty() || heads < 1 || heads > 28 )
+	{
+		return false;
+	}
+
+	std::unique_ptr<std::atomic<uint32_t>[]> table( new std::atomic<uint32_t>[size_t( 1 ) << heads] );
+	std::atomic<bool> collision = false;
+
+	parallel::ForRange( uint64_t( 1 ) << heads, threads, [&]( uint64_t begin, uint64_t end, uint32_t )
+	{
+		for ( uint64_t reading = begin; reading < end; ++reading )
+		{
+			table[reading].store( Invalid, std::memory_order_relaxed );
+		}
+	} );
+
+	parallel::ForRange( m_ring.size(), threads, [&]( uint64_t begin, uint64_t end, uint32_t )
+	{
+		for ( uint64_t position = begin; position < end; ++position )
+		{
+			uint32_t expected = Invalid;
+			if ( !table[Read( static_cast<uint32_t>( position ) )].compare_exchange_strong( expected, static_cast<uint32_t>( position ) ) )
+			{
+				collision = true;
+			}
+		}
+	} );
+
+	m_positions.resize( size_t( 1 ) << heads );
+	for ( size_t reading = 0; reading < m_positions.size(); ++reading )
+	{
+		m_positions[reading] = table[reading].load( std::memory_order_relaxed );
+	}
+
+	m_unique = !collision;
+	return m_unique;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+unsigned int SingleTrackDecoder::Read( uint32_t position ) const
+{
+	const size_t period = m_ring.size();
+
+	unsigned int reading = 0;
+	for ( size_t head = 0; head < m_headOffsets.size(); ++head )
+	{
+		reading |= static_cast<unsigned int>( m_ring[(position + m_headOffsets[head]) % period] & 1u ) << head;
+	}
+
+	return reading;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+uint32_t SingleTrackDecoder::Decode( unsigned int reading ) const
+{
+	return reading < m_positions.size() ? m_positions[reading] : Invalid;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+CodeValidationResult SingleTrackDecoder::Validate( uint32_t threads /*= 0*/ ) const
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	const uint32_t period = GetPeriod();
+
+	std::vector<unsigned int> readings( period );
+	std::atomic<uint64_t> mismatch = CodeValidationResult::NoIndex;
+
+	parallel::ForRange( period, threads, [&]( uint64_t begin, uint64_t end, uint32_t )
+	{
+		for ( uint64_t position = begin; position < end; ++position )
+		{
+			readings[position] = Read( static_cast<uint32_t>( position ) );
+
+			if ( Decode( readings[position] ) != position )
+			{
+				uint64_t current = mismatch.load();
+				while ( position < current && !mismatch.compare_exchange_weak( current, position ) )
+				{
+				}
+			}
+		}
+	} );
+
+	CodeValidationResult result = CodeValidator::Validate( readings, GetHeadCount(), threads );
+
+	if ( !m_unique || mismatch != CodeValidationResult::NoIndex )
+	{
+		result.valid = false;
+		result.duplicate = std::min<uint64_t>( result.duplicate, mismatch );
+	}
+
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+uint32_t SingleTrackDecoder::GetPeriod() const
+{
+	return static_cast<uint32_t>( m_ring.size() );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+int SingleTrackDecoder::GetHeadCount() const
+{
+	return static_cast<int>( m_headOffsets.size() );
+}
@@ -0,0 +1,69 @@
+/*------------------------------------------------------------------------------
+	()      File:   single_track_decoder.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Table decoder for single track codes read by several heads.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include "application/core/code_validator.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// SingleTrackDecoder
+//	Reads a single track ring through its heads the way the sensor would and
+//	maps each head reading back to a disc position.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class SingleTrackDecoder
+{
+public:
+	static constexpr uint32_t Invalid = UINT32_MAX;
+
+	// Builds the reading -> position table. False if two positions read the same.
+	bool Build( const std::vector<uint8_t>& ring, const std::vector<uint32_t>& headOffsets, uint32_t threads = 0 );
+
+	// Head reading at disc position, bit h is head h.
+	unsigned int Read( uint32_t position ) const;
+	uint32_t Decode( unsigned int reading ) const;
+
+	// Decodes every position in parallel and checks it maps back to itself, then
+	// checks the readings form a cyclic Gray code.
+	CodeValidationResult Validate( uint32_t threads = 0 ) const;
+
+	uint32_t GetPeriod() const;
+	int GetHeadCount() const;
+
+private:
+	std::vector<uint8_t> m_ring;
+	std::vector<uint32_t> m_headOffsets;
+	std::vector<uint32_t> m_positions;
+	bool m_unique = false;
+};
@@ -0,0 +1,819 @@
+/*------------------------------------------------------------------------------
+	()      File:   tiled_export.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Tiled PNG and TIFF writers for print resolution artwork.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <vector>
+#include "application/core/tiled_export.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	// Deflate limits, RFC 1951.
+	constexpr uint32_t MinMatch = 3;
+	constexpr uint32_t MaxMatch = 258;
+	constexpr uint32_t WindowSize = 32768;
+	constexpr uint32_t HashBits = 15;
+
+	// Classic TIFF offsets are 32 bit.
+	constexpr uint64_t TiffMaxBytes = UINT32_MAX;
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	struct HuffmanCode
+	{
+		uint16_t bits = 0;	//already bit reversed, deflate sends codes msb first.
+		uint8_t length = 0;
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	uint32_t ReverseBits( uint32_t value, uint32_t length )
+	{
+		uint32_t reversed = 0;
+		for ( uint32_t bit = 0; bit < length; ++bit )
+		{
+			reversed = (reversed << 1) | ((value >> bit) & 1u);
+		}
+
+		return reversed;
+	}
+
+	//------------------------------------------------------------------------------
+	// Fixed literal/length and distance codes, RFC 1951 3.2.6.
+	//------------------------------------------------------------------------------
+	struct FixedCodes
+	{
+		std::array<HuffmanCode, 288> literals;
+		std::array<HuffmanCode, 30> distances;
+
+		FixedCodes()
+		{
+			for ( uint32_t symbol = 0; symbol < literals.size(); ++symbol )
+			{
+				uint32_t code = 0;
+				uint32_t length = 0;
+
+				if ( symbol < 144 )
+				{
+					code = 0x30 + symbol;
+					length = 8;
+				}
+				else if ( symbol < 256 )
+				{
+					code = 0x190 + symbol - 144;
+					length = 9;
+				}
+				else if ( symbol < 280 )
+				{
+					code = symbol - 256;
+					length = 7;
+				}
+				else
+				{
+					code = 0xC0 + symbol - 280;
+					length = 8;
+				}
+
+				literals[symbol] = { static_cast<uint16_t>( ReverseBits( code, length ) ), static_cast<uint8_t>( length ) };
+			}
+
+			for ( uint32_t symbol = 0; symbol < distances.size(); ++symbol )
+			{
+				distances[symbol] = { static_cast<uint16_t>( ReverseBits( symbol, 5 ) ), 5 };
+			}
+		}
+	};
+
+	const FixedCodes& GetFixedCodes()
+	{
+		static const FixedCodes codes;
+		return codes;
+	}
+
+	constexpr std::array<uint16_t, 29> LengthBase = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	constexpr std::array<uint8_t, 29> LengthExtra = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	constexpr std::array<uint16_t, 30> DistanceBase = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	constexpr std::array<uint8_t, 30> DistanceExtra = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	//------------------------------------------------------------------------------
+	// Index of the last base <= value.
+	//------------------------------------------------------------------------------
+	template<class Table>
+	uint32_t FindBase( const Table& bases, uint32_t value )
+	{
+		return static_cast<uint32_t>( std::upper_bound( bases.begin(), bases.end(), value ) - bases.begin() ) - 1;
+	}
+
+	//------------------------------------------------------------------------------
+	// Lsb first bit packer.
+	//------------------------------------------------------------------------------
+	class BitWriter
+	{
+	public:
+		explicit BitWriter( std::vector<uint8_t>& out ) : m_out( out ) {}
+
+		void Put( uint32_t bits, uint32_t count )
+		{
+			m_buffer |= uint64_t( bits ) << m_count;
+			m_count += count;
+
+			while ( m_count >= 8 )
+			{
+				m_out.push_back( static_cast<uint8_t>( m_buffer ) );
+				m_buffer >>= 8;
+				m_count -= 8;
+			}
+		}
+
+		void Put( const HuffmanCode& code )
+		{
+			Put( code.bits, code.length );
+		}
+
+		void Align()
+		{
+			if ( m_count != 0 )
+			{
+				Put( 0, 8 - m_count );
+			}
+		}
+
+	private:
+		std::vector<uint8_t>& m_out;
+		uint64_t m_buffer = 0;
+		uint32_t m_count = 0;
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	uint32_t MatchLength( const uint8_t* data, size_t at, size_t from, size_t size )
+	{
+		const size_t limit = std::min<size_t>( MaxMatch, size - at );
+
+		size_t length = 0;
+		while ( length < limit && data[at + length] == data[from + length] )
+		{
+			++length;
+		}
+
+		return static_cast<uint32_t>( length );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	uint32_t Hash( const uint8_t* data )
+	{
+		const uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16);
+		return (value * 2654435761u) >> (32 - HashBits);
+	}
+
+	//------------------------------------------------------------------------------
+	// Appends one fixed Huffman block for data followed by a sync flush, so
+	// independently compressed slices can be concatenated into one stream.
+	// Greedy matching, trying the previous byte first since filtered artwork
+	// is almost entirely runs.
+	//------------------------------------------------------------------------------
+	void DeflateSlice( const uint8_t* data, size_t size, std::vector<uint8_t>& out )
+	{
+		const FixedCodes& codes = GetFixedCodes();
+		BitWriter writer( out );
+
+		//BFINAL 0, BTYPE 01.
+		writer.Put( 0, 1 );
+		writer.Put( 1, 2 );
+
+		std::vector<int64_t> head( size_t( 1 ) << HashBits, -1 );
+
+		size_t at = 0;
+		while ( at < size )
+		{
+			uint32_t bestLength = 0;
+			uint32_t bestDistance = 0;
+
+			if ( at + MinMatch <= size )
+			{
+				if ( at > 0 && data[at] == data[at - 1] )
+				{
+					bestLength = MatchLength( data, at, at - 1, size );
+					bestDistance = 1;
+				}
+
+				const uint32_t hash = Hash( data + at );
+				const int64_t candidate = head[hash];
+				head[hash] = static_cast<int64_t>( at );
+
+				if ( bestLength < MaxMatch && candidate >= 0 && at - candidate <= WindowSize )
+				{
+					const uint32_t length = MatchLength( data, at, static_cast<size_t>( candidate ), size );
+					if ( length > bestLength )
+					{
+						bestLength = length;
+						bestDistance = static_cast<uint32_t>( at - candidate );
+					}
+				}
+			}
+
+			if ( bestLength < MinMatch )
+			{
+				writer.Put( codes.literals[data[at]] );
+				++at;
+				continue;
+			}
+
+			const uint32_t lengthIndex = FindBase( LengthBase, bestLength );
+			writer.Put( codes.literals[257 + lengthIndex] );
+			writer.Put( bestLength - LengthBase[lengthIndex], LengthExtra[lengthIndex] );
+
+			const uint32_t distanceIndex = FindBase( DistanceBase, bestDistance );
+			writer.Put( codes.distances[distanceIndex] );
+			writer.Put( bestDistance - DistanceBase[distanceIndex], DistanceExtra[distanceIndex] );
+
+			//short matches are worth indexing, long runs just get skipped.
+			if ( bestLength < 32 )
+			{
+				for ( size_t index = at + 1; index < at + bestLength && index + MinMatch <= size; ++index )
+				{
+					head[Hash( data + index )] = static_cast<int64_t>( index );
+				}
+			}
+
+			at += bestLength;
+		}
+
+		writer.Put( codes.literals[256] );
+
+		//sync flush, an empty stored block ends the slice on a byte boundary.
+		writer.Put( 0, 3 );
+		writer.Align();
+		out.insert( out.end(), { 0x00, 0x00, 0xFF, 0xFF } );
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	uint32_t Adler32( uint32_t adler, const uint8_t* data, size_t size )
+	{
+		constexpr uint32_t Base = 65521;
+		constexpr size_t MaxRun = 5552;	//largest run before the sums can overflow.
+
+		uint32_t a = adler & 0xFFFF;
+		uint32_t b = adler >> 16;
+
+		while ( size > 0 )
+		{
+			const size_t run = std::min( size, MaxRun );
+			for ( size_t index = 0; index < run; ++index )
+			{
+				a += data[index];
+				b += a;
+			}
+
+			a %= Base;
+			b %= Base;
+			data += run;
+			size -= run;
+		}
+
+		return (b << 16) | a;
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	uint32_t Crc32( uint32_t crc, const uint8_t* data, size_t size )
+	{
+		static const std::array<uint32_t, 256> table = []()
+		{
+			std::array<uint32_t, 256> entries{};
+			for ( uint32_t index = 0; index < entries.size(); ++index )
+			{
+				uint32_t value = index;
+				for ( int bit = 0; bit < 8; ++bit )
+				{
+					value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+				}
+
+				entries[index] = value;
+			}
+
+			return entries;
+		}();
+
+		crc = ~crc;
+		for ( size_t index = 0; index < size; ++index )
+		{
+			crc = table[(crc ^ data[index]) & 0xFF] ^ (crc >> 8);
+		}
+
+		return ~crc;
+	}
+
+	//------------------------------------------------------------------------------
+	// PackBits, runs of 2..128 and literals of 1..128 bytes.
+	//------------------------------------------------------------------------------
+	void PackBits( const uint8_t* data, size_t size, std::vector<uint8_t>& out )
+	{
+		size_t at = 0;
+		while ( at < size )
+		{
+			size_t run = 1;
+			while ( at + run < size && run < 128 && data[at + run] == data[at] )
+			{
+				++run;
+			}
+
+			if ( run >= 2 )
+			{
+				out.push_back( static_cast<uint8_t>( 257 - run ) );
+				out.push_back( data[at] );
+				at += run;
+				continue;
+			}
+
+			//literal until the next run of at least two.
+			size_t literal = 1;
+			while ( at + literal < size && literal < 128 && !(at + literal + 1 < size && data[at + literal] == data[at + literal + 1]) )
+			{
+				++literal;
+			}
+
+			out.push_back( static_cast<uint8_t>( literal - 1 ) );
+			out.insert( out.end(), data + at, data + at + literal );
+			at += literal;
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	void PutBE32( std::vector<uint8_t>& out, uint32_t value )
+	{
+		out.insert( out.end(), { uint8_t( value >> 24 ), uint8_t( value >> 16 ), uint8_t( value >> 8 ), uint8_t( value ) } );
+	}
+
+	void PutLE16( std::vector<uint8_t>& out, uint16_t value )
+	{
+		out.insert( out.end(), { uint8_t( value ), uint8_t( value >> 8 ) } );
+	}
+
+	void PutLE32( std::vector<uint8_t>& out, uint32_t value )
+	{
+		out.insert( out.end(), { uint8_t( value ), uint8_t( value >> 8 ), uint8_t( value >> 16 ), uint8_t( value >> 24 ) } );
+	}
+
+	//------------------------------------------------------------------------------
+	// Bytes per row of pixels at the output depth.
+	//------------------------------------------------------------------------------
+	size_t GetRowBytes( uint32_t pixels, ExportDepth depth )
+	{
+		return depth == ExportDepth::Mono1 ? (size_t( pixels ) + 7) / 8 : pixels;
+	}
+
+	//------------------------------------------------------------------------------
+	// Reduces one row of coverage, y is the output row for dithering.
+	//------------------------------------------------------------------------------
+	void ConvertRow( const uint8_t* coverage, uint32_t pixels, uint8_t* dst, uint32_t y, const ExportOptions& options )
+	{
+		if ( options.depth == ExportDepth::Gray8 )
+		{
+			Monochrome::CoverageToGrey( coverage, pixels, dst );
+		}
+		else
+		{
+			Monochrome::PackCoverage( coverage, pixels, dst, y, options.packing, options.threshold );
+		}
+	}
+
+	//------------------------------------------------------------------------------
+	// Renders one tile of the output with its top left at (x, y) into tile,
+	// which is reused between calls.
+	//------------------------------------------------------------------------------
+	void RenderTile( BLImage& tile, uint32_t x, uint32_t y, const TiledExporter::DrawFn& draw )
+	{
+		BLContext ctx( tile );
+		ctx.clearAll();
+		ctx.translate( -double( x ), -double( y ) );
+
+		draw( ctx, BLBoxI( int( x ), int( y ), int( x ) + tile.width(), int( y ) + tile.height() ) );
+		ctx.end();
+	}
+
+	//------------------------------------------------------------------------------
+	// Writes a PNG chunk, length and crc around the payload.
+	//------------------------------------------------------------------------------
+	void WriteChunk( std::ofstream& file, const char* type, const uint8_t* data, size_t size, ExportResult& result )
+	{
+		std::vector<uint8_t> header;
+		PutBE32( header, static_cast<uint32_t>( size ) );
+		header.insert( header.end(), type, type + 4 );
+
+		std::vector<uint8_t> footer;
+		PutBE32( footer, Crc32( Crc32( 0, header.data() + 4, 4 ), data, size ) );
+
+		file.write( reinterpret_cast<const char*>( header.data() ), header.size() );
+		file.write( reinterpret_cast<const char*>( data ), size );
+		file.write( reinterpret_cast<const char*>( footer.data() ), footer.size() );
+
+		result.bytesWritten += header.size() + size + footer.size();
+	}
+
+	//------------------------------------------------------------------------------
+	// Row sequential. Each band of rows is rendered as tiles across its width,
+	// Up filtered, then deflated in one slice per worker.
+	//------------------------------------------------------------------------------
+	void WritePng( std::ofstream& file, uint32_t width, uint32_t height, const ExportOptions& options, uint32_t tileSize, uint32_t workerCount, const TiledExporter::DrawFn& draw, const TiledExporter::ProgressFn& progress, ExportResult& result )
+	{
+		const size_t rowBytes = GetRowBytes( width, options.depth );
+		const size_t stride = rowBytes + 1;	//filter byte.
+
+		const uint8_t signature[] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+		file.write( reinterpret_cast<const char*>( signature ), sizeof( signature ) );
+		result.bytesWritten += sizeof( signature );
+
+		std::vector<uint8_t> header;
+		PutBE32( header, width );
+		PutBE32( header, height );
+		header.push_back( options.depth == ExportDepth::Mono1 ? 1 : 8 );
+		header.insert( header.end(), { 0, 0, 0, 0 } );	//greyscale, deflate, adaptive filters, no interlace.
+		WriteChunk( file, "IHDR", header.data(), header.size(), result );
+
+		const uint32_t tilesAcross = (width + tileSize - 1) / tileSize;
+
+		std::vector<BLImage> tiles( workerCount );
+		std::vector<std::vector<uint8_t>> slices( workerCount );
+		std::vector<uint8_t> band( stride * tileSize );
+		std::vector<uint8_t> previousRow( rowBytes, 0 );
+		std::vector<uint8_t> row( rowBytes );
+
+		uint32_t adler = 1;
+
+		for ( uint32_t y = 0; y < height && result.error.empty(); y += tileSize )
+		{
+			const uint32_t rows = std::min( tileSize, height - y );
+
+			parallel::ForRange( tilesAcross, workerCount, [&]( uint64_t begin, uint64_t end, uint32_t worker )
+			{
+				BLImage& tile = tiles[worker];
+				if ( tile.empty() )
+				{
+					tile.create( int( tileSize ), int( tileSize ), BL_FORMAT_A8 );
+				}
+
+				BLImageData pixels;
+				for ( uint64_t across = begin; across < end; ++across )
+				{
+					const uint32_t x = static_cast<uint32_t>( across ) * tileSize;
+					const uint32_t columns = std::min( tileSize, width - x );
+
+					RenderTile( tile, x, y, draw );
+					tile.getData( &pixels );
+
+					for ( uint32_t line = 0; line < rows; ++line )
+					{
+						const uint8_t* src = static_cast<const uint8_t*>( pixels.pixelData ) + pixels.stride * intptr_t( line );
+						ConvertRow( src, columns, band.data() + stride * line + 1 + GetRowBytes( x, options.depth ), y + line, options );
+					}
+				}
+			} );
+
+			//Up filter from the bottom, each row still needs the raw row above it.
+			std::copy_n( band.data() + stride * (rows - 1) + 1, rowBytes, row.data() );
+			for ( uint32_t line = rows; line-- > 0; )
+			{
+				uint8_t* current = band.data() + stride * line + 1;
+				const uint8_t* above = line == 0 ? previousRow.data() : current - stride;
+
+				current[-1] = 2;
+				for ( size_t index = 0; index < rowBytes; ++index )
+				{
+					current[index] = static_cast<uint8_t>( current[index] - above[index] );
+				}
+			}
+			previousRow.swap( row );
+
+			const size_t bandBytes = stride * rows;
+			adler = Adler32( adler, band.data(), bandBytes );
+
+			const uint32_t sliceCount = std::min<uint32_t>( workerCount, rows );
+			const uint32_t sliced = parallel::ForRange( rows, sliceCount, [&]( uint64_t begin, uint64_t end, uint32_t worker )
+			{
+				slices[worker].clear();
+				if ( y == 0 && begin == 0 )
+				{
+					slices[worker].insert( slices[worker].end(), { 0x78, 0x01 } );	//zlib header, 32K window.
+				}
+
+				DeflateSlice( band.data() + stride * begin, stride * (end - begin), slices[worker] );
+			} );
+
+			uint64_t held = band.size();
+			for ( uint32_t slice = 0; slice < sliced; ++slice )
+			{
+				WriteChunk( file, "IDAT", slices[slice].data(), slices[slice].size(), result );
+				held += slices[slice].capacity();
+			}
+
+			for ( const BLImage& tile : tiles )
+			{
+				held += uint64_t( tile.width() ) * tile.height();
+			}
+
+			result.peakBufferBytes = std::max( result.peakBufferBytes, held );
+			result.tiles += tilesAcross;
+
+			if ( !file )
+			{
+				result.error = "Write failed.";
+			}
+			else if ( progress && !progress( y + rows, height ) )
+			{
+				result.cancelled = true;
+				result.error = "Cancelled.";
+			}
+		}
+
+		if ( !result.error.empty() )
+		{
+			return;
+		}
+
+		//final empty fixed block then the checksum.
+		std::vector<uint8_t> trailer = { 0x03, 0x00 };
+		PutBE32( trailer, adler );
+		WriteChunk( file, "IDAT", trailer.data(), trailer.size(), result );
+		WriteChunk( file, "IEND", nullptr, 0, result );
+	}
+
+	//------------------------------------------------------------------------------
+	// Tiles in row major order, rendered and packed a batch of one per worker
+	// at a time. Offsets are gathered as tiles land and the IFD goes last.
+	//------------------------------------------------------------------------------
+	void WriteTiff( std::ofstream& file, uint32_t width, uint32_t height, const ExportOptions& options, uint32_t tileSize, uint32_t workerCount, const TiledExporter::DrawFn& draw, const TiledExporter::ProgressFn& progress, ExportResult& result )
+	{
+		const uint32_t tilesAcross = (width + tileSize - 1) / tileSize;
+		const uint32_t tilesDown = (height + tileSize - 1) / tileSize;
+		const uint64_t tileCount = uint64_t( tilesAcross ) * tilesDown;
+		const size_t rowBytes = GetRowBytes( tileSize, options.depth );
+
+		//"II", 42, first IFD offset patched at the end.
+		std::vector<uint8_t> header = { 'I', 'I', 42, 0, 0, 0, 0, 0 };
+		file.write( reinterpret_cast<const char*>( header.data() ), header.size() );
+		result.bytesWritten += header.size();
+
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> byteCounts;
+		offsets.reserve( tileCount );
+		byteCounts.reserve( tileCount );
+
+		std::vector<BLImage> tiles( workerCount );
+		std::vector<std::vector<uint8_t>> packed( workerCount );
+		std::vector<std::vector<uint8_t>> rows( workerCount );
+
+		for ( uint64_t batch = 0; batch < tileCount && result.error.empty(); batch += workerCount )
+		{
+			const uint32_t batchCount = static_cast<uint32_t>( std::min<uint64_t>( workerCount, tileCount - batch ) );
+
+			parallel::ForRange( batchCount, workerCount, [&]( uint64_t begin, uint64_t end, uint32_t worker )
+			{
+				BLImage& tile = tiles[worker];
+				if ( tile.empty() )
+				{
+					tile.create( int( tileSize ), int( tileSize ), BL_FORMAT_A8 );
+					rows[worker].resize( rowBytes );
+				}
+
+				BLImageData pixels;
+				for ( uint64_t slot = begin; slot < end; ++slot )
+				{
+					const uint64_t index = batch + slot;
+					const uint32_t x = static_cast<uint32_t>( index % tilesAcross ) * tileSize;
+					const uint32_t y = static_cast<uint32_t>( index / tilesAcross ) * tileSize;
+
+					RenderTile( tile, x, y, draw );
+					tile.getData( &pixels );
+
+					//edge tiles are padded out with whatever the draw left there.
+					std::vector<uint8_t>& out = packed[slot];
+					out.clear();
+					for ( uint32_t line = 0; line < tileSize; ++line )
+					{
+						const uint8_t* src = static_cast<const uint8_t*>( pixels.pixelData ) + pixels.stride * intptr_t( line );
+						ConvertRow( src, tileSize, rows[worker].data(), y + line, options );
+						PackBits( rows[worker].data(), rowBytes, out );
+					}
+				}
+			} );
+
+			uint64_t held = 0;
+			for ( uint32_t slot = 0; slot < batchCount; ++slot )
+			{
+				if ( result.bytesWritten + packed[slot].size() > TiffMaxBytes )
+				{
+					result.error = "Output is larger than the 4 GiB classic TIFF limit.";
+					return;
+				}
+
+				offsets.push_back( static_cast<uint32_t>( result.bytesWritten ) );
+				byteCounts.push_back( static_cast<uint32_t>( packed[slot].size() ) );
+
+				file.write( reinterpret_cast<const char*>( packed[slot].data() ), packed[slot].size() );
+				result.bytesWritten += packed[slot].size();
+				held += packed[slot].capacity() + uint64_t( tileSize ) * tileSize;
+			}
+
+			result.peakBufferBytes = std::max( result.peakBufferBytes, held );
+			result.tiles += batchCount;
+
+			if ( !file )
+			{
+				result.error = "Write failed.";
+			}
+			else if ( progress && !progress( batch + batchCount, tileCount ) )
+			{
+				result.cancelled = true;
+				result.error = "Cancelled.";
+			}
+		}
+
+		if ( !result.error.empty() )
+		{
+			return;
+		}
+
+		//word align the arrays and the IFD.
+		std::vector<uint8_t> tail;
+		if ( result.bytesWritten & 1 )
+		{
+			tail.push_back( 0 );
+		}
+
+		const uint64_t offsetsAt = result.bytesWritten + tail.size();
+		for ( uint32_t offset : offsets )
+		{
+			PutLE32( tail, offset );
+		}
+
+		const uint64_t countsAt = result.bytesWritten + tail.size();
+		for ( uint32_t count : byteCounts )
+		{
+			PutLE32( tail, count );
+		}
+
+		const uint64_t ifdAt = result.bytesWritten + tail.size();
+		if ( ifdAt + 2 + 12 * 10 + 4 > TiffMaxBytes )
+		{
+			result.error = "Output is larger than the 4 GiB classic TIFF limit.";
+			return;
+		}
+
+		constexpr uint16_t Short = 3;
+		constexpr uint16_t Long = 4;
+
+		const auto entry = [&tail]( uint16_t tag, uint16_t type, uint32_t count, uint32_t value )
+		{
+			PutLE16( tail, tag );
+			PutLE16( tail, type );
+			PutLE32( tail, count );
+			PutLE32( tail, value );	//shorts sit in the low half on little endian.
+		};
+
+		//single tile files hold the offset and count inline.
+		const bool inlineArrays = tileCount == 1;
+
+		PutLE16( tail, 10 );
+		entry( 256, Long, 1, width );
+		entry( 257, Long, 1, height );
+		entry( 258, Short, 1, options.depth == ExportDepth::Mono1 ? 1 : 8 );
+		entry( 259, Short, 1, 32773 );	//PackBits.
+		entry( 262, Short, 1, 1 );		//BlackIsZero.
+		entry( 277, Short, 1, 1 );
+		entry( 322, Long, 1, tileSize );
+		entry( 323, Long, 1, tileSize );
+		entry( 324, Long, static_cast<uint32_t>( tileCount ), inlineArrays ? offsets[0] : static_cast<uint32_t>( offsetsAt ) );
+		entry( 325, Long, static_cast<uint32_t>( tileCount ), inlineArrays ? byteCounts[0] : static_cast<uint32_t>( countsAt ) );
+		PutLE32( tail, 0 );
+
+		file.write( reinterpret_cast<const char*>( tail.data() ), tail.size() );
+		result.bytesWritten += tail.size();
+
+		std::vector<uint8_t> ifdOffset;
+		PutLE32( ifdOffset, static_cast<uint32_t>( ifdAt ) );
+		file.seekp( 4 );
+		file.write( reinterpret_cast<const char*>( ifdOffset.data() ), ifdOffset.size() );
+
+		if ( !file )
+		{
+			result.error = "Write failed.";
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// TiledExporter
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ExportResult TiledExporter::Export( const std::filesystem::path& path, uint32_t width, uint32_t height, const ExportOptions& options, const DrawFn& draw, const ProgressFn& progress /*= nullptr*/ )
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	ExportResult result;
+	result.width = width;
+	result.height = height;
+
+	//blend2d images top out at 65535 a side, tiles stay well under.
+	const uint32_t tileSize = std::clamp<uint32_t>( (options.tileSize + 15) & ~15u, 16, 8192 );
+
+	if ( width == 0 || height == 0 || !draw )
+	{
+		result.error = "Nothing to export.";
+		return result;
+	}
+
+	std::ofstream file( path, std::ios::binary | std::ios::trunc );
+	if ( !file )
+	{
+		result.error = "Couldn't open the output file.";
+		return result;
+	}
+
+	result.threadsUsed = std::max( 1u, options.threads == 0 ? parallel::HardwareThreadCount() : options.threads );
+
+	if ( options.format == ExportFormat::TiledTiff )
+	{
+		WriteTiff( file, width, height, options, tileSize, result.threadsUsed, draw, progress, result );
+	}
+	else
+	{
+		WritePng( file, width, height, options, tileSize, result.threadsUsed, draw, progress, result );
+	}
+
+	file.close();
+	result.success = result.error.empty() && !file.fail();
+
+	if ( result.cancelled )
+	{
+		std::error_code error;
+		std::filesystem::remove( path, error );
+	}
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const char* TiledExporter::GetFormatName( ExportFormat format )
+{
+	switch ( format )
+	{
+	case ExportFormat::Png: return "PNG";
+	case ExportFormat::TiledTiff: return "Tiled TIFF";
+	default: return "Unknown";
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const char* TiledExporter::GetFormatFilter( ExportFormat format )
+{
+	switch ( format )
+	{
+	case ExportFormat::Png: return "PNG Image (*.png)";
+	case ExportFormat::TiledTiff: return "TIFF Image (*.tif *.tiff)";
+	default: return "All Files (*)";
+	}
+}
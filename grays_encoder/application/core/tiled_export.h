@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------------
+	()      File:   tiled_export.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Streams large renders to disk as PNG or tiled TIFF.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <blend2d.h>
+#include "application/core/monochrome.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class ExportFormat : uint32_t
+{
+	Png,
+	TiledTiff,
+
+	Count
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class ExportDepth : uint32_t
+{
+	Mono1,
+	Gray8,
+
+	Count
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ExportOptions
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct ExportOptions
+{
+	ExportFormat format = ExportFormat::Png;
+	ExportDepth depth = ExportDepth::Mono1;
+	double pixelsPerUnit = 8.0;
+
+	// PNG band height and TIFF tile edge, rounded up to a multiple of 16.
+	uint32_t tileSize = 1024;
+
+	// Grey level at or above which a 1-bit pixel is white.
+	uint8_t threshold = 128;
+	MonoPacking packing = MonoPacking::Threshold;
+	uint32_t threads = 0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ExportResult
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct ExportResult
+{
+	bool success = false;
+	std::string error;
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint64_t tiles = 0;
+	uint64_t bytesWritten = 0;
+
+	// Most tile, band and compressed data held at once, independent of height.
+	uint64_t peakBufferBytes = 0;
+
+	uint32_t threadsUsed = 0;
+	double elapsedMs = 0.0;
+
+	// Stopped through the progress callback, the partial file is removed.
+	bool cancelled = false;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// TiledExporter
+//	Renders an image of any size a tile at a time and streams it to disk.
+//	Tiles are drawn concurrently as A8 coverage, one context per worker, then
+//	reduced to 1-bit or 8-bit grey. PNG is written a band of rows at a time, each band
+//	deflated in parallel slices. TIFF is written as PackBits tiles, so its
+//	memory use doesn't depend on the image size at all.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class TiledExporter
+{
+public:
+	// Draws the artwork in output pixel coordinates, the context is already
+	// offset to the tile. Called from several threads at once.
+	using DrawFn = std::function<void( BLContext& ctx, const BLBoxI& pixels )>;
+	// Receives the work done so far after each band or batch of tiles, on the
+	// exporting thread. Return false to stop.
+	using ProgressFn = std::function<bool( uint64_t done, uint64_t total )>;
+
+	static ExportResult Export( const std::filesystem::path& path, uint32_t width, uint32_t height, const ExportOptions& options, const DrawFn& draw, const ProgressFn& progress = nullptr );
+
+	static const char* GetFormatName( ExportFormat format );
+	static const char* GetFormatFilter( ExportFormat format );
+};
@@ -0,0 +1,365 @@
+/*------------------------------------------------------------------------------
+	()      File:   tolerance_analysis.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Monte Carlo manufacturing tolerance analysis for encoder discs.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <blend2d.h>
+#include "application/core/tolerance_analysis.h"
+#include "utility/globals.h"
+#include "utility/parallel_for.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	// Standard normal variates, Box-Muller on the blend2d generator. Each pair
+	// of uniforms gives two variates, the second is kept for the next call.
+	//------------------------------------------------------------------------------
+	struct GaussianSource
+	{
+		explicit GaussianSource( uint64_t seed )
+			: rng( seed )
+		{
+		}
+
+		double Next()
+		{
+			if ( hasSpare )
+			{
+				hasSpare = false;
+				return spare;
+			}
+
+			const double u1 = 1.0 - rng.nextDouble();
+			const double u2 = rng.nextDouble();
+			const double magnitude = sqrt( -2.0 * log( u1 ) );
+			const double angle = maths::Pi2 * u2;
+
+			spare = magnitude * sin( angle );
+			hasSpare = true;
+			return magnitude * cos( angle );
+		}
+
+		BLRandom rng;
+		double spare = 0.0;
+		bool hasSpare = false;
+	};
+
+	//------------------------------------------------------------------------------
+	// Spreads neighbouring trial indices over unrelated generator seeds.
+	//------------------------------------------------------------------------------
+	uint64_t TrialSeed( uint64_t seed, uint32_t trial )
+	{
+		uint64_t x = seed + (uint64_t( trial ) + 1) * 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	//------------------------------------------------------------------------------
+	// Layout flattened for the inner loop.
+	//------------------------------------------------------------------------------
+	struct Disc
+	{
+		const DiscLayout* layout = nullptr;
+		uint32_t period = 0;
+		double sectorDeg = 0.0;
+		double sectorRad = 0.0;
+
+		//------------------------------------------------------------------------------
+		// True if the printed disc is dark at a point, with every mark edge moved
+		// out by bleed (or in, when negative).
+		//------------------------------------------------------------------------------
+		bool IsDark( double radius, double angleDeg, double bleed ) const
+		{
+			const std::vector<DiscTrack>& tracks = layout->tracks;
+			const int trackCount = static_cast<int>( tracks.size() );
+
+			const double sectorPos = angleDeg / sectorDeg;
+			const uint32_t sector = std::min( static_cast<uint32_t>( sectorPos ), period - 1 );
+			const double within = sectorPos - sector;
+
+			// Last track starting inside the point, -1 when inside the whole band.
+			int track = -1;
+			while ( track + 1 < trackCount && radius >= tracks[track + 1].innerRadius )
+			{
+				++track;
+			}
+
+			bool mark = false;
+			bool angularMark = false;
+			bool radialMark = false;
+			double radialDistance = 0.0;
+
+			if ( track >= 0 && radius < tracks[track].outerRadius )
+			{
+				const DiscTrack& local = tracks[track];
+				const uint32_t neighbour = within < 0.5 ? (sector + period - 1) % period : (sector + 1) % period;
+
+				mark = local.marks[sector] != 0;
+				angularMark = local.marks[neighbour] != 0;
+
+				const double lowGap = radius - local.innerRadius;
+				const double highGap = local.outerRadius - radius;
+				const int radialTrack = lowGap < highGap ? track - 1 : track + 1;
+
+				radialDistance = std::min( lowGap, highGap );
+				radialMark = radialTrack >= 0 && radialTrack < trackCount && tracks[radialTrack].marks[sector] != 0;
+			}
+			else
+			{
+				// Off the print, only the nearest track edge can bleed into the point.
+				const int below = track;
+				const int above = track + 1;
+
+				const double belowGap = below >= 0 ? radius - tracks[below].outerRadius : HUGE_VAL;
+				const double aboveGap = above < trackCount ? tracks[above].innerRadius - radius : HUGE_VAL;
+				const int nearest = belowGap < aboveGap ? below : above;
+
+				radialDistance = std::min( belowGap, aboveGap );
+				radialMark = tracks[nearest].marks[sector] != 0;
+			}
+
+			const double edgeDistance = radius * sectorRad * std::min( within, 1.0 - within );
+
+			if ( bleed > 0.0 )
+			{
+				return mark || (angularMark && edgeDistance < bleed) || (radialMark && radialDistance < bleed);
+			}
+
+			if ( bleed < 0.0 && mark )
+			{
+				return !((!angularMark && edgeDistance < -bleed) || (!radialMark && radialDistance < -bleed));
+			}
+
+			return mark;
+		}
+	};
+
+	//------------------------------------------------------------------------------
+	// Per worker tallies, merged once every trial has run.
+	//------------------------------------------------------------------------------
+	struct TrialTally
+	{
+		uint64_t exact = 0;
+		uint64_t boundary = 0;
+		uint64_t failures = 0;
+		uint64_t invalidReadings = 0;
+		uint32_t failedTrials = 0;
+		uint32_t worstTrial = ToleranceResult::NoTrial;
+		uint64_t worstTrialFailures = 0;
+		double maxErrorDeg = 0.0;
+		std::array<uint64_t, 8> errorHistogram = {};
+	};
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ToleranceAnalyzer
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ToleranceResult ToleranceAnalyzer::Run( const DiscLayout& layout, const ToleranceModel& model, const ToleranceRun& run )
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	ToleranceResult result;
+
+	const uint32_t period = static_cast<uint32_t>( layout.codes.size() );
+	if ( period < 2 || layout.tracks.empty() || layout.heads.empty() || run.trials == 0 || run.samplesPerSector == 0
+		|| std::any_of( layout.tracks.begin(), layout.tracks.end(), [period]( const DiscTrack& track ) { return track.marks.size() != period; } ) )
+	{
+		return result;
+	}
+
+	const std::vector<uint32_t> positions = SensorSimulator::BuildDecodeTable( layout.codes, layout.heads.size() );
+
+	Disc disc;
+	disc.layout = &layout;
+	disc.period = period;
+	disc.sectorDeg = 360.0 / period;
+	disc.sectorRad = DegToRad( disc.sectorDeg );
+
+	const uint64_t samplesPerTrial = uint64_t( period ) * run.samplesPerSector;
+	const double sampleStepRad = DegToRad( 360.0 / samplesPerTrial );
+	const size_t headCount = layout.heads.size();
+
+	const uint32_t workerCount = std::max( 1u, run.threads == 0 ? parallel::HardwareThreadCount() : run.threads );
+	std::vector<TrialTally> tallies( workerCount );
+
+	result.threadsUsed = parallel::ForRange( run.trials, workerCount, [&]( uint64_t begin, uint64_t end, uint32_t worker )
+	{
+		TrialTally& tally = tallies[worker];
+
+		std::vector<double> headX( headCount );
+		std::vector<double> headY( headCount );
+
+		for ( uint32_t trial = static_cast<uint32_t>( begin ); trial < end; ++trial )
+		{
+			GaussianSource gauss( TrialSeed( run.seed, trial ) );
+
+			// Disc and mounting for this trial.
+			const double eccentricityX = model.eccentricitySigma * gauss.Next();
+			const double eccentricityY = model.eccentricitySigma * gauss.Next();
+			const double scale = std::max( 1e-3, 1.0 + model.radiusScaleSigma * gauss.Next() );
+			const double bleed = (model.bleedMean + model.bleedSigma * gauss.Next()) / scale;
+			const double radialOffset = model.sensorRadialSigma * gauss.Next();
+
+			for ( size_t head = 0; head < headCount; ++head )
+			{
+				const double radius = layout.heads[head].radius + radialOffset;
+				const double angleRad = DegToRad( layout.heads[head].angleDeg );
+
+				headX[head] = radius * cos( angleRad );
+				headY[head] = radius * sin( angleRad );
+			}
+
+			uint64_t trialFailures = 0;
+
+			for ( uint64_t sample = 0; sample < samplesPerTrial; ++sample )
+			{
+				const double rotation = (sample + 0.5) * sampleStepRad;
+				const double cosR = cos( rotation );
+				const double sinR = sin( rotation );
+
+				unsigned int reading = 0;
+				for ( size_t head = 0; head < headCount; ++head )
+				{
+					double x = cosR * headX[head] - sinR * headY[head];
+					double y = sinR * headX[head] + cosR * headY[head];
+
+					// Jitter is a fraction of a degree, a small angle rotation is plenty.
+					if ( model.headJitterSigmaDeg > 0.0 )
+					{
+						const double jitter = DegToRad( model.headJitterSigmaDeg * gauss.Next() );
+						const double cosJ = 1.0 - jitter * jitter * 0.5;
+
+						const double jx = cosJ * x - jitter * y;
+						y = jitter * x + cosJ * y;
+						x = jx;
+					}
+
+					x = (x + eccentricityX) / scale;
+					y = (y + eccentricityY) / scale;
+
+					double angleDeg = RadToDeg( atan2( y, x ) );
+					if ( angleDeg < 0.0 )
+					{
+						angleDeg += 360.0;
+					}
+
+					reading |= static_cast<unsigned int>( disc.IsDark( sqrt( x * x + y * y ), angleDeg, bleed ) ) << head;
+				}
+
+				const uint32_t truth = static_cast<uint32_t>( sample / run.samplesPerSector );
+				const double within = ((sample % run.samplesPerSector) + 0.5) / run.samplesPerSector;
+
+				const uint32_t decoded = positions[reading];
+				if ( decoded == SensorSimulator::NoPosition )
+				{
+					tally.invalidReadings++;
+					tally.failures++;
+					tally.errorHistogram.back()++;
+					trialFailures++;
+					continue;
+				}
+
+				double errorSectors = 0.0;
+				const DecodeVerdict verdict = SensorSimulator::Classify( decoded, truth, within, period, errorSectors );
+				tally.maxErrorDeg = std::max( tally.maxErrorDeg, errorSectors * disc.sectorDeg );
+
+				const uint32_t ahead = (decoded + period - truth) % period;
+				const size_t bucket = std::min<size_t>( std::min( ahead, period - ahead ), tally.errorHistogram.size() - 1 );
+				tally.errorHistogram[bucket]++;
+
+				if ( verdict == DecodeVerdict::Exact )
+				{
+					tally.exact++;
+				}
+				else if ( verdict == DecodeVerdict::Boundary )
+				{
+					tally.boundary++;
+				}
+				else
+				{
+					tally.failures++;
+					trialFailures++;
+				}
+			}
+
+			if ( trialFailures != 0 )
+			{
+				tally.failedTrials++;
+
+				// Trials run in order within a worker, so ties keep the lowest index.
+				if ( trialFailures > tally.worstTrialFailures )
+				{
+					tally.worstTrialFailures = trialFailures;
+					tally.worstTrial = trial;
+				}
+			}
+		}
+	} );
+
+	// Workers own ascending trial ranges, merging in order keeps the result independent of timing.
+	for ( const TrialTally& tally : tallies )
+	{
+		result.exact += tally.exact;
+		result.boundary += tally.boundary;
+		result.failures += tally.failures;
+		result.invalidReadings += tally.invalidReadings;
+		result.failedTrials += tally.failedTrials;
+		result.maxErrorDeg = std::max( result.maxErrorDeg, tally.maxErrorDeg );
+
+		if ( tally.worstTrialFailures > result.worstTrialFailures )
+		{
+			result.worstTrialFailures = tally.worstTrialFailures;
+			result.worstTrial = tally.worstTrial;
+		}
+
+		for ( size_t bucket = 0; bucket < result.errorHistogram.size(); ++bucket )
+		{
+			result.errorHistogram[bucket] += tally.errorHistogram[bucket];
+		}
+	}
+
+	result.trials = run.trials;
+	result.sampleCount = samplesPerTrial * run.trials;
+	result.yield = 1.0 - double( result.failedTrials ) / run.trials;
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	result.samplesPerSecond = result.elapsedMs > 0.0 ? result.sampleCount / (result.elapsedMs * 0.001) : 0.0;
+	return result;
+}
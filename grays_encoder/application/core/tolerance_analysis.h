@@ -0,0 +1,147 @@
+/*------------------------------------------------------------------------------
+	()      File:   tolerance_analysis.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Monte Carlo manufacturing tolerance analysis for encoder discs.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "application/core/sensor_simulator.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// DiscTrack
+//	One printed ring, marks[s] != 0 where sector s is dark.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct DiscTrack
+{
+	double innerRadius = 0.0;
+	double outerRadius = 0.0;
+	std::vector<uint8_t> marks;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// DiscLayout
+//	Analytic description of an encoder disc and its sensor, in disc units.
+//	Tracks are sorted from the centre outwards and share one sector count.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct DiscLayout
+{
+	std::vector<DiscTrack> tracks;
+	std::vector<SensorHead> heads;
+	std::vector<unsigned int> codes;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ToleranceModel
+//	Standard deviations of the manufacturing errors. Disc and mounting errors
+//	are drawn once per trial, head jitter once per head per sample.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct ToleranceModel
+{
+	// Offset of the printed centre from the rotation axis.
+	double eccentricitySigma = 0.0;
+	// Relative print scale error, 0.01 is 1%.
+	double radiusScaleSigma = 0.0;
+	// Growth of the dark marks at every edge, negative erodes them.
+	double bleedMean = 0.0;
+	double bleedSigma = 0.0;
+	// Radial mounting error of the sensor.
+	double sensorRadialSigma = 0.0;
+	// Angular noise on each head reading.
+	double headJitterSigmaDeg = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ToleranceRun
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct ToleranceRun
+{
+	uint32_t trials = 1000;
+	uint32_t samplesPerSector = 4;
+	// Trial i always draws from the same stream, whatever the thread count.
+	uint64_t seed = 1;
+	uint32_t threads = 0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ToleranceResult
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct ToleranceResult
+{
+	static constexpr uint32_t NoTrial = UINT32_MAX;
+
+	uint32_t trials = 0;
+	uint64_t sampleCount = 0;
+
+	uint64_t exact = 0;
+	uint64_t boundary = 0;
+	uint64_t failures = 0;
+	uint64_t invalidReadings = 0;
+
+	// Discs with at least one failure, and the yield that leaves.
+	uint32_t failedTrials = 0;
+	double yield = 0.0;
+
+	uint32_t worstTrial = NoTrial;
+	uint64_t worstTrialFailures = 0;
+	double maxErrorDeg = 0.0;
+
+	// Decoded error in whole sectors, the last bucket collects everything larger.
+	std::array<uint64_t, 8> errorHistogram = {};
+
+	uint32_t threadsUsed = 0;
+	double elapsedMs = 0.0;
+	double samplesPerSecond = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ToleranceAnalyzer
+//	Monte Carlo run over perturbed discs. Each trial draws a disc and a sensor
+//	mounting, then reads every position through the analytic layout, so no
+//	rendering is involved and trials run in parallel.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class ToleranceAnalyzer
+{
+public:
+	static ToleranceResult Run( const DiscLayout& layout, const ToleranceModel& model, const ToleranceRun& run );
+};
@@ -0,0 +1,255 @@
+/*------------------------------------------------------------------------------
+	()      File:   golden_harness.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Renders the configuration matrix and diffs it against stored goldens.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include "application/golden_harness.h"
+#include "application/grays_encoder.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	// BMP is the one lossless format blend2d can both encode and decode.
+	//------------------------------------------------------------------------------
+	bool WriteBmp( BLImage& image, const std::filesystem::path& path )
+	{
+		BLImageCodec codec;
+		if ( codec.findByName( "BMP" ) != BL_SUCCESS )
+		{
+			return false;
+		}
+
+		return image.writeToFile( path.string().c_str(), codec ) == BL_SUCCESS;
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// GoldenHarness
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::vector<GoldenCase> GoldenHarness::GetDefaultMatrix()
+{
+	std::vector<GoldenCase> cases;
+
+	for ( const uint8_t n : { 1, 4, 8, 12 } )
+	{
+		cases.push_back( { "reflected_n" + std::to_string( n ), [n]( GraysEncoder& grays )
+		{
+			grays.SetGrayNumber( n );
+		} } );
+	}
+
+	cases.push_back( { "reflected_n6_inverted", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 6 );
+		grays.SetInvert( true );
+	} } );
+
+	cases.push_back( { "reflected_n8_wide", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 8 );
+		grays.SetInnerRadius( 40.0 );
+		grays.SetOuterRadius( 240.0 );
+	} } );
+
+	cases.push_back( { "balanced_n5", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 5 );
+		grays.SetCodeFamily( CodeFamilyType::Balanced );
+	} } );
+
+	cases.push_back( { "maxrun_n5", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 5 );
+		grays.SetCodeFamily( CodeFamilyType::MaxRunLength );
+	} } );
+
+	cases.push_back( { "singletrack_n5", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 5 );
+		grays.SetCodeFamily( CodeFamilyType::SingleTrack );
+	} } );
+
+	cases.push_back( { "incremental_n6_index", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 6 );
+		grays.SetIncrementalLines( 64 );
+		grays.SetIndexTrack( true );
+	} } );
+
+	cases.push_back( { "incremental_n6_phase45", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 6 );
+		grays.SetIncrementalLines( 100 );
+		grays.SetQuadraturePhase( 45.0 );
+		grays.SetIndexTrack( false );
+	} } );
+
+	cases.push_back( { "linear_n6", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 6 );
+		grays.SetLayout( EncoderLayout::Linear );
+	} } );
+
+	cases.push_back( { "linear_n8_incremental", []( GraysEncoder& grays )
+	{
+		grays.SetGrayNumber( 8 );
+		grays.SetLayout( EncoderLayout::Linear );
+		grays.SetIncrementalLines( 128 );
+	} } );
+
+	return cases;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+GoldenRunResult GoldenHarness::Run( const GoldenOptions& options )
+{
+	return Run( options, GetDefaultMatrix() );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+GoldenRunResult GoldenHarness::Run( const GoldenOptions& options, const std::vector<GoldenCase>& cases )
+{
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start = clock::now();
+
+	GoldenRunResult result;
+
+	std::error_code ec;
+	std::filesystem::create_directories( options.directory, ec );
+
+	for ( const GoldenCase& goldenCase : cases )
+	{
+		GoldenCaseResult& caseResult = result.cases.emplace_back();
+		caseResult.name = goldenCase.name;
+
+		const clock::time_point renderStart = clock::now();
+
+		GraysEncoder grays;
+		goldenCase.configure( grays );
+		BLImage actual = grays.RenderImage( options.pixelsPerUnit, options.threads );
+
+		caseResult.renderMs = std::chrono::duration<double, std::milli>( clock::now() - renderStart ).count();
+
+		const std::filesystem::path goldenPath = options.directory / (goldenCase.name + ".bmp");
+		const std::filesystem::path actualPath = options.directory / (goldenCase.name + ".actual.bmp");
+
+		if ( options.update )
+		{
+			caseResult.updated = true;
+			caseResult.written = WriteBmp( actual, goldenPath );
+			caseResult.passed = caseResult.written;
+			std::filesystem::remove( actualPath, ec );
+		}
+		else
+		{
+			//goldens are uncompressed, readFromFile maps them and the decoder reads them in place.
+			BLImage golden;
+			caseResult.missing = golden.readFromFile( goldenPath.string().c_str() ) != BL_SUCCESS;
+
+			if ( !caseResult.missing )
+			{
+				caseResult.diff = ImageDiff::Compare( actual, golden, options.tolerance, options.threads );
+				caseResult.passed = caseResult.diff.comparable && caseResult.diff.changedPixels <= options.maxChangedPixels;
+			}
+
+			if ( caseResult.passed )
+			{
+				std::filesystem::remove( actualPath, ec );
+			}
+			else
+			{
+				caseResult.written = WriteBmp( actual, actualPath );
+			}
+		}
+
+		if ( !caseResult.passed )
+		{
+			++result.failures;
+		}
+	}
+
+	result.passed = result.failures == 0;
+	result.elapsedMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string GoldenHarness::FormatReport( const GoldenRunResult& result )
+{
+	std::string report;
+	char line[256];
+
+	for ( const GoldenCaseResult& caseResult : result.cases )
+	{
+		const ImageDiffResult& diff = caseResult.diff;
+
+		if ( caseResult.missing )
+		{
+			snprintf( line, sizeof( line ), "MISSING %-28s no golden image\n", caseResult.name.c_str() );
+		}
+		else if ( caseResult.updated )
+		{
+			snprintf( line, sizeof( line ), "%-7s %-28s %s\n", caseResult.passed ? "WROTE" : "FAIL", caseResult.name.c_str(), caseResult.passed ? "golden updated" : "could not write golden" );
+		}
+		else if ( !diff.comparable )
+		{
+			snprintf( line, sizeof( line ), "FAIL    %-28s image size changed\n", caseResult.name.c_str() );
+		}
+		else
+		{
+			snprintf( line, sizeof( line ), "%-7s %-28s %llu/%llu changed, max delta %u, bounds [%d,%d]-[%d,%d], %.1f ms render, %.2f ms diff\n",
+				caseResult.passed ? "PASS" : "FAIL",
+				caseResult.name.c_str(),
+				static_cast<unsigned long long>( diff.changedPixels ),
+				static_cast<unsigned long long>( diff.pixelCount ),
+				diff.maxDelta,
+				diff.bounds.x0, diff.bounds.y0, diff.bounds.x1, diff.bounds.y1,
+				caseResult.renderMs,
+				diff.elapsedMs );
+		}
+
+		report += line;
+	}
+
+	snprintf( line, sizeof( line ), "%zu cases, %u failed, %.1f ms\n", result.cases.size(), result.failures, result.elapsedMs );
+	report += line;
+	return report;
+}
@@ -0,0 +1,113 @@
+/*------------------------------------------------------------------------------
+	()      File:   golden_harness.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Headless golden image regression runs over encoder configurations.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+#include "application/core/image_diff.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// Forwards
+//------------------------------------------------------------------------------
+class GraysEncoder;
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// GoldenCase
+//	One encoder configuration, applied to a default constructed GraysEncoder.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct GoldenCase
+{
+	std::string name;
+	std::function<void( GraysEncoder& )> configure;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct GoldenOptions
+{
+	std::filesystem::path directory;
+	// Rewrite every golden from the current renderer instead of comparing.
+	bool update = false;
+	// Per channel difference still treated as equal, covers anti-aliasing drift.
+	uint8_t tolerance = 8;
+	// Changed pixels allowed before a case fails.
+	uint64_t maxChangedPixels = 0;
+	double pixelsPerUnit = 1.0;
+	uint32_t threads = 0;	// 0 = one per core.
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct GoldenCaseResult
+{
+	std::string name;
+	bool passed = false;
+	bool missing = false;	// No golden on disk, the render is saved next to where it would be.
+	bool updated = false;	// Run in update mode, passed means the golden was rewritten.
+	bool written = false;
+	ImageDiffResult diff;
+	double renderMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct GoldenRunResult
+{
+	bool passed = false;
+	uint32_t failures = 0;
+	std::vector<GoldenCaseResult> cases;
+	double elapsedMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// GoldenHarness
+//	Renders a matrix of encoder configurations headlessly and compares each
+//	against <directory>/<name>.bmp. Failing renders are written alongside as
+//	<name>.actual.bmp so they can be inspected or promoted to the new golden.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class GoldenHarness
+{
+public:
+	static std::vector<GoldenCase> GetDefaultMatrix();
+
+	static GoldenRunResult Run( const GoldenOptions& options );
+	static GoldenRunResult Run( const GoldenOptions& options, const std::vector<GoldenCase>& cases );
+
+	// One line per case, then a summary line.
+	static std::string FormatReport( const GoldenRunResult& result );
+};
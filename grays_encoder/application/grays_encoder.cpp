@@ -35,11 +35,27 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <QVariant>
 #include <qevent.h>
 #include <algorithm> 
+#include <cassert>
+#include <cmath>
 #include "application/grays_encoder.h"
+#include "utility/frame_profiler.h"
 #include "utility/globals.h"
+#include "utility/parallel_for.h"
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
+namespace
+{
+	//------------------------------------------------------------------------------
+	// Stroke cache shapes, keyed by the arguments they are built from.
+	//------------------------------------------------------------------------------
+	enum StrokeShape : uint32_t
+	{
+		ArcSegmentShape,
+		CircleShape,
+	};
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 // GraysEncoder
@@ -63,6 +79,30 @@ void GraysEncoder::DrawArcSegment(
 	float startAngleDeg, 
 	float arcAngleDeg 
 )
+{
+	if ( FrameProfiler* profiler = m_renderAction.profiler )
+	{
+		profiler->AddCount( FrameCounter::Arcs );
+		profiler->AddCount( FrameCounter::Commands, 2 );
+	}
+
+	static double val = 0.2f;
+	ctx.setStrokeWidth( val );
+
+	//the same segments come back every frame, a hit skips building the path and stroking it.
+	const StrokeCache::Key key = { ArcSegmentShape, { radius, width, startAngleDeg, arcAngleDeg } };
+	const StrokedPath segment = m_strokeCache.Get( ctx, key, [&]( BLPath& path )
+	{
+		BuildArcSegment( path, radius, width, startAngleDeg, arcAngleDeg );
+	} );
+
+	ctx.fillPath( segment.path );
+	m_strokeCache.Stroke( ctx, segment );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::BuildArcSegment( BLPath& path, float radius, float width, float startAngleDeg, float arcAngleDeg )
 {
 	BLPoint centre = { 0, 0 };
 
@@ -90,38 +130,125 @@ void GraysEncoder::DrawArcSegment(
 		centre.x + (cos( angleBEGIN ) * outerRadius.x),
 		centre.y + (sin( angleBEGIN ) * outerRadius.x) };
 
-	BLPath path;
-
 	path.moveTo( p1 );
 	path.arcTo( centre, innerRadius, angleBEGIN, arcLength );
 	path.lineTo( p3 );
 	path.arcTo( centre, outerRadius, angleEND, -arcLength );
 	path.lineTo( p1 );
+}
 
-	ctx.fillPath( path );
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::StrokeCircle( BLContext& ctx, double x, double y, double radius )
+{
+	const StrokeCache::Key key = { CircleShape, { x, y, radius } };
+	const StrokedPath circle = m_strokeCache.Get( ctx, key, [&]( BLPath& path )
+	{
+		path.addCircle( BLCircle( x, y, radius ) );
+	} );
 
-	static double val = 0.2f;
-	ctx.setStrokeWidth( val );
-	ctx.strokePath( path );
+	m_strokeCache.Stroke( ctx, circle );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<class SampleFn>
+void GraysEncoder::DrawTrack( BLContext& ctx, double radius, double width, uint32_t segmentCount, SampleFn sample, double phaseDeg /*= 0.0*/ )
+{
+	ForEachArcSpan( segmentCount, sample, phaseDeg, [&]( double beginAngle, double sweepAngle )
+	{
+		DrawArcSegment( ctx, radius, width, beginAngle, sweepAngle );
+	} );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+template<class SampleFn, class SpanFn>
+void GraysEncoder::ForEachArcSpan( uint32_t segmentCount, SampleFn sample, double phaseDeg, SpanFn span )
+{
+	const double stepAngle = 360.0f / segmentCount;
+
+	uint32_t numericWrap = 0;
+	uint32_t firstDrawn = UINT32_MAX;
+	uint32_t drawStart = UINT32_MAX;
+	uint32_t drawEnd = UINT32_MAX;
+
+	//draw arcs, go until we wrap back onto our first drawn arc.
+	for( uint32_t sectorThis = 0; ; sectorThis++ )
+	{
+		if( sectorThis >= segmentCount )
+		{
+			numericWrap++;
+			sectorThis = 0;
+			assert( numericWrap < 2 );
+		}
+
+		//we've wrapped.
+		if( sectorThis == firstDrawn )
+		{
+			break;
+		}
+
+		const uint32_t sectorLast = std::min( sectorThis - 1u, segmentCount - 1u );
+
+		const bool lastValue = sample( sectorLast );
+		const bool thisValue = sample( sectorThis );
+
+		if( lastValue == false && thisValue == true )
+		{
+			drawStart = sectorThis;
+		}
+		else if( drawStart != UINT32_MAX && thisValue == false )
+		{
+			drawEnd = sectorThis;
+		}
+
+		if( drawStart != UINT32_MAX && drawEnd != UINT32_MAX )
+		{
+			if( firstDrawn == UINT32_MAX )
+			{
+				firstDrawn = drawStart;
+			}
+
+			//runs can wrap through sector 0, so measure the sweep forwards from the start.
+			const double beginAngle = drawStart * stepAngle + phaseDeg;
+			const double sweepAngle = ((drawEnd + segmentCount - drawStart) % segmentCount) * stepAngle;
+
+			span( beginAngle, sweepAngle );
+			drawStart = UINT32_MAX;
+			drawEnd = UINT32_MAX;
+		}
+	}
 }
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 void GraysEncoder::Render( BLContext& ctx )
 {
+	FrameProfiler* profiler = m_renderAction.profiler;
+
 	if ( m_bits.empty() )
 	{
+		ScopedStageTimer generateTimer( profiler, FrameStage::Generate );
 		Generate();
 	}
 
+	ScopedStageTimer buildTimer( profiler, FrameStage::Build );
+
 	//Render Options
 	static int test = BL_COMP_OP_SRC_OVER;// BL_COMP_OP_PLUS;
 
 	ctx.setCompOp( test /*BL_COMP_OP_SRC_OVER*/ );
 
+	if ( m_layout == EncoderLayout::Linear )
+	{
+		RenderLinear( ctx, -HUGE_VAL, HUGE_VAL );
+		return;
+	}
+
 	//Draw background under the encoder ring
 	//BLRgba32 backColour = BLRgba32( 0xFF000000 );
-	BLRgba32 backColour = BLRgba32( 0xFFFFFFFF );
+	BLRgba32 backColour = Monochrome::GetPaperColour( ctx );
 
 
 	ctx.setFillStyle( backColour );
@@ -135,73 +262,20 @@ void GraysEncoder::Render( BLContext& ctx )
 	ctx.setFillStyle( foreColour );
 	ctx.setStrokeStyle( foreColour );
 
-	const int segmentCount = pow( 2, m_nFactor );
+	const uint32_t segmentCount = static_cast<uint32_t>( m_bits.size() );
 	const double stepAngle = 360.0f / segmentCount;
 	const double radDifference = m_outerRadius - m_innerRadius;
-	const double trackWidth = radDifference / m_nFactor;
 	double beginAngle = 0;
 
 	int lastTrack = m_invertTree? m_nFactor-1 : 0;
 
 	//draw each track concentrically.
-	for( int track = 0; track < m_nFactor; ++track )
+	ForEachCodeTrack( [&]( double radius, double width, uint32_t trackSegments, auto sample )
 	{
-		uint32_t numericWrap = 0;
-		uint32_t firstDrawn = UINT32_MAX;
-		uint32_t drawStart = UINT32_MAX;
-		uint32_t drawEnd = UINT32_MAX;
-
-		const double localRadius = m_invertTree
-			? m_innerRadius + (trackWidth * track)
-			: m_outerRadius - (trackWidth * (track + 1))
-			;
-
-		//draw arcs, go until we wrap back onto our first drawn arc.
-		for( uint32_t sectorThis = 0; ; sectorThis++ )
-		{
- 			if( sectorThis >= segmentCount )
-			{
-				numericWrap++;
-				sectorThis = 0;
-				assert( numericWrap < 2 );
-			}
-
-			//we've wrapped.
-			if( sectorThis == firstDrawn )
-			{
-				break;
-			}
-
-			const uint32_t sectorLast = std::min( sectorThis - 1u, segmentCount - 1u );
+		DrawTrack( ctx, radius, width, trackSegments, sample );
+	} );
 
-			const bool lastValue = (m_bits[sectorLast] & (0x1 << track)) != 0;
-			const bool thisValue = (m_bits[sectorThis] & (0x1 << track)) != 0;
-
-			if( lastValue == false && thisValue == true )
-			{
-				drawStart = sectorThis;
-			}
-			else if( drawStart != UINT32_MAX && thisValue == false )
-			{
-				drawEnd = sectorThis;
-			}
-	
-			if( drawStart != UINT32_MAX && drawEnd != UINT32_MAX )
-			{
-				if( firstDrawn == UINT32_MAX )
-				{
-					firstDrawn = drawStart;
-				}
-
-				const double beginAngle = drawStart * stepAngle;
-				const double endAngle = drawEnd * stepAngle;
-
-				DrawArcSegment( ctx, localRadius, trackWidth, beginAngle, fabs( endAngle - beginAngle ) );
-				drawStart = UINT32_MAX;
-				drawEnd = UINT32_MAX;
-			}
-		}
-	}
+	DrawIncrementalTracks( ctx );
 
 	//------------------------------------------------------
 	//Instrumentation Passes
@@ -216,13 +290,20 @@ void GraysEncoder::Render( BLContext& ctx )
 	ctx.setStrokeWidth( 1 );
 
 	//Render concentric circles. (render helper lines around each track.)
-	for( int track = 0; track <= m_nFactor; ++track )
+	const int helperTracks = IsSingleTrackLayout() ? 1 : m_nFactor;
+	for( int track = 0; track <= helperTracks; ++track )
+	{
+		double localRadius = m_innerRadius + ((radDifference / helperTracks) * track);
+
+		StrokeCircle( ctx, 0, 0, localRadius );
+	}
+
+	for( int track = 0; track < GetIncrementalTrackCount(); ++track )
 	{
-		double radDifference = m_outerRadius - m_innerRadius;
-		double trackWidth = radDifference / m_nFactor;
-		double localRadius = m_innerRadius + (trackWidth * track);
+		const double localRadius = GetIncrementalTrackRadius( track );
 
-		ctx.strokeCircle( 0, 0, localRadius );
+		StrokeCircle( ctx, 0, 0, localRadius );
+		StrokeCircle( ctx, 0, 0, localRadius + m_incrementalWidth );
 	}
 
 	// Radials. Render segmenting from the inner radius to the outer radius
@@ -242,100 +323,878 @@ void GraysEncoder::Render( BLContext& ctx )
 		ctx.strokeLine( { begX, begY }, { endX, endY } );
 		beginAngle = endAngle;
 	};	
-}
 
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-void GraysEncoder::Grays( int n )
-{
-	if ( n <= m_nFactor )
+	// Head positions. At rotation 0 head h sits over the middle of sector headOffsets[h].
+	if( IsSingleTrackLayout() )
 	{
-		int iterateCount = pow( 2, n );
-		int newElements = iterateCount / 2;
+		ctx.setStrokeStyle( BLRgba32( 0xFF0000FF ) );
+		ctx.setStrokeWidth( 2 );
 
-		int originals = newElements - 1;
-		for ( int element = newElements; element < iterateCount; ++element, --originals )
+		const double markerLength = radDifference * 0.25;
+		for( const uint32_t offset : m_codeInfo.headOffsets )
 		{
-			unsigned int newElement = m_bits[originals] | 0x1 << (n - 1);
-			m_bits[element] = newElement;
-		}
+			const double headAngRad = DegToRad( (offset + 0.5) * stepAngle );
+			const BLPoint direction = { cos( headAngRad ), sin( headAngRad ) };
 
-		Grays( ++n );
+			const BLPoint begin = direction * (m_outerRadius + markerLength * 0.5);
+			const BLPoint end = direction * (m_outerRadius + markerLength * 1.5);
+
+			ctx.strokeLine( begin, end );
+			StrokeCircle( ctx, end.x, end.y, markerLength * 0.25 );
+		}
 	}
 }
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-void GraysEncoder::Generate()
+void GraysEncoder::ExtractArcSpans( const ArcSpanFn& fn )
 {
-	unsigned int size = pow( 2, m_nFactor );
-	m_bits.reserve( size );
-	for ( int i = 0; i < size; i++ )
+	if ( m_bits.empty() )
 	{
-		m_bits.push_back( 0 );
+		Generate();
 	}
 
-	m_bits[1] = 1;
-	Grays( 2 );
+	ForEachCodeTrack( [&]( double radius, double width, uint32_t trackSegments, auto sample )
+	{
+		ForEachArcSpan( trackSegments, sample, 0.0, [&]( double beginAngle, double sweepAngle )
+		{
+			fn( radius, width, beginAngle, sweepAngle );
+		} );
+	} );
 }
 
 //------------------------------------------------------------------------------
-// Actions
+// Calls track( radius, width, segmentCount, sample ) for each absolute track.
 //------------------------------------------------------------------------------
+template<class TrackFn>
+void GraysEncoder::ForEachCodeTrack( TrackFn track )
+{
+	const uint32_t segmentCount = static_cast<uint32_t>( m_bits.size() );
+	const double radDifference = m_outerRadius - m_innerRadius;
+	const double trackWidth = radDifference / m_nFactor;
+
+	if( IsSingleTrackLayout() )
+	{
+		//one ring across the whole band, the heads pick out the bits.
+		const std::vector<uint8_t>& ring = m_codeInfo.ring;
+		track( m_innerRadius, radDifference, segmentCount, [&ring]( uint32_t sector ) { return ring[sector] != 0; } );
+		return;
+	}
+
+	for( int bit = 0; bit < m_nFactor; ++bit )
+	{
+		const double localRadius = m_invertTree
+			? m_innerRadius + (trackWidth * bit)
+			: m_outerRadius - (trackWidth * (bit + 1))
+			;
+
+		const unsigned int mask = 0x1 << bit;
+		track( localRadius, trackWidth, segmentCount, [this, mask]( uint32_t sector ) { return (m_bits[sector] & mask) != 0; } );
+	}
+}
 
 //------------------------------------------------------------------------------
+// Quadrature A/B and the optional index, outside the absolute tracks.
 //------------------------------------------------------------------------------
-actions::RenderAction& GraysEncoder::GetRenderAction()
+void GraysEncoder::DrawIncrementalTracks( BLContext& ctx )
 {
-	return m_renderAction;
+	if ( m_incrementalLines == 0 )
+	{
+		return;
+	}
+
+	//each line is one dark and one light sector.
+	const uint32_t segmentCount = m_incrementalLines * 2;
+
+	//electrical degrees, 360 is one full line.
+	const double phaseDeg = m_quadraturePhaseDeg / m_incrementalLines;
+
+	const auto lineA = []( uint32_t sector ) { return (sector & 1) == 0; };
+	DrawTrack( ctx, GetIncrementalTrackRadius( 0 ), m_incrementalWidth, segmentCount, lineA );
+	DrawTrack( ctx, GetIncrementalTrackRadius( 1 ), m_incrementalWidth, segmentCount, lineA, phaseDeg );
+
+	//one mark per turn, aligned with the first A line.
+	if ( m_indexTrack )
+	{
+		DrawTrack( ctx, GetIncrementalTrackRadius( 2 ), m_incrementalWidth, segmentCount, []( uint32_t sector ) { return sector == 0; } );
+	}
 }
 
 //------------------------------------------------------------------------------
-// Config Changed
+// Appends one box per run of set cells that overlaps [beginX, endX). Cell i
+// spans left + i * cellWidth to left + (i + 1) * cellWidth.
 //------------------------------------------------------------------------------
+template<class SampleFn>
+void GraysEncoder::CollectRuns( std::vector<BLBox>& boxes, double left, double cellWidth, uint32_t cellCount, double top, double bottom, double beginX, double endX, SampleFn sample )
+{
+	const double firstCell = std::floor( (beginX - left) / cellWidth );
+	const double lastCell = std::ceil( (endX - left) / cellWidth );
+
+	const uint32_t first = static_cast<uint32_t>( std::clamp( firstCell, 0.0, double( cellCount ) ) );
+	const uint32_t last = static_cast<uint32_t>( std::clamp( lastCell, 0.0, double( cellCount ) ) );
+
+	uint32_t runStart = UINT32_MAX;
+	for ( uint32_t cell = first; cell <= last; ++cell )
+	{
+		const bool set = cell < last && sample( cell );
+
+		if ( set && runStart == UINT32_MAX )
+		{
+			runStart = cell;
+		}
+		else if ( !set && runStart != UINT32_MAX )
+		{
+			boxes.push_back( BLBox( left + runStart * cellWidth, top, left + cell * cellWidth, bottom ) );
+			runStart = UINT32_MAX;
+		}
+	}
+}
 
 //------------------------------------------------------------------------------
+// Linear strip, sectors run along x and tracks down y, centred on the origin.
+// Only the part of the strip between beginX and endX is emitted so long
+// strips can be drawn a tile at a time.
 //------------------------------------------------------------------------------
-void GraysEncoder::SetGrayNumber( const uint8_t n )
+void GraysEncoder::RenderLinear( BLContext& ctx, double beginX, double endX )
 {
-	if ( n != m_nFactor )
+	const uint32_t segmentCount = static_cast<uint32_t>( m_bits.size() );
+	const double cellWidth = m_linearLength / segmentCount;
+	const double left = -m_linearLength * 0.5;
+	const double top = -m_linearHeight * 0.5;
+	const double visibleBegin = std::max( beginX, left );
+	const double visibleEnd = std::min( endX, -left );
+
+	if ( visibleEnd <= visibleBegin )
 	{
-		m_nFactor = n;
+		return;
+	}
 
-		m_bits.clear();
-		Generate();
+	ctx.setFillStyle( Monochrome::GetPaperColour( ctx ) );
+	ctx.fillRect( visibleBegin, top, visibleEnd - visibleBegin, GetLinearHeight() );
+
+	//every track's runs go out in one box array fill.
+	std::vector<BLBox> boxes;
+
+	if ( IsSingleTrackLayout() )
+	{
+		const std::vector<uint8_t>& ring = m_codeInfo.ring;
+		CollectRuns( boxes, left, cellWidth, segmentCount, top, top + m_linearHeight, beginX, endX, [&ring]( uint32_t cell ) { return ring[cell] != 0; } );
+	}
+	else
+	{
+		const double trackHeight = m_linearHeight / m_nFactor;
+
+		for ( int track = 0; track < m_nFactor; ++track )
+		{
+			const double localTop = m_invertTree
+				? top + (trackHeight * track)
+				: top + m_linearHeight - (trackHeight * (track + 1))
+				;
+
+			const unsigned int mask = 0x1 << track;
+			CollectRuns( boxes, left, cellWidth, segmentCount, localTop, localTop + trackHeight, beginX, endX, [this, mask]( uint32_t cell ) { return (m_bits[cell] & mask) != 0; } );
+		}
+	}
+
+	if ( m_incrementalLines != 0 )
+	{
+		const uint32_t cellCount = m_incrementalLines * 2;
+		const double lineWidth = m_linearLength / cellCount;
+		const double phase = std::fmod( m_quadraturePhaseDeg / 360.0, 1.0 ) * (lineWidth * 2);
+		const auto lineA = []( uint32_t cell ) { return (cell & 1) == 0; };
+		const size_t firstIncremental = boxes.size();
+
+		for ( int track = 0; track < GetIncrementalTrackCount(); ++track )
+		{
+			const double localTop = top + GetIncrementalTrackRadius( track ) - m_outerRadius + m_linearHeight;
+			const double localBottom = localTop + m_incrementalWidth;
+
+			if ( track == 2 )
+			{
+				CollectRuns( boxes, left, lineWidth, cellCount, localTop, localBottom, beginX, endX, []( uint32_t cell ) { return cell == 0; } );
+			}
+			else if ( track == 1 )
+			{
+				//start one line early so the shifted pattern still covers the left edge.
+				CollectRuns( boxes, left + phase - (lineWidth * 2), lineWidth, cellCount + 2, localTop, localBottom, beginX, endX, lineA );
+			}
+			else
+			{
+				CollectRuns( boxes, left, lineWidth, cellCount, localTop, localBottom, beginX, endX, lineA );
+			}
+		}
+
+		//the shifted B track runs past both ends of the strip.
+		for ( size_t box = firstIncremental; box < boxes.size(); ++box )
+		{
+			boxes[box].x0 = std::max( boxes[box].x0, left );
+			boxes[box].x1 = std::min( boxes[box].x1, -left );
+		}
+	}
+
+	ctx.setFillStyle( BLRgba32( 0xFF000000 ) );
+	ctx.fillBoxArray( boxes.data(), boxes.size() );
+
+	//the paper and the runs, each box stands in for an arc.
+	if ( FrameProfiler* profiler = m_renderAction.profiler )
+	{
+		profiler->AddCount( FrameCounter::Arcs, boxes.size() );
+		profiler->AddCount( FrameCounter::Commands, 2 );
+	}
+
+	//------------------------------------------------------
+	//Instrumentation Passes
+	//------------------------------------------------------
+	if( !m_drawInstrumentation )
+	{
+		return;
+	}
+
+	ctx.setStrokeStyle( BLRgba32( 0xFFFF0000 ) );
+	ctx.setStrokeWidth( 1 );
+
+	const int helperTracks = IsSingleTrackLayout() ? 1 : m_nFactor;
+	for( int track = 0; track <= helperTracks; ++track )
+	{
+		const double y = top + (m_linearHeight / helperTracks) * track;
+		ctx.strokeLine( visibleBegin, y, visibleEnd, y );
+	}
+
+	const uint32_t firstLine = static_cast<uint32_t>( std::clamp( std::ceil( (visibleBegin - left) / cellWidth ), 0.0, double( segmentCount ) ) );
+	const uint32_t lastLine = static_cast<uint32_t>( std::clamp( std::floor( (visibleEnd - left) / cellWidth ), 0.0, double( segmentCount ) ) );
+	for( uint32_t line = firstLine; line <= lastLine; ++line )
+	{
+		const double x = left + line * cellWidth;
+		ctx.strokeLine( x, top, x, top + m_linearHeight );
 	}
 }
 
 //------------------------------------------------------------------------------
+// Streams the linear strip as vertical tiles, so the whole strip never has to
+// be in memory at once. Stops early if the sink returns false.
 //------------------------------------------------------------------------------
-void GraysEncoder::SetInnerRadius( const double rad )
+bool GraysEncoder::RenderLinearStrip( double pixelsPerUnit, uint32_t tileWidth, const TileSink& sink )
 {
-	m_innerRadius = rad;
+	if ( m_bits.empty() )
+	{
+		Generate();
+	}
 
-	if ( m_innerRadius > m_outerRadius - 1 )
+	const uint32_t stripWidth = static_cast<uint32_t>( std::ceil( m_linearLength * pixelsPerUnit ) );
+	const uint32_t stripHeight = static_cast<uint32_t>( std::ceil( GetLinearHeight() * pixelsPerUnit ) );
+	if ( stripWidth == 0 || stripHeight == 0 || tileWidth == 0 )
 	{
-		m_innerRadius = m_outerRadius - 1;
+		return false;
+	}
+
+	BLImage tile( static_cast<int>( std::min( tileWidth, stripWidth ) ), static_cast<int>( stripHeight ), BL_FORMAT_PRGB32 );
+
+	BLContextCreateInfo createInfo{};
+	createInfo.threadCount = parallel::HardwareThreadCount();
+
+	//tiles are print output, no overlays.
+	const EncoderLayout layout = m_layout;
+	const bool drawInstrumentation = m_drawInstrumentation;
+	m_layout = EncoderLayout::Linear;
+	m_drawInstrumentation = false;
+
+	bool completed = true;
+	for ( uint32_t x = 0; x < stripWidth && completed; x += tileWidth )
+	{
+		const uint32_t width = std::min( tileWidth, stripWidth - x );
+
+		BLContext ctx( tile, createInfo );
+		ctx.setFillStyle( BLRgba32( 0xFFFFFFFF ) );
+		ctx.fillAll();
+
+		//strip left edge at pixel 0, top edge at pixel 0.
+		ctx.translate( m_linearLength * 0.5 * pixelsPerUnit - x, m_linearHeight * 0.5 * pixelsPerUnit );
+		ctx.scale( pixelsPerUnit );
+
+		const double left = -m_linearLength * 0.5;
+		RenderLinear( ctx, left + x / pixelsPerUnit, left + (x + width) / pixelsPerUnit );
+		ctx.end();
+
+		completed = sink( tile, x, 0, width, stripHeight );
 	}
+
+	m_layout = layout;
+	m_drawInstrumentation = drawInstrumentation;
+	return completed;
 }
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-void GraysEncoder::SetOuterRadius( const double rad )
+double GraysEncoder::GetLinearHeight() const
 {
-	m_outerRadius = rad;
+	const int incrementalTracks = GetIncrementalTrackCount();
+	return incrementalTracks == 0
+		? m_linearHeight
+		: GetIncrementalTrackRadius( incrementalTracks - 1 ) - m_outerRadius + m_linearHeight + m_incrementalWidth;
+}
 
-	if ( m_outerRadius < m_innerRadius + 1 )
-	{
-		m_outerRadius = m_innerRadius + 1;
-	}
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+int GraysEncoder::GetIncrementalTrackCount() const
+{
+	return m_incrementalLines == 0 ? 0 : (m_indexTrack ? 3 : 2);
 }
 
 //------------------------------------------------------------------------------
+// Inner radius of incremental track i, a quarter width gap before each one.
 //------------------------------------------------------------------------------
-void GraysEncoder::SetInvert( const bool val )
+double GraysEncoder::GetIncrementalTrackRadius( int track ) const
 {
-	m_invertTree = val;
+	return m_outerRadius + m_incrementalWidth * (0.25 + 1.25 * track);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+double GraysEncoder::GetOuterExtent() const
+{
+	const int incrementalTracks = GetIncrementalTrackCount();
+	return incrementalTracks == 0 ? m_outerRadius : GetIncrementalTrackRadius( incrementalTracks - 1 ) + m_incrementalWidth;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::Grays( int n )
+{
+	if ( n <= m_nFactor )
+	{
+		int iterateCount = pow( 2, n );
+		int newElements = iterateCount / 2;
+
+		int originals = newElements - 1;
+		for ( int element = newElements; element < iterateCount; ++element, --originals )
+		{
+			unsigned int newElement = m_bits[originals] | 0x1 << (n - 1);
+			m_bits[element] = newElement;
+		}
+
+		Grays( ++n );
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::Generate()
+{
+	//outlines of the previous code won't be drawn again.
+	m_strokeCache.Clear();
+
+	if ( m_codeFamily != CodeFamilyType::Reflected )
+	{
+		ApplyCode( SearchCode( m_codeFamily, m_nFactor, m_singleTrackPeriod ) );
+		return;
+	}
+
+	unsigned int size = pow( 2, m_nFactor );
+	m_bits.reserve( size );
+	for ( int i = 0; i < size; i++ )
+	{
+		m_bits.push_back( 0 );
+	}
+
+	m_bits[1] = 1;
+	Grays( 2 );
+
+	m_codeInfo = GeneratedCode();
+	m_codeInfo.bitCount = m_nFactor;
+	m_codeInfo.exact = true;
+	m_codeInfo.minRunLength = CodeFamilyEngine::MeasureMinRunLength( m_bits, m_nFactor );
+
+	m_validation = CodeValidator::Validate( m_bits, m_nFactor );
+	assert( m_validation.valid );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+GeneratedCode GraysEncoder::SearchCode( CodeFamilyType family, int bitCount, uint32_t period ) const
+{
+	const uint32_t param = family == CodeFamilyType::SingleTrack ? period : 0;
+	return m_codeFamilies.Generate( family, bitCount, param );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetCode( CodeFamilyType family, int bitCount, uint32_t period, GeneratedCode code )
+{
+	m_codeFamily = family;
+	m_nFactor = bitCount;
+	m_singleTrackPeriod = period;
+
+	m_bits.clear();
+
+	//reflected codes are never searched.
+	if ( family == CodeFamilyType::Reflected )
+	{
+		Generate();
+		return;
+	}
+
+	m_strokeCache.Clear();
+	ApplyCode( std::move( code ) );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::ApplyCode( GeneratedCode code )
+{
+	m_codeInfo = std::move( code );
+	m_bits = std::move( m_codeInfo.codes );
+	m_codeInfo.codes.clear();
+
+	//single track codes are checked through the heads, as the sensor would see them.
+	if ( IsSingleTrackLayout() )
+	{
+		m_singleTrackDecoder.Build( m_codeInfo.ring, m_codeInfo.headOffsets );
+		m_validation = m_singleTrackDecoder.Validate();
+	}
+	else
+	{
+		m_validation = CodeValidator::Validate( m_bits, m_nFactor );
+	}
+
+	assert( m_validation.valid );
+}
+
+//------------------------------------------------------------------------------
+// Actions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+actions::RenderAction& GraysEncoder::GetRenderAction()
+{
+	return m_renderAction;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const CodeValidationResult& GraysEncoder::GetValidation() const
+{
+	return m_validation;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const GeneratedCode& GraysEncoder::GetCodeInfo() const
+{
+	return m_codeInfo;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::vector<SensorHead> GraysEncoder::GetSensorHeads() const
+{
+	std::vector<SensorHead> heads;
+
+	const double radDifference = m_outerRadius - m_innerRadius;
+
+	//heads sit over the middle of their track, head i reads bit i.
+	if ( IsSingleTrackLayout() )
+	{
+		const double stepAngle = 360.0 / m_bits.size();
+
+		for ( const uint32_t offset : m_codeInfo.headOffsets )
+		{
+			heads.push_back( { m_innerRadius + radDifference * 0.5, offset * stepAngle } );
+		}
+	}
+	else
+	{
+		const double trackWidth = radDifference / m_nFactor;
+
+		for ( int track = 0; track < m_nFactor; ++track )
+		{
+			const double localRadius = m_invertTree
+				? m_innerRadius + (trackWidth * track)
+				: m_outerRadius - (trackWidth * (track + 1))
+				;
+
+			heads.push_back( { localRadius + trackWidth * 0.5, 0.0 } );
+		}
+	}
+
+	return heads;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+DiscLayout GraysEncoder::GetDiscLayout()
+{
+	if ( m_bits.empty() )
+	{
+		Generate();
+	}
+
+	DiscLayout layout;
+	layout.heads = GetSensorHeads();
+	layout.codes = m_bits;
+
+	const double radDifference = m_outerRadius - m_innerRadius;
+
+	if ( IsSingleTrackLayout() )
+	{
+		layout.tracks.push_back( { m_innerRadius, m_outerRadius, m_codeInfo.ring } );
+		return layout;
+	}
+
+	//same placement as Render, then sorted from the centre out.
+	const double trackWidth = radDifference / m_nFactor;
+	for ( int track = 0; track < m_nFactor; ++track )
+	{
+		const double localRadius = m_invertTree
+			? m_innerRadius + (trackWidth * track)
+			: m_outerRadius - (trackWidth * (track + 1))
+			;
+
+		DiscTrack& disc = layout.tracks.emplace_back();
+		disc.innerRadius = localRadius;
+		disc.outerRadius = localRadius + trackWidth;
+		disc.marks.reserve( m_bits.size() );
+
+		for ( const unsigned int code : m_bits )
+		{
+			disc.marks.push_back( static_cast<uint8_t>( (code >> track) & 1 ) );
+		}
+	}
+
+	std::sort( layout.tracks.begin(), layout.tracks.end(), []( const DiscTrack& a, const DiscTrack& b ) { return a.innerRadius < b.innerRadius; } );
+	return layout;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ToleranceResult GraysEncoder::AnalyseTolerances( const ToleranceModel& model, const ToleranceRun& run )
+{
+	return ToleranceAnalyzer::Run( GetDiscLayout(), model, run );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+FirmwareTables GraysEncoder::GenerateFirmwareTables( FirmwareOptions options )
+{
+	if ( m_bits.empty() )
+	{
+		Generate();
+	}
+
+	if ( const CodeFamily* family = m_codeFamilies.GetFamily( m_codeInfo.family ) )
+	{
+		options.familyName = family->GetName();
+	}
+
+	//single track readings have one bit per head rather than per track.
+	const int readingBits = IsSingleTrackLayout() ? static_cast<int>( m_codeInfo.headOffsets.size() ) : m_nFactor;
+	return FirmwareTableGenerator::Generate( m_bits, readingBits, options );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ExportResult GraysEncoder::Export( const std::filesystem::path& path, const ExportOptions& options, const TiledExporter::ProgressFn& progress /*= nullptr*/ )
+{
+	if ( m_bits.empty() )
+	{
+		Generate();
+	}
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	const TiledExporter::DrawFn draw = GetArtworkDraw( options.pixelsPerUnit, width, height );
+
+	//exports are print output, no overlays.
+	const bool drawInstrumentation = m_drawInstrumentation;
+	m_drawInstrumentation = false;
+	const ExportResult result = TiledExporter::Export( path, width, height, options, draw, progress );
+	m_drawInstrumentation = drawInstrumentation;
+
+	return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BLImage GraysEncoder::RenderImage( double pixelsPerUnit, uint32_t threads /*= 0*/, BLApproximationQuality quality /*= BL_APPROXIMATION_QUALITY_PRODUCTION*/ )
+{
+	if ( m_bits.empty() )
+	{
+		Generate();
+	}
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	const TiledExporter::DrawFn draw = GetArtworkDraw( pixelsPerUnit, width, height );
+
+	BLImage image;
+	if ( width == 0 || height == 0 || image.create( static_cast<int>( std::min( width, 32766u ) ), static_cast<int>( std::min( height, 32766u ) ), BL_FORMAT_PRGB32 ) != BL_SUCCESS )
+	{
+		return image;
+	}
+
+	BLContextCreateInfo createInfo{};
+	createInfo.threadCount = threads == 0 ? parallel::HardwareThreadCount() : threads;
+
+	BLContext ctx( image, createInfo );
+	ctx.setApproximationQuality( quality );
+	ctx.setFillStyle( BLRgba32( 0xFFFFFFFF ) );
+	ctx.fillAll();
+
+	const bool drawInstrumentation = m_drawInstrumentation;
+	m_drawInstrumentation = false;
+	draw( ctx, BLBoxI( 0, 0, image.width(), image.height() ) );
+	m_drawInstrumentation = drawInstrumentation;
+
+	ctx.end();
+	return image;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+TiledExporter::DrawFn GraysEncoder::GetArtworkDraw( double pixelsPerUnit, uint32_t& width, uint32_t& height )
+{
+	TiledExporter::DrawFn draw;
+
+	//tiles are drawn concurrently, everything they read is fixed before the first one.
+	if ( m_layout == EncoderLayout::Linear )
+	{
+		width = static_cast<uint32_t>( std::ceil( m_linearLength * pixelsPerUnit ) );
+		height = static_cast<uint32_t>( std::ceil( GetLinearHeight() * pixelsPerUnit ) );
+
+		draw = [this, pixelsPerUnit]( BLContext& ctx, const BLBoxI& pixels )
+		{
+			ctx.translate( m_linearLength * 0.5 * pixelsPerUnit, m_linearHeight * 0.5 * pixelsPerUnit );
+			ctx.scale( pixelsPerUnit );
+
+			const double left = -m_linearLength * 0.5;
+			RenderLinear( ctx, left + pixels.x0 / pixelsPerUnit, left + pixels.x1 / pixelsPerUnit );
+		};
+	}
+	else
+	{
+		const double size = std::ceil( GetOuterExtent() * 2.0 * pixelsPerUnit ) + 2.0;
+		const double centre = size * 0.5;
+		width = height = static_cast<uint32_t>( std::min( size, double( UINT32_MAX ) ) );
+
+		draw = [this, centre, pixelsPerUnit]( BLContext& ctx, const BLBoxI& )
+		{
+			ctx.translate( centre, centre );
+			ctx.scale( pixelsPerUnit );
+			Render( ctx );
+		};
+	}
+
+	return draw;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+SensorSimulationResult GraysEncoder::SimulateSensor( SensorModel model, double pixelsPerUnit, uint32_t samplesPerSector, uint32_t threads /*= 0*/ )
+{
+	if ( m_bits.empty() )
+	{
+		Generate();
+	}
+
+	//blend2d caps images at 65535 a side, keep well inside that. Past the cap the
+	//resolution drops so the whole disc still fits, the sensor reads it in units.
+	const double maxSize = 32766.0;
+	const double diameter = GetOuterExtent() * 2.0;
+	if ( std::ceil( diameter * pixelsPerUnit ) + 2.0 > maxSize )
+	{
+		pixelsPerUnit = (maxSize - 2.0) / diameter;
+	}
+
+	const double size = std::min( std::ceil( diameter * pixelsPerUnit ) + 2.0, maxSize );
+	const double centre = size * 0.5;
+
+	BLImage image( static_cast<int>( size ), static_cast<int>( size ), BL_FORMAT_PRGB32 );
+
+	BLContextCreateInfo createInfo{};
+	createInfo.threadCount = parallel::HardwareThreadCount();
+
+	BLContext ctx( image, createInfo );
+	ctx.setFillStyle( BLRgba32( 0xFFFFFFFF ) );
+	ctx.fillAll();
+
+	ctx.translate( centre, centre );
+	ctx.scale( pixelsPerUnit );
+
+	//the sensor should only see what would be printed. The heads are placed
+	//on a disc, so a linear strip is checked as the disc it was unrolled from.
+	const bool drawInstrumentation = m_drawInstrumentation;
+	const EncoderLayout layout = m_layout;
+	m_drawInstrumentation = false;
+	m_layout = EncoderLayout::Rotary;
+	Render( ctx );
+	m_drawInstrumentation = drawInstrumentation;
+	m_layout = layout;
+
+	ctx.end();
+
+	model.heads = GetSensorHeads();
+	return SensorSimulator::Run( image, { centre, centre, pixelsPerUnit }, model, m_bits, samplesPerSector, threads );
+}
+
+//------------------------------------------------------------------------------
+// Config Changed
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+int GraysEncoder::GetGrayNumber() const
+{
+	return m_nFactor;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+CodeFamilyType GraysEncoder::GetCodeFamily() const
+{
+	return m_codeFamily;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+uint32_t GraysEncoder::GetSingleTrackPeriod() const
+{
+	return m_singleTrackPeriod;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetGrayNumber( const uint8_t n )
+{
+	if ( n != m_nFactor )
+	{
+		m_nFactor = n;
+
+		m_bits.clear();
+		Generate();
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetInnerRadius( const double rad )
+{
+	m_innerRadius = rad;
+
+	if ( m_innerRadius > m_outerRadius - 1 )
+	{
+		m_innerRadius = m_outerRadius - 1;
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetOuterRadius( const double rad )
+{
+	m_outerRadius = rad;
+
+	if ( m_outerRadius < m_innerRadius + 1 )
+	{
+		m_outerRadius = m_innerRadius + 1;
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetInvert( const bool val )
+{
+	m_invertTree = val;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetLayout( const EncoderLayout layout )
+{
+	m_layout = layout;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetLinearLength( const double length )
+{
+	m_linearLength = length;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetLinearHeight( const double height )
+{
+	m_linearHeight = height;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetIncrementalLines( const uint32_t lines )
+{
+	m_incrementalLines = lines;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetIncrementalWidth( const double width )
+{
+	m_incrementalWidth = static_cast<float>( width );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetQuadraturePhase( const double electricalDeg )
+{
+	m_quadraturePhaseDeg = electricalDeg;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetIndexTrack( const bool val )
+{
+	m_indexTrack = val;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetCodeFamily( const CodeFamilyType family )
+{
+	if ( family != m_codeFamily )
+	{
+		m_codeFamily = family;
+
+		m_bits.clear();
+		Generate();
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetSingleTrackPeriod( const uint32_t period )
+{
+	if ( period != m_singleTrackPeriod )
+	{
+		m_singleTrackPeriod = period;
+
+		if ( m_codeFamily == CodeFamilyType::SingleTrack )
+		{
+			m_bits.clear();
+			Generate();
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool GraysEncoder::IsSingleTrackLayout() const
+{
+	return !m_codeInfo.ring.empty();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void GraysEncoder::SetCacheDirectory( const std::filesystem::path& dir )
+{
+	m_codeFamilies.SetCacheDirectory( dir );
 }
 
 //------------------------------------------------------------------------------
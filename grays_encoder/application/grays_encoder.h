@@ -31,11 +31,21 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
+#include <functional>
 #include <blend2d/geometry.h>
 #include <blend2d/rgba.h>
 #include <blend2d/random.h>
 #include "ui/properties_menu/property_panel.h"
 #include "core/render_action.h"
+#include "core/code_validator.h"
+#include "core/code_family.h"
+#include "core/single_track_decoder.h"
+#include "core/sensor_simulator.h"
+#include "core/tolerance_analysis.h"
+#include "core/firmware_tables.h"
+#include "core/bulk_decoder.h"
+#include "core/tiled_export.h"
+#include "utility/stroke_cache.h"
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
@@ -44,6 +54,17 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //------------------------------------------------------------------------------
 class BLContext;
 class BLPoint;
+class BLPath;
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class EncoderLayout : uint32_t
+{
+	Rotary,
+	Linear,
+
+	Count
+};
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
@@ -55,20 +76,90 @@ class GraysEncoder
 public:
 	GraysEncoder();
 
+	// Receives each rendered tile of a strip, pixels [0, width) of the image are valid.
+	// Return false to stop rendering.
+	using TileSink = std::function<bool( const BLImage& tile, uint32_t x, uint32_t y, uint32_t width, uint32_t height )>;
+	// Receives each dark run of a code track as the arc Render would draw for it.
+	using ArcSpanFn = std::function<void( double radius, double width, double beginAngleDeg, double sweepAngleDeg )>;
+
 	void Render( BLContext& ctx );
+	// Streams the linear strip left to right in tiles of tileWidth pixels.
+	bool RenderLinearStrip( double pixelsPerUnit, uint32_t tileWidth, const TileSink& sink );
 	void Generate();
 	void Grays( int n );
+	// Runs the family search Generate would, without touching the current code, so it can run off the UI thread.
+	GeneratedCode SearchCode( CodeFamilyType family, int bitCount, uint32_t period ) const;
+	// Switches to a code SearchCode found for the same family, bit count and period.
+	void SetCode( CodeFamilyType family, int bitCount, uint32_t period, GeneratedCode code );
 
 	actions::RenderAction& GetRenderAction();
+	const CodeValidationResult& GetValidation() const;
+	const GeneratedCode& GetCodeInfo() const;
+	bool IsSingleTrackLayout() const;
+	int GetIncrementalTrackCount() const;
+	double GetIncrementalTrackRadius( int track ) const;
+	// Outermost printed radius, including the incremental tracks.
+	double GetOuterExtent() const;
+	// Strip height, including the incremental tracks.
+	double GetLinearHeight() const;
+	std::vector<SensorHead> GetSensorHeads() const;
 
+	// Renders the disc off screen at the given resolution and sweeps the sensor heads over it.
+	SensorSimulationResult SimulateSensor( SensorModel model, double pixelsPerUnit, uint32_t samplesPerSector, uint32_t threads = 0 );
+
+	// Analytic copy of the disc for runs that perturb the geometry.
+	DiscLayout GetDiscLayout();
+	ToleranceResult AnalyseTolerances( const ToleranceModel& model, const ToleranceRun& run );
+	FirmwareTables GenerateFirmwareTables( FirmwareOptions options );
+
+	// Renders the artwork tile by tile straight to an image file at any resolution.
+	ExportResult Export( const std::filesystem::path& path, const ExportOptions& options, const TiledExporter::ProgressFn& progress = nullptr );
+	// Renders the whole artwork into one image with no overlays, framed as Export frames it.
+	// Preview quality flattens with a coarser tolerance, for thumbnails and quick looks.
+	BLImage RenderImage( double pixelsPerUnit, uint32_t threads = 0, BLApproximationQuality quality = BL_APPROXIMATION_QUALITY_PRODUCTION );
+
+	// Runs the code track run extraction Render uses, handing each arc to fn instead of drawing it.
+	void ExtractArcSpans( const ArcSpanFn& fn );
 	void DrawArcSegment( BLContext& ctx, float radius, float width, float startAngleDeg, float arcAngleDeg );
+	// Appends the closed outline DrawArcSegment fills.
+	static void BuildArcSegment( BLPath& path, float radius, float width, float startAngleDeg, float arcAngleDeg );
+	// Instrumentation circles are the same every frame, so they go through the stroke cache.
+	void StrokeCircle( BLContext& ctx, double x, double y, double radius );
 
+	int GetGrayNumber() const;
+	CodeFamilyType GetCodeFamily() const;
+	uint32_t GetSingleTrackPeriod() const;
 	void SetGrayNumber( const uint8_t n );
 	void SetInnerRadius( const double rad );
 	void SetOuterRadius( const double rad );
 	void SetInvert( const bool val );
+	void SetLayout( const EncoderLayout layout );
+	void SetLinearLength( const double length );
+	void SetLinearHeight( const double height );
+	void SetIncrementalLines( const uint32_t lines );
+	void SetIncrementalWidth( const double width );
+	void SetQuadraturePhase( const double electricalDeg );
+	void SetIndexTrack( const bool val );
+	void SetCodeFamily( const CodeFamilyType family );
+	void SetSingleTrackPeriod( const uint32_t period );
+	void SetCacheDirectory( const std::filesystem::path& dir );
 	void DrawInstrumentation( const bool val );
 
+private:
+	void ApplyCode( GeneratedCode code );
+	template<class SampleFn>
+	void DrawTrack( BLContext& ctx, double radius, double width, uint32_t segmentCount, SampleFn sample, double phaseDeg = 0.0 );
+	template<class SampleFn, class SpanFn>
+	static void ForEachArcSpan( uint32_t segmentCount, SampleFn sample, double phaseDeg, SpanFn span );
+	template<class TrackFn>
+	void ForEachCodeTrack( TrackFn track );
+	void DrawIncrementalTracks( BLContext& ctx );
+	template<class SampleFn>
+	void CollectRuns( std::vector<BLBox>& boxes, double left, double cellWidth, uint32_t cellCount, double top, double bottom, double beginX, double endX, SampleFn sample );
+	void RenderLinear( BLContext& ctx, double beginX, double endX );
+	// Framing shared by Export and RenderImage, sets the image size in pixels.
+	TiledExporter::DrawFn GetArtworkDraw( double pixelsPerUnit, uint32_t& width, uint32_t& height );
+
 private:
 	actions::RenderActionT<GraysEncoder, &GraysEncoder::Render> m_renderAction;
 
@@ -78,9 +169,27 @@ private:
 	bool m_drawInstrumentation = false;
 	float m_innerRadius = 100.0f;
 	float m_outerRadius = 200.0f;
+	CodeFamilyType m_codeFamily = CodeFamilyType::Reflected;
+	uint32_t m_singleTrackPeriod = 0;
+
+	//Linear strips, sectors along the length.
+	EncoderLayout m_layout = EncoderLayout::Rotary;
+	double m_linearLength = 400.0;
+	double m_linearHeight = 100.0;
+
+	//Incremental tracks, 0 lines turns them off.
+	uint32_t m_incrementalLines = 0;
+	float m_incrementalWidth = 10.0f;
+	double m_quadraturePhaseDeg = 90.0;
+	bool m_indexTrack = true;
 
 	//Data
 	std::vector<unsigned int> m_bits;
+	GeneratedCode m_codeInfo;	//codes are moved into m_bits.
+	CodeFamilyEngine m_codeFamilies;
+	SingleTrackDecoder m_singleTrackDecoder;
+	CodeValidationResult m_validation;
+	StrokeCache m_strokeCache;
 
 	QImage m_renderBuffer;
 	BLImage m_b2dRenderTarget;
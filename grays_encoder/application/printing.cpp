@@ -37,6 +37,8 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <blend2d/image.h>
 #include "application/printing.h"
 #include "application/core/render_action.h"
+#include "application/core/render_thread_tuner.h"
+#include "utility/parallel_for.h"
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
@@ -74,8 +76,10 @@ void PrintingService::InitPrintBuffer()
 	const double width = m_printer.width();
 	const double height = m_printer.height();
 
-	m_renderBuffer = QImage( width*2, height*2, QImage::Format_ARGB32_Premultiplied );
-	m_b2dRenderTarget.createFromData( width*2, height*2, BL_FORMAT_PRGB32, m_renderBuffer.bits(), m_renderBuffer.bytesPerLine() );
+	//Format_Mono is msb first like the packed rows, 1 is paper.
+	m_renderBuffer = QImage( width*2, height*2, QImage::Format_Mono );
+	m_renderBuffer.setColorTable( { qRgb( 0, 0, 0 ), qRgb( 255, 255, 255 ) } );
+	m_b2dRenderTarget.create( width*2, height*2, BL_FORMAT_A8 );
 }
 
 //------------------------------------------------------------------------------
@@ -92,8 +96,9 @@ void PrintingService::PrintPreview( QPrinter* printer )
 
 	if ( m_renderer )
 	{
+		//a page is tens of megapixels, every core pays off.
 		BLContextCreateInfo createInfo{};
-		createInfo.threadCount = 16;
+		createInfo.threadCount = m_threadTuner ? m_threadTuner->GetPrintThreadCount() : parallel::HardwareThreadCount();
 
 		BLContext ctx( m_b2dRenderTarget, createInfo );
 
@@ -106,9 +111,19 @@ void PrintingService::PrintPreview( QPrinter* printer )
 		ctx.translate( x, y );
 		ctx.scale( pixelsPerMm );
 
-		ctx.setFillStyle( BLRgba32( 0x00000000 ) );
+		ctx.clearAll();
 
 		m_renderer->Render( ctx );
+		ctx.end();
+
+		BLImageData coverage;
+		m_b2dRenderTarget.getData( &coverage );
+
+		for ( int row = 0; row < m_renderBuffer.height(); ++row )
+		{
+			const uint8_t* src = static_cast<const uint8_t*>( coverage.pixelData ) + coverage.stride * intptr_t( row );
+			Monochrome::PackCoverage( src, uint32_t( m_renderBuffer.width() ), m_renderBuffer.scanLine( row ), uint32_t( row ), m_packing );
+		}
 
 		painter.scale( 0.5f, 0.5f );
 		painter.drawImage( QPoint( 0, 0 ), m_renderBuffer );
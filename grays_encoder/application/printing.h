@@ -32,6 +32,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <QPrinter>
 #include <QImage>
 #include <blend2d/image.h>
+#include "application/core/monochrome.h"
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
@@ -39,6 +40,7 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // Forwards
 //------------------------------------------------------------------------------
 class QPrinter;
+class RenderThreadTuner;
 namespace actions
 {
 	class RenderAction;
@@ -56,15 +58,20 @@ public:
 	void Run();
 	void InitPrintBuffer();
 	inline void SetRenderFunction( actions::RenderAction& render );
+	inline void SetPacking( MonoPacking packing );
+	inline void SetThreadTuner( const RenderThreadTuner* tuner );
 
 private slots:
 	void PrintPreview( QPrinter* printer );
 
 private:
 	actions::RenderAction* m_renderer = nullptr;
+	const RenderThreadTuner* m_threadTuner = nullptr;
 
 	QPrinter m_printer;
 
+	//coverage is rendered in A8 and packed to 1-bpp for the printer.
+	MonoPacking m_packing = MonoPacking::Threshold;
 	QImage m_renderBuffer;
 	BLImage m_b2dRenderTarget;
 };
@@ -76,4 +83,18 @@ private:
 inline void PrintingService::SetRenderFunction( actions::RenderAction& render )
 {
 	m_renderer = &render;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline void PrintingService::SetPacking( MonoPacking packing )
+{
+	m_packing = packing;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline void PrintingService::SetThreadTuner( const RenderThreadTuner* tuner )
+{
+	m_threadTuner = tuner;
 }
\ No newline at end of file
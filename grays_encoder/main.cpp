@@ -29,9 +29,17 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <QtCore/QStandardPaths>
 #include <QtWidgets/QApplication>
 #include "ui/window_main/window_main.h"
+#include "application/golden_harness.h"
+#include "application/benchmark_suite.h"
 #include "utility/globals.h"
+#include "utility/thread_attributes.h"
+#include "utility/pipeline_cache.h"
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
@@ -80,6 +88,60 @@ int main(int argc, char *argv[])
         g_commandLineArgs.args.push_back( argv[i] );
     }
 
+    //render worker affinity and priority, before any worker thread exists.
+    parallel::ConfigureThreadAttributes( g_commandLineArgs.args );
+
+    //compile the pipelines earlier runs used while the window or headless run starts.
+    const std::filesystem::path pipelineCachePath = std::filesystem::path( QStandardPaths::writableLocation( QStandardPaths::GenericCacheLocation ).toStdWString() ) / "grays_encoder" / "blend2d_pipelines.txt";
+    PipelineCache pipelineCache;
+    if( PipelineCache::IsSupported() )
+    {
+        pipelineCache.Prewarm( pipelineCachePath );
+    }
+
+    //headless runs, no window is created.
+    for( size_t i = 1; i + 1 < g_commandLineArgs.args.size(); i++ )
+    {
+        const std::string& mode = g_commandLineArgs.args[i];
+
+        //golden image regression, "golden-check <dir>" or "golden-update <dir>"
+        if( mode == "golden-check" || mode == "golden-update" )
+        {
+            GoldenOptions options;
+            options.directory = g_commandLineArgs.args[i + 1];
+            options.update = mode == "golden-update";
+
+            const GoldenRunResult result = GoldenHarness::Run( options );
+            const std::string report = GoldenHarness::FormatReport( result );
+
+            //a windows subsystem build has no console, so keep a copy with the images.
+            fputs( report.c_str(), stdout );
+            std::ofstream( options.directory / "golden_report.txt" ) << report;
+
+            pipelineCache.Save( pipelineCachePath );
+
+            return result.passed ? 0 : 1;
+        }
+
+        //benchmarks, "benchmark <out.json> [max bits]", n = 24 renders take minutes.
+        if( mode == "benchmark" )
+        {
+            BenchmarkOptions options;
+            if( i + 2 < g_commandLineArgs.args.size() )
+            {
+                const std::string& candiateNumber = g_commandLineArgs.args[i + 2];
+                if( !candiateNumber.empty() && std::all_of( candiateNumber.begin(), candiateNumber.end(), ::isdigit ) )
+                {
+                    options.maxBits = std::clamp( atoi( candiateNumber.c_str() ), options.minBits, 24 );
+                }
+            }
+
+            const BenchmarkReport report = BenchmarkSuite::Run( options );
+            pipelineCache.Save( pipelineCachePath );
+            return BenchmarkSuite::WriteJson( report, g_commandLineArgs.args[i + 1] ) ? 0 : 1;
+        }
+    }
+
     QApplication a(argc, argv);
     WindowMain window;
     window.setMinimumSize(QSize(400, 320));
@@ -87,5 +149,7 @@ int main(int argc, char *argv[])
     window.setWindowTitle( "Grays Code Generator" );
     window.show();
 
-    return a.exec();
+    const int result = a.exec();
+    pipelineCache.Save( pipelineCachePath );
+    return result;
 }
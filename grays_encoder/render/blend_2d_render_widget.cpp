@@ -30,10 +30,14 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
+#include <algorithm>
 #include <QPainter>
 #include <qevent.h>
 #include "application/core/render_action.h"
+#include "application/core/render_thread_tuner.h"
 #include "render/blend_2d_render_widget.h"
+#include "utility/parallel_for.h"
+#include "utility/thread_attributes.h"
 //#include "utility/globals.h"
 
 //------------------------------------------------------------------------------
@@ -73,18 +77,119 @@ void Blend2DRenderWidget::resizeEvent(QResizeEvent* event)
 		return;
 	}
 
-	m_renderBuffer = QImage( w, h, QImage::Format_ARGB32_Premultiplied );
-	m_b2dRenderTarget.createFromData( w, h, BL_FORMAT_PRGB32, m_renderBuffer.bits(), m_renderBuffer.bytesPerLine() );
-
+	CreateRenderBuffer( w, h );
 	UpdateRenderBuffer();
 }
 
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Blend2DRenderWidget::SetMonochrome( bool monochrome )
+{
+	if ( m_monochrome == monochrome )
+	{
+		return;
+	}
+
+	m_monochrome = monochrome;
+	CreateRenderBuffer( width(), height() );
+}
+
+//------------------------------------------------------------------------------
+// Qt's Alpha8 draws as black at the stored alpha, so it shares memory with a
+// blend2d A8 target and needs no conversion to display.
+//------------------------------------------------------------------------------
+void Blend2DRenderWidget::CreateRenderBuffer( int w, int h )
+{
+	if ( m_monochrome )
+	{
+		m_renderBuffer = QImage( w, h, QImage::Format_Alpha8 );
+		m_b2dRenderTarget.createFromData( w, h, BL_FORMAT_A8, m_renderBuffer.bits(), m_renderBuffer.bytesPerLine() );
+	}
+	else
+	{
+		m_renderBuffer = QImage( w, h, QImage::Format_ARGB32_Premultiplied );
+		m_b2dRenderTarget.createFromData( w, h, BL_FORMAT_PRGB32, m_renderBuffer.bits(), m_renderBuffer.bytesPerLine() );
+	}
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 void Blend2DRenderWidget::paintEvent( QPaintEvent* event )
 {
 	QPainter painter( this );
-	painter.drawImage( QPoint( 0, 0 ), m_renderBuffer );
+
+	{
+		ScopedStageTimer blitTimer( &m_profiler, FrameStage::Blit );
+
+		if ( m_monochrome )
+		{
+			painter.fillRect( rect(), Qt::white );
+		}
+
+		painter.drawImage( QPoint( 0, 0 ), m_renderBuffer );
+	}
+
+	m_profiler.EndFrame();
+
+	if ( m_showHud )
+	{
+		DrawHud( painter );
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Blend2DRenderWidget::SetHudVisible( bool visible )
+{
+	m_showHud = visible;
+	update();
+}
+
+//------------------------------------------------------------------------------
+// Drawn by QPainter over the blit so it doesn't show up in its own timings.
+//------------------------------------------------------------------------------
+void Blend2DRenderWidget::DrawHud( QPainter& painter ) const
+{
+	const FrameRecord* frame = m_profiler.GetLastFrame();
+	if ( frame == nullptr )
+	{
+		return;
+	}
+
+	const auto stageMs = [frame]( FrameStage stage ) { return frame->stageUs[size_t( stage )] / 1000.0; };
+	const StageStats frameStats = m_profiler.GetStageStats( FrameStage::Frame );
+	const StageStats rasterStats = m_profiler.GetStageStats( FrameStage::Rasterize );
+
+	QString text = QString( "Frame %1 ms (p50 %2, p99 %3 over %4)
+Generate %5 ms, build %6 ms
+Rasterize %7 ms (p99 %8), blit %9 ms
+Arcs %10, commands %11
+%12 threads, %13% busy while rasterizing" )
+		.arg( stageMs( FrameStage::Frame ), 0, 'f', 2 )
+		.arg( frameStats.p50Ms, 0, 'f', 2 )
+		.arg( frameStats.p99Ms, 0, 'f', 2 )
+		.arg( frameStats.samples )
+		.arg( stageMs( FrameStage::Generate ), 0, 'f', 2 )
+		.arg( stageMs( FrameStage::Build ), 0, 'f', 2 )
+		.arg( stageMs( FrameStage::Rasterize ), 0, 'f', 2 )
+		.arg( rasterStats.p99Ms, 0, 'f', 2 )
+		.arg( stageMs( FrameStage::Blit ), 0, 'f', 2 )
+		.arg( frame->counters[size_t( FrameCounter::Arcs )] )
+		.arg( frame->counters[size_t( FrameCounter::Commands )] )
+		.arg( frame->threads )
+		.arg( frame->utilisation * 100.0, 0, 'f', 0 );
+
+	const std::string attributes = parallel::DescribeThreadAttributes();
+	if ( !attributes.empty() )
+	{
+		text += "\n" + QString::fromStdString( attributes );
+	}
+
+	const QRect bounds = painter.fontMetrics().boundingRect( QRect( 0, 0, width(), height() ), Qt::AlignLeft | Qt::AlignTop, text ).adjusted( 0, 0, 12, 8 );
+
+	painter.fillRect( bounds.translated( 6, 6 ), QColor( 0, 0, 0, 170 ) );
+	painter.setPen( Qt::white );
+	painter.drawText( bounds.translated( 12, 10 ), Qt::AlignLeft | Qt::AlignTop, text );
 }
 
 //------------------------------------------------------------------------------
@@ -143,10 +248,14 @@ void Blend2DRenderWidget::UpdateRenderBuffer()
 {
 	if ( m_renderer )
 	{
+		const uint32_t threads = ResolveRenderThreads();
+		m_profiler.BeginFrame( threads );
+
 		BLContextCreateInfo createInfo{};
-		createInfo.threadCount = GetRenderThreads();
+		createInfo.threadCount = threads;
 
 		BLContext ctx( m_b2dRenderTarget, createInfo );
+		ctx.setApproximationQuality( m_previewQuality ? BL_APPROXIMATION_QUALITY_PREVIEW : BL_APPROXIMATION_QUALITY_PRODUCTION );
 
 		const double x = (ctx.targetWidth() * 0.5) + m_userPosition.x;
 		const double y = (ctx.targetHeight() * 0.5) + m_userPosition.y;
@@ -157,9 +266,54 @@ void Blend2DRenderWidget::UpdateRenderBuffer()
 		//ctx.setFillStyle( BLRgba32( 0xFF000000 ) );
 
 
-		ctx.setFillStyle( BLRgba32( 0xFFFFFFFF ) );
-		ctx.fillAll();
+		if ( m_monochrome )
+		{
+			ctx.clearAll();
+		}
+		else
+		{
+			ctx.setFillStyle( BLRgba32( 0xFFFFFFFF ) );
+			ctx.fillAll();
+		}
 
+		m_renderer->profiler = &m_profiler;
 		m_renderer->Render( ctx );
+		m_renderer->profiler = nullptr;
+
+		//workers may still be rasterizing queued commands, wait for them here.
+		const double cpuBegin = FrameProfiler::GetProcessCpuMs();
+		const FrameProfiler::clock::time_point rasterBegin = FrameProfiler::clock::now();
+
+		ctx.end();
+
+		const FrameProfiler::clock::time_point rasterEnd = FrameProfiler::clock::now();
+		const double wallMs = std::chrono::duration<double, std::milli>( rasterEnd - rasterBegin ).count();
+
+		m_profiler.AddStage( FrameStage::Rasterize, rasterBegin, rasterEnd );
+		if ( wallMs > 0.0 )
+		{
+			m_profiler.SetUtilisation( (FrameProfiler::GetProcessCpuMs() - cpuBegin) / (wallMs * std::max( threads, 1u )) );
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// The command count comes from the previous frame, the current one isn't built yet.
+//------------------------------------------------------------------------------
+uint32_t Blend2DRenderWidget::ResolveRenderThreads() const
+{
+	if ( m_renderThreads != 0 )
+	{
+		return m_renderThreads;
 	}
+
+	if ( !m_threadTuner )
+	{
+		return parallel::HardwareThreadCount();
+	}
+
+	const FrameRecord* last = m_profiler.GetLastFrame();
+	const uint64_t commands = last ? last->counters[size_t( FrameCounter::Commands )] : 0;
+
+	return m_threadTuner->GetThreadCount( uint64_t( m_b2dRenderTarget.width() ) * uint64_t( m_b2dRenderTarget.height() ), commands );
 }
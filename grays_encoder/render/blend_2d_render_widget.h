@@ -34,12 +34,15 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <QObject>
 #include <QImage>
 #include <QWidget>
+#include "utility/frame_profiler.h"
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 // Forwards
 //------------------------------------------------------------------------------
+class QPainter;
+class RenderThreadTuner;
 namespace actions
 {
 	class RenderAction;
@@ -61,8 +64,21 @@ public:
 	void Invalidation();
 
 	inline void SetRenderFunction( actions::RenderAction& render );
+	// 0 lets the tuner pick a count per frame from its size and last command count.
 	inline void SetNumberOfRenderThreads( uint32_t threads );
 	inline uint32_t GetRenderThreads() const;
+	inline void SetThreadTuner( const RenderThreadTuner* tuner );
+
+	// Renders coverage into an A8 buffer instead of PRGB32, a quarter of the
+	// bandwidth. Colour overlays come out black. Takes effect on the next Invalidation.
+	void SetMonochrome( bool monochrome );
+	// Flattens curves and simplifies strokes with blend2d's coarser preview
+	// tolerance, in screen pixels, so fewer edges are built at any zoom.
+	inline void SetPreviewQuality( bool preview );
+
+	// Overlays frame time, stage percentiles, arc and command counts and worker use.
+	void SetHudVisible( bool visible );
+	inline const FrameProfiler& GetProfiler() const;
 
 protected:
 	//qt
@@ -73,15 +89,25 @@ protected:
 	void wheelEvent( QWheelEvent* event ) override;
 
 private:
+	void CreateRenderBuffer( int w, int h );
 	void UpdateRenderBuffer();
+	uint32_t ResolveRenderThreads() const;
+	void DrawHud( QPainter& painter ) const;
 
 private:
 	//render
 	actions::RenderAction* m_renderer = nullptr;
-	uint32_t m_renderThreads = 16;
+	uint32_t m_renderThreads = 0;
+	const RenderThreadTuner* m_threadTuner = nullptr;
+	bool m_monochrome = false;
+	bool m_previewQuality = true;
 	QImage m_renderBuffer;
 	BLImage m_b2dRenderTarget;
 
+	//frame timing, a frame runs from UpdateRenderBuffer to the end of paintEvent.
+	FrameProfiler m_profiler;
+	bool m_showHud = false;
+
 	//user interaction
 	BLPoint m_mousePrevious {0,0};
 	BLPoint m_mouseCurrent{ 0,0 };
@@ -111,3 +137,24 @@ inline uint32_t Blend2DRenderWidget::GetRenderThreads() const
 {
 	return m_renderThreads;
 }
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline void Blend2DRenderWidget::SetThreadTuner( const RenderThreadTuner* tuner )
+{
+	m_threadTuner = tuner;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline void Blend2DRenderWidget::SetPreviewQuality( bool preview )
+{
+	m_previewQuality = preview;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+inline const FrameProfiler& Blend2DRenderWidget::GetProfiler() const
+{
+	return m_profiler;
+}
@@ -31,6 +31,16 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //------------------------------------------------------------------------------
 #include <QtPrintSupport/QPrintDialog>
 #include <QtPrintSupport/QPrinter>
+#include <QStandardPaths>
+#include <QMessageBox>
+#include <QFileDialog>
+#include <QProgressDialog>
+#include <QCoreApplication>
+#include <QRegularExpression>
+#include <future>
+#include <fstream>
+#include <climits>
+#include <algorithm>
 #include "ui/window_main/window_main.h"
 #include "utility/globals.h"
 #include "QLabel"
@@ -53,6 +63,8 @@ WindowMain::WindowMain( QWidget* parent/*=nullptr*/)
 	HandleCommandLine();
 	InitMenus();
 
+	m_grays.SetCacheDirectory( QStandardPaths::writableLocation( QStandardPaths::CacheLocation ).toStdWString() + L"/codes" );
+
 	m_canvas.SetRenderFunction( m_grays.GetRenderAction() );
 	m_printingService.SetRenderFunction( m_grays.GetRenderAction() );
 }
@@ -88,6 +100,36 @@ void WindowMain::InitMenuBar()
 		connect( m_actionPrint, SIGNAL( triggered() ), this, SLOT( onOpenPrintDialog() ) );
 	}	
 	
+	if( m_actionSimulate = ui.menuFile->addAction( "Simulate Sensor" ) )
+	{
+		connect( m_actionSimulate, SIGNAL( triggered() ), this, SLOT( onSimulateSensor() ) );
+	}
+
+	if( m_actionTolerance = ui.menuFile->addAction( "Tolerance Analysis" ) )
+	{
+		connect( m_actionTolerance, SIGNAL( triggered() ), this, SLOT( onToleranceAnalysis() ) );
+	}
+
+	if( m_actionFirmware = ui.menuFile->addAction( "Export Firmware Header" ) )
+	{
+		connect( m_actionFirmware, SIGNAL( triggered() ), this, SLOT( onExportFirmware() ) );
+	}
+
+	if( m_actionExportImage = ui.menuFile->addAction( "Export Image" ) )
+	{
+		connect( m_actionExportImage, SIGNAL( triggered() ), this, SLOT( onExportImage() ) );
+	}
+
+	if( m_actionBenchmarkDecode = ui.menuHelp->addAction( "Benchmark Bulk Decoder" ) )
+	{
+		connect( m_actionBenchmarkDecode, SIGNAL( triggered() ), this, SLOT( onBenchmarkBulkDecode() ) );
+	}
+
+	if( m_actionFrameTrace = ui.menuHelp->addAction( "Export Frame Trace" ) )
+	{
+		connect( m_actionFrameTrace, SIGNAL( triggered() ), this, SLOT( onExportFrameTrace() ) );
+	}
+
 	if( m_actionAbout = ui.menuHelp->addAction( "About" ) )
 	{
 		connect( m_actionAbout, SIGNAL( triggered() ), this, SLOT( onAbout() ) );
@@ -105,10 +147,37 @@ void WindowMain::InitGraysConfig()
 	m_propertyPanel.AddProperty( "root.gray", "Gray N", 1, 1, 31 )
 		.Connect<WindowMain, &WindowMain::OnGrayChanged>( *this );
 
+	//Code Family
+	const std::vector<EnumDisplayPair> families = {
+		{ "Reflected Binary", underlying_cast( CodeFamilyType::Reflected ) },
+		{ "Balanced", underlying_cast( CodeFamilyType::Balanced ) },
+		{ "Maximum Run Length", underlying_cast( CodeFamilyType::MaxRunLength ) },
+		{ "Single Track", underlying_cast( CodeFamilyType::SingleTrack ) },
+	};
+
+	m_propertyPanel.AddProperty( "root.family", "Code Family", underlying_cast( CodeFamilyType::Reflected ), families )
+		.Connect<WindowMain, &WindowMain::OnCodeFamilyChanged>( *this );
+
+	//Single track period, 0 picks the longest the search can find.
+	m_propertyPanel.AddProperty( "root.stperiod", "Single Track Period", 0, 0, 65536 )
+		.Connect<WindowMain, &WindowMain::OnSingleTrackPeriodChanged>( *this );
+
 	//Endianness.
 	m_propertyPanel.AddProperty( "root.instrum", "Draw Instrumentation", true )
 		.Connect<WindowMain, &WindowMain::OnInstrumentationChanged>( *this );
 
+	//Frame timing overlay.
+	m_propertyPanel.AddProperty( "root.framestats", "Show Frame Stats", false )
+		.Connect<WindowMain, &WindowMain::OnFrameStatsChanged>( *this );
+
+	//Coarser curve flattening while viewing, exports always use production quality.
+	m_propertyPanel.AddProperty( "root.previewquality", "Preview Quality Curves", true )
+		.Connect<WindowMain, &WindowMain::OnPreviewQualityChanged>( *this );
+
+	//Blend2D worker, pipeline and codec timeline, written by Export Frame Trace.
+	m_propertyPanel.AddProperty( "root.blend2dtrace", "Record Blend2D Trace", false )
+		.Connect<WindowMain, &WindowMain::OnBlend2DTraceChanged>( *this );
+
 	//Endianness.
 	m_propertyPanel.AddProperty( "root.endian", "Inverted", true )
 		.Connect<WindowMain, &WindowMain::OnEndianChanged>( *this );
@@ -119,6 +188,125 @@ void WindowMain::InitGraysConfig()
 
 	m_propertyPanel.AddProperty( "root.outerrad", "Outer Radius", 150.0f, 0.0f, 300.0f )
 		.Connect<WindowMain, &WindowMain::OnOuterRadiusChanged>( *this );
+
+	//Linear strips lay the same tracks out flat.
+	const std::vector<EnumDisplayPair> layouts = {
+		{ "Rotary", underlying_cast( EncoderLayout::Rotary ) },
+		{ "Linear", underlying_cast( EncoderLayout::Linear ) },
+	};
+
+	m_propertyPanel.AddProperty( "root.layout", "Layout", underlying_cast( EncoderLayout::Rotary ), layouts )
+		.Connect<WindowMain, &WindowMain::OnLayoutChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.linlength", "Linear Length", 400.0f, 1.0f, 100000.0f )
+		.Connect<WindowMain, &WindowMain::OnLinearLengthChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.linheight", "Linear Height", 100.0f, 1.0f, 1000.0f )
+		.Connect<WindowMain, &WindowMain::OnLinearHeightChanged>( *this );
+
+	//Incremental quadrature tracks outside the absolute code.
+	m_propertyPanel.AddProperty( "root.inclines", "Incremental Lines", 0, 0, 65536 )
+		.Connect<WindowMain, &WindowMain::OnIncrementalLinesChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.incwidth", "Incremental Track Width", 10.0f, 1.0f, 100.0f )
+		.Connect<WindowMain, &WindowMain::OnIncrementalWidthChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.incphase", "Quadrature Phase (electrical deg)", 90.0f, 0.0f, 180.0f )
+		.Connect<WindowMain, &WindowMain::OnQuadraturePhaseChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.incindex", "Index Track", true )
+		.Connect<WindowMain, &WindowMain::OnIndexTrackChanged>( *this );
+
+	//Sensor simulation, used by File > Simulate Sensor.
+	m_propertyPanel.AddProperty( "root.sensorres", "Sensor Resolution (px/unit)", 8.0f, 0.5f, 64.0f )
+		.Connect<WindowMain, &WindowMain::OnSensorResolutionChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.sensorap", "Sensor Aperture", 0.0f, 0.0f, 20.0f )
+		.Connect<WindowMain, &WindowMain::OnSensorApertureChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.sensorrad", "Sensor Radial Offset", 0.0f, -20.0f, 20.0f )
+		.Connect<WindowMain, &WindowMain::OnSensorRadialOffsetChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.sensorang", "Sensor Angular Offset", 0.0f, -10.0f, 10.0f )
+		.Connect<WindowMain, &WindowMain::OnSensorAngularOffsetChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.sensorsamples", "Sensor Samples Per Sector", 16, 1, 4096 )
+		.Connect<WindowMain, &WindowMain::OnSensorSamplesChanged>( *this );
+
+	//Tolerance analysis, used by File > Tolerance Analysis. Values are standard deviations.
+	m_propertyPanel.AddProperty( "root.tolerancetrials", "Tolerance Trials", 1000, 1, 1000000 )
+		.Connect<WindowMain, &WindowMain::OnToleranceTrialsChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.toleranceecc", "Tolerance Eccentricity", 0.0f, 0.0f, 20.0f )
+		.Connect<WindowMain, &WindowMain::OnToleranceEccentricityChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.tolerancescale", "Tolerance Print Scale", 0.0f, 0.0f, 0.1f )
+		.Connect<WindowMain, &WindowMain::OnToleranceScaleChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.tolerancebleed", "Tolerance Bleed", 0.0f, 0.0f, 10.0f )
+		.Connect<WindowMain, &WindowMain::OnToleranceBleedChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.tolerancesensor", "Tolerance Sensor Radial", 0.0f, 0.0f, 20.0f )
+		.Connect<WindowMain, &WindowMain::OnToleranceSensorChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.tolerancejitter", "Tolerance Head Jitter (deg)", 0.0f, 0.0f, 5.0f )
+		.Connect<WindowMain, &WindowMain::OnToleranceJitterChanged>( *this );
+
+	//Firmware header export, used by File > Export Firmware Header.
+	const std::vector<EnumDisplayPair> decoders = {
+		{ "Auto", underlying_cast( FirmwareDecoder::Auto ) },
+		{ "Lookup Table", underlying_cast( FirmwareDecoder::Lookup ) },
+		{ "Packed Table", underlying_cast( FirmwareDecoder::PackedLookup ) },
+		{ "XOR Prefix", underlying_cast( FirmwareDecoder::XorPrefix ) },
+	};
+
+	m_propertyPanel.AddProperty( "root.fwdecoder", "Firmware Decoder", underlying_cast( FirmwareDecoder::Auto ), decoders )
+		.Connect<WindowMain, &WindowMain::OnFirmwareDecoderChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.fwwait", "Firmware Flash Wait States", 0, 0, 15 )
+		.Connect<WindowMain, &WindowMain::OnFirmwareWaitStatesChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.fwpolarity", "Firmware Track Polarity Mask", 0, 0, INT_MAX )
+		.Connect<WindowMain, &WindowMain::OnFirmwarePolarityChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.fwzero", "Firmware Zero Offset", 0, 0, INT_MAX )
+		.Connect<WindowMain, &WindowMain::OnFirmwareZeroOffsetChanged>( *this );
+
+	//measured per track sensor offsets in positions, track 0 first, e.g. "0, 1, -2".
+	m_propertyPanel.AddProperty<const char*>( "root.fwtracks", "Firmware Track Offsets", "" )
+		.Connect<WindowMain, &WindowMain::OnFirmwareTrackOffsetsChanged>( *this );
+
+	//Image export, used by File > Export Image.
+	const std::vector<EnumDisplayPair> formats = {
+		{ "PNG", underlying_cast( ExportFormat::Png ) },
+		{ "Tiled TIFF", underlying_cast( ExportFormat::TiledTiff ) },
+	};
+
+	m_propertyPanel.AddProperty( "root.exportformat", "Export Format", underlying_cast( ExportFormat::Png ), formats )
+		.Connect<WindowMain, &WindowMain::OnExportFormatChanged>( *this );
+
+	const std::vector<EnumDisplayPair> depths = {
+		{ "1-bit", underlying_cast( ExportDepth::Mono1 ) },
+		{ "8-bit Grey", underlying_cast( ExportDepth::Gray8 ) },
+	};
+
+	m_propertyPanel.AddProperty( "root.exportdepth", "Export Depth", underlying_cast( ExportDepth::Mono1 ), depths )
+		.Connect<WindowMain, &WindowMain::OnExportDepthChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.exportres", "Export Resolution (px/unit)", 8.0f, 0.5f, 1000.0f )
+		.Connect<WindowMain, &WindowMain::OnExportResolutionChanged>( *this );
+
+	m_propertyPanel.AddProperty( "root.exporttile", "Export Tile Size", 1024, 16, 8192 )
+		.Connect<WindowMain, &WindowMain::OnExportTileSizeChanged>( *this );
+
+	//1-bit output for export and print.
+	const std::vector<EnumDisplayPair> packings = {
+		{ "Threshold", underlying_cast( MonoPacking::Threshold ) },
+		{ "Ordered Dither", underlying_cast( MonoPacking::OrderedDither ) },
+	};
+
+	m_propertyPanel.AddProperty( "root.monopacking", "1-bit Packing", underlying_cast( MonoPacking::Threshold ), packings )
+		.Connect<WindowMain, &WindowMain::OnMonoPackingChanged>( *this );
 }
 
 
@@ -126,7 +314,7 @@ void WindowMain::InitGraysConfig()
 //------------------------------------------------------------------------------
 void WindowMain::OnGrayChanged( const QVariant& qvr )
 {
-	m_grays.SetGrayNumber( qvr.toInt() );
+	ChangeCode( m_grays.GetCodeFamily(), qvr.toInt(), m_grays.GetSingleTrackPeriod() );
 	m_canvas.Invalidation();
 }
 
@@ -158,18 +346,355 @@ void WindowMain::OnEndianChanged( const QVariant& qvr )
 //------------------------------------------------------------------------------
 void WindowMain::OnInstrumentationChanged( const QVariant& qvr )
 {
+	//the overlays need colour, plain artwork can render as coverage.
 	m_grays.DrawInstrumentation( qvr.toBool() );
+	m_canvas.SetMonochrome( !qvr.toBool() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnFrameStatsChanged( const QVariant& qvr )
+{
+	m_canvas.SetHudVisible( qvr.toBool() );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnPreviewQualityChanged( const QVariant& qvr )
+{
+	m_canvas.SetPreviewQuality( qvr.toBool() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnBlend2DTraceChanged( const QVariant& qvr )
+{
+	//starting again drops the previous recording, stopping keeps it for export.
+	m_blend2dTrace = qvr.toBool() && BLRuntime::startTrace() == BL_SUCCESS;
+	if ( !m_blend2dTrace )
+	{
+		BLRuntime::stopTrace();
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnCodeFamilyChanged( const QVariant& qvr )
+{
+	ChangeCode( static_cast<CodeFamilyType>( qvr.toUInt() ), m_grays.GetGrayNumber(), m_grays.GetSingleTrackPeriod() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnLayoutChanged( const QVariant& qvr )
+{
+	m_grays.SetLayout( static_cast<EncoderLayout>( qvr.toUInt() ) );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnLinearLengthChanged( const QVariant& qvr )
+{
+	m_grays.SetLinearLength( qvr.toDouble() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnLinearHeightChanged( const QVariant& qvr )
+{
+	m_grays.SetLinearHeight( qvr.toDouble() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnSingleTrackPeriodChanged( const QVariant& qvr )
+{
+	ChangeCode( m_grays.GetCodeFamily(), m_grays.GetGrayNumber(), qvr.toUInt() );
 	m_canvas.Invalidation();
 }
 
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::ChangeCode( CodeFamilyType family, int bitCount, uint32_t period )
+{
+	const bool search = family != CodeFamilyType::Reflected
+		&& (family != m_grays.GetCodeFamily() || bitCount != m_grays.GetGrayNumber()
+			|| (family == CodeFamilyType::SingleTrack && period != m_grays.GetSingleTrackPeriod()));
+
+	//reflected codes and settings the code doesn't depend on are cheap.
+	if ( !search )
+	{
+		m_grays.SetCodeFamily( family );
+		m_grays.SetGrayNumber( bitCount );
+		m_grays.SetSingleTrackPeriod( period );
+		return;
+	}
+
+	QProgressDialog progress( "Searching for a code...", QString(), 0, 0, this );
+	progress.setWindowTitle( "Code Family" );
+
+	GeneratedCode found;
+	RunWithProgress( progress, [&]()
+	{
+		found = m_grays.SearchCode( family, bitCount, period );
+	} );
+
+	m_grays.SetCode( family, bitCount, period, std::move( found ) );
+
+	//searches are capped in size and time, past that the engine falls back to the reflected code.
+	const GeneratedCode& code = m_grays.GetCodeInfo();
+	if ( code.family != family )
+	{
+		QMessageBox::warning( this, "Code Family", QString( "No code of the selected family was found for %1 bits within the search limits. "
+			"The reflected binary code is shown instead." ).arg( bitCount ) );
+	}
+	else if ( !code.exact )
+	{
+		QMessageBox::information( this, "Code Family", QString( "The search ran out of time for %1 bits, the code shown is the best one found." ).arg( bitCount ) );
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::RunWithProgress( QProgressDialog& progress, const std::function<void()>& work, const std::atomic<int>* value /*= nullptr*/ )
+{
+	progress.setWindowModality( Qt::WindowModal );
+	progress.setMinimumDuration( 250 );
+
+	//the dialog blocks the property panel, but work may still change the state the
+	//canvas paints from, so the canvas doesn't paint until it's done.
+	m_canvas.setUpdatesEnabled( false );
+
+	std::future<void> done = std::async( std::launch::async, work );
+	while ( done.wait_for( std::chrono::milliseconds( 15 ) ) != std::future_status::ready )
+	{
+		QCoreApplication::processEvents();
+
+		if ( value && !progress.wasCanceled() )
+		{
+			progress.setValue( *value );
+		}
+	}
+
+	m_canvas.setUpdatesEnabled( true );
+	done.get();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnIncrementalLinesChanged( const QVariant& qvr )
+{
+	m_grays.SetIncrementalLines( qvr.toUInt() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnIncrementalWidthChanged( const QVariant& qvr )
+{
+	m_grays.SetIncrementalWidth( qvr.toDouble() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnQuadraturePhaseChanged( const QVariant& qvr )
+{
+	m_grays.SetQuadraturePhase( qvr.toDouble() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnIndexTrackChanged( const QVariant& qvr )
+{
+	m_grays.SetIndexTrack( qvr.toBool() );
+	m_canvas.Invalidation();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnSensorResolutionChanged( const QVariant& qvr )
+{
+	m_sensorResolution = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnSensorApertureChanged( const QVariant& qvr )
+{
+	m_sensorModel.aperture = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnSensorRadialOffsetChanged( const QVariant& qvr )
+{
+	m_sensorModel.radialMisalignment = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnSensorAngularOffsetChanged( const QVariant& qvr )
+{
+	m_sensorModel.angularMisalignmentDeg = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnSensorSamplesChanged( const QVariant& qvr )
+{
+	m_sensorSamples = qvr.toUInt();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnToleranceTrialsChanged( const QVariant& qvr )
+{
+	m_toleranceRun.trials = qvr.toUInt();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnToleranceEccentricityChanged( const QVariant& qvr )
+{
+	m_toleranceModel.eccentricitySigma = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnToleranceScaleChanged( const QVariant& qvr )
+{
+	m_toleranceModel.radiusScaleSigma = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnToleranceBleedChanged( const QVariant& qvr )
+{
+	m_toleranceModel.bleedSigma = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnToleranceSensorChanged( const QVariant& qvr )
+{
+	m_toleranceModel.sensorRadialSigma = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnToleranceJitterChanged( const QVariant& qvr )
+{
+	m_toleranceModel.headJitterSigmaDeg = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnFirmwareDecoderChanged( const QVariant& qvr )
+{
+	m_firmwareOptions.decoder = static_cast<FirmwareDecoder>( qvr.toUInt() );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnFirmwareWaitStatesChanged( const QVariant& qvr )
+{
+	m_firmwareOptions.flashWaitStates = qvr.toUInt();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnFirmwarePolarityChanged( const QVariant& qvr )
+{
+	m_firmwareOptions.polarityMask = qvr.toUInt();
+	UpdateFirmwareCalibration();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnExportFormatChanged( const QVariant& qvr )
+{
+	m_exportOptions.format = static_cast<ExportFormat>( qvr.toUInt() );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnExportDepthChanged( const QVariant& qvr )
+{
+	m_exportOptions.depth = static_cast<ExportDepth>( qvr.toUInt() );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnExportResolutionChanged( const QVariant& qvr )
+{
+	m_exportOptions.pixelsPerUnit = qvr.toDouble();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnExportTileSizeChanged( const QVariant& qvr )
+{
+	m_exportOptions.tileSize = qvr.toUInt();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnMonoPackingChanged( const QVariant& qvr )
+{
+	m_exportOptions.packing = static_cast<MonoPacking>( qvr.toUInt() );
+	m_printingService.SetPacking( m_exportOptions.packing );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnFirmwareZeroOffsetChanged( const QVariant& qvr )
+{
+	m_firmwareOptions.zeroOffset = qvr.toUInt();
+	UpdateFirmwareCalibration();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::OnFirmwareTrackOffsetsChanged( const QVariant& qvr )
+{
+	m_firmwareOptions.trackOffsets.clear();
+
+	const QStringList offsets = qvr.toString().split( QRegularExpression( "[,;\\s]+" ), Qt::SkipEmptyParts );
+	for ( const QString& offset : offsets )
+	{
+		bool ok = false;
+		const int value = offset.toInt( &ok );
+		m_firmwareOptions.trackOffsets.push_back( ok ? value : 0 );
+	}
+
+	UpdateFirmwareCalibration();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::UpdateFirmwareCalibration()
+{
+	const bool skewed = std::any_of( m_firmwareOptions.trackOffsets.begin(), m_firmwareOptions.trackOffsets.end(), []( int32_t offset ) { return offset != 0; } );
+	m_firmwareOptions.emitCalibration = m_firmwareOptions.polarityMask != 0 || m_firmwareOptions.zeroOffset != 0 || skewed;
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 void WindowMain::HandleCommandLine()
 {
 	using iter_str = std::vector<std::string>::iterator;
 
-	//defaults
-	m_canvas.SetNumberOfRenderThreads( 16 );
+	//defaults, 0 render threads picks a count per frame from the tuner.
+	m_canvas.SetNumberOfRenderThreads( 0 );
+	bool recalibrate = false;
 
 	for( iter_str strIter = g_commandLineArgs.args.begin(); strIter != g_commandLineArgs.args.end(); ++strIter )
 	{	
@@ -181,7 +706,29 @@ void WindowMain::HandleCommandLine()
 				m_canvas.SetNumberOfRenderThreads( atoi( candiateNumber.c_str() ) );
 			}
 		}
+		else if( strIter->_Equal("calibrate-render-threads") )
+		{
+			recalibrate = true;
+		}
 	}
+
+	//calibrated once per machine, later runs load the saved result.
+	const std::filesystem::path tuningDir = QStandardPaths::writableLocation( QStandardPaths::AppLocalDataLocation ).toStdWString();
+	std::error_code error;
+	std::filesystem::create_directories( tuningDir, error );
+
+	if( recalibrate )
+	{
+		m_threadTuner.Calibrate( m_grays.GetRenderAction() );
+		m_threadTuner.Save( tuningDir / "render_threads.txt" );
+	}
+	else
+	{
+		m_threadTuner.LoadOrCalibrate( tuningDir / "render_threads.txt", m_grays.GetRenderAction() );
+	}
+
+	m_canvas.SetThreadTuner( &m_threadTuner );
+	m_printingService.SetThreadTuner( &m_threadTuner );
 }
 
 //------------------------------------------------------------------------------
@@ -191,6 +738,243 @@ void WindowMain::onOpenPrintDialog()
 	m_printingService.Run();
 }
 
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::onSimulateSensor()
+{
+	QProgressDialog progress( "Simulating the sensor...", QString(), 0, 0, this );
+	progress.setWindowTitle( "Sensor Simulation" );
+
+	SensorSimulationResult result;
+	RunWithProgress( progress, [&]()
+	{
+		result = m_grays.SimulateSensor( m_sensorModel, m_sensorResolution, m_sensorSamples );
+	} );
+
+	QString report = QString( "%1\n\nSamples: %2\nExact: %3\nAt sector edges: %4\nFailures: %5 (%6 unknown readings)\nWorst error: %7 deg\n" )
+		.arg( result.passed ? "Decodes correctly." : "Decode errors found." )
+		.arg( result.sampleCount )
+		.arg( result.exact )
+		.arg( result.boundary )
+		.arg( result.failures )
+		.arg( result.invalidReadings )
+		.arg( result.maxErrorDeg, 0, 'f', 3 );
+
+	if ( !result.passed && result.firstFailure != SensorSimulationResult::NoIndex )
+	{
+		report += QString( "First failure at: %1 deg\n" ).arg( result.firstFailureDeg, 0, 'f', 3 );
+	}
+
+	report += QString( "\n%1 threads%2, %3 ms" )
+		.arg( result.threadsUsed )
+		.arg( result.usedAvx2 ? ", AVX2" : "" )
+		.arg( result.elapsedMs, 0, 'f', 1 );
+
+	QMessageBox::information( this, "Sensor Simulation", report );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::onToleranceAnalysis()
+{
+	QProgressDialog progress( "Running tolerance trials...", QString(), 0, 0, this );
+	progress.setWindowTitle( "Tolerance Analysis" );
+
+	ToleranceResult result;
+	RunWithProgress( progress, [&]()
+	{
+		result = m_grays.AnalyseTolerances( m_toleranceModel, m_toleranceRun );
+	} );
+
+	QString histogram;
+	for ( size_t bucket = 0; bucket < result.errorHistogram.size(); ++bucket )
+	{
+		histogram += QString( "  %1%2 sectors: %3\n" )
+			.arg( bucket )
+			.arg( bucket + 1 == result.errorHistogram.size() ? "+" : "" )
+			.arg( result.errorHistogram[bucket] );
+	}
+
+	QString report = QString( "Yield: %1% (%2 of %3 discs failed)\n\nSamples: %4\nExact: %5\nAt sector edges: %6\nFailures: %7 (%8 unknown readings)\nWorst error: %9 deg\n" )
+		.arg( result.yield * 100.0, 0, 'f', 2 )
+		.arg( result.failedTrials )
+		.arg( result.trials )
+		.arg( result.sampleCount )
+		.arg( result.exact )
+		.arg( result.boundary )
+		.arg( result.failures )
+		.arg( result.invalidReadings )
+		.arg( result.maxErrorDeg, 0, 'f', 3 );
+
+	if ( result.worstTrial != ToleranceResult::NoTrial )
+	{
+		report += QString( "Worst disc: trial %1, %2 failures\n" ).arg( result.worstTrial ).arg( result.worstTrialFailures );
+	}
+
+	report += QString( "\nError histogram:\n%1\n%2 threads, %3 ms, %4 M samples/s" )
+		.arg( histogram )
+		.arg( result.threadsUsed )
+		.arg( result.elapsedMs, 0, 'f', 1 )
+		.arg( result.samplesPerSecond * 1e-6, 0, 'f', 2 );
+
+	QMessageBox::information( this, "Tolerance Analysis", report );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::onExportFirmware()
+{
+	const FirmwareTables tables = m_grays.GenerateFirmwareTables( m_firmwareOptions );
+	if ( !tables.valid )
+	{
+		QMessageBox::warning( this, "Export Firmware Header", m_firmwareOptions.trackOffsets.empty() ? "The selected decoder can't be generated for this code." :
+			"The selected decoder can't be generated for this code, or the track offsets make two positions read the same." );
+		return;
+	}
+
+	const QString fileName = QFileDialog::getSaveFileName( this, "Export Firmware Header", "grays_decode.h", "C/C++ Header (*.h)" );
+	if ( fileName.isEmpty() )
+	{
+		return;
+	}
+
+	std::ofstream file( fileName.toStdWString(), std::ios::binary );
+	file << tables.header;
+
+	if ( !file )
+	{
+		QMessageBox::warning( this, "Export Firmware Header", "Couldn't write " + fileName );
+		return;
+	}
+
+	QString report = QString( "Wrote %1 decoder.\n\n" ).arg( FirmwareTableGenerator::GetDecoderName( tables.chosen ) );
+	for ( size_t decoder = underlying_cast( FirmwareDecoder::Lookup ); decoder < tables.variants.size(); ++decoder )
+	{
+		const FirmwareVariantReport& variant = tables.variants[decoder];
+		if ( variant.available )
+		{
+			report += QString( "%1: %2 bytes, ~%3 cycles\n" )
+				.arg( FirmwareTableGenerator::GetDecoderName( variant.decoder ) )
+				.arg( variant.tableBytes )
+				.arg( variant.estimatedCycles );
+		}
+	}
+
+	QMessageBox::information( this, "Export Firmware Header", report );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::onExportImage()
+{
+	const QString fileName = QFileDialog::getSaveFileName( this, "Export Image", m_exportOptions.format == ExportFormat::Png ? "encoder.png" : "encoder.tif", TiledExporter::GetFormatFilter( m_exportOptions.format ) );
+	if ( fileName.isEmpty() )
+	{
+		return;
+	}
+
+	QProgressDialog progress( "Exporting...", "Cancel", 0, 1000, this );
+	progress.setWindowTitle( "Export Image" );
+
+	std::atomic<int> permille = 0;
+	std::atomic<bool> cancel = false;
+	connect( &progress, &QProgressDialog::canceled, [&cancel]()
+	{
+		cancel = true;
+	} );
+
+	ExportResult result;
+	RunWithProgress( progress, [&]()
+	{
+		result = m_grays.Export( fileName.toStdWString(), m_exportOptions, [&]( uint64_t done, uint64_t total )
+		{
+			permille = static_cast<int>( done * 1000 / total );
+			return !cancel;
+		} );
+	}, &permille );
+
+	if ( result.cancelled )
+	{
+		return;
+	}
+
+	if ( !result.success )
+	{
+		QMessageBox::warning( this, "Export Image", QString( "Couldn't write %1\n\n%2" ).arg( fileName ).arg( QString::fromStdString( result.error ) ) );
+		return;
+	}
+
+	const QString report = QString( "%1 x %2 %3, %4 tiles\n%5 MB written, %6 MB peak buffers\n\n%7 threads, %8 ms" )
+		.arg( result.width )
+		.arg( result.height )
+		.arg( TiledExporter::GetFormatName( m_exportOptions.format ) )
+		.arg( result.tiles )
+		.arg( result.bytesWritten / 1048576.0, 0, 'f', 1 )
+		.arg( result.peakBufferBytes / 1048576.0, 0, 'f', 1 )
+		.arg( result.threadsUsed )
+		.arg( result.elapsedMs, 0, 'f', 0 );
+
+	QMessageBox::information( this, "Export Image", report );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::onExportFrameTrace()
+{
+	const QString fileName = QFileDialog::getSaveFileName( this, "Export Frame Trace", "frame_trace.json", "Chrome Trace (*.json)" );
+	if ( fileName.isEmpty() )
+	{
+		return;
+	}
+
+	const FrameProfiler& profiler = m_canvas.GetProfiler();
+	if ( !profiler.ExportChromeTrace( fileName.toStdWString() ) )
+	{
+		QMessageBox::warning( this, "Export Frame Trace", QString( "Couldn't write %1" ).arg( fileName ) );
+		return;
+	}
+
+	QString report = QString( "%1 frames written, open in chrome://tracing or ui.perfetto.dev." ).arg( profiler.GetFrameCount() );
+
+	//blend2d's own timeline goes next to it, its clock starts when recording was turned on.
+	if ( m_blend2dTrace )
+	{
+		std::filesystem::path blend2dPath( fileName.toStdWString() );
+		blend2dPath.replace_filename( blend2dPath.stem().wstring() + L"_blend2d.json" );
+
+		BLString events;
+		BLRuntime::stopTrace();
+		const bool written = BLRuntime::exportTrace( &events ) == BL_SUCCESS && std::ofstream( blend2dPath, std::ios::binary ).write( events.data(), events.size() ).good();
+		BLRuntime::startTrace();
+
+		report += written
+			? QString( "\nBlend2D trace written to %1." ).arg( QString::fromStdWString( blend2dPath.wstring() ) )
+			: QString( "\nCouldn't write the Blend2D trace to %1." ).arg( QString::fromStdWString( blend2dPath.wstring() ) );
+	}
+
+	QMessageBox::information( this, "Export Frame Trace", report );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void WindowMain::onBenchmarkBulkDecode()
+{
+	//64M samples, a quarter of a gigabyte of readings.
+	const BulkDecodeBenchmark bench = BulkDecoder::Benchmark( m_grays.GetGrayNumber(), uint64_t( 1 ) << 26 );
+
+	const QString report = QString( "%1 bit readings, %2 samples\n\nScalar: %3 M/s\n%4, 1 thread: %5 M/s\n%4, %6 threads: %7 M/s\n\n%8" )
+		.arg( bench.bitCount )
+		.arg( bench.count )
+		.arg( bench.scalarSingle, 0, 'f', 1 )
+		.arg( bench.usedAvx2 ? "AVX2" : "Scalar blocks" )
+		.arg( bench.simdSingle, 0, 'f', 1 )
+		.arg( bench.threadsUsed )
+		.arg( bench.simdThreaded, 0, 'f', 1 )
+		.arg( bench.matches ? "All paths agree with the scalar reference." : "Paths DISAGREE with the scalar reference." );
+
+	QMessageBox::information( this, "Bulk Decoder Benchmark", report );
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 void WindowMain::onAbout()
@@ -30,13 +30,21 @@ SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 #include <QtWidgets/QMainWindow>
+#include <atomic>
+#include <functional>
 #include "ui_window_main.h"
 #include "render/blend_2d_render_widget.h"
 #include "application/grays_encoder.h"
 #include "application/printing.h"
+#include "application/core/render_thread_tuner.h"
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+// Forwards
+//------------------------------------------------------------------------------
+class QProgressDialog;
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 // WindowMain
@@ -51,6 +59,12 @@ public:
 
 private slots:
 	void onOpenPrintDialog();
+	void onSimulateSensor();
+	void onToleranceAnalysis();
+	void onExportFirmware();
+	void onExportImage();
+	void onBenchmarkBulkDecode();
+	void onExportFrameTrace();
 	void onAbout();
 
 private:
@@ -58,6 +72,11 @@ private:
 	void InitMenus();
 	void InitMenuBar();
 	void InitGraysConfig();
+	// Family searches can take seconds, so they run on a worker behind a busy dialog.
+	void ChangeCode( CodeFamilyType family, int bitCount, uint32_t period );
+	// Runs work on a worker while the modal progress dialog keeps the window responsive.
+	// value, when given, is polled into the dialog.
+	void RunWithProgress( QProgressDialog& progress, const std::function<void()>& work, const std::atomic<int>* value = nullptr );
 
 	//Configuration Changed
 	void OnGrayChanged( const QVariant& qvr );
@@ -65,11 +84,50 @@ private:
 	void OnOuterRadiusChanged( const QVariant& qvr );
 	void OnEndianChanged( const QVariant& qvr );
 	void OnInstrumentationChanged( const QVariant& qvr );
+	void OnFrameStatsChanged( const QVariant& qvr );
+	void OnPreviewQualityChanged( const QVariant& qvr );
+	void OnBlend2DTraceChanged( const QVariant& qvr );
+	void OnCodeFamilyChanged( const QVariant& qvr );
+	void OnSingleTrackPeriodChanged( const QVariant& qvr );
+	void OnLayoutChanged( const QVariant& qvr );
+	void OnLinearLengthChanged( const QVariant& qvr );
+	void OnLinearHeightChanged( const QVariant& qvr );
+	void OnIncrementalLinesChanged( const QVariant& qvr );
+	void OnIncrementalWidthChanged( const QVariant& qvr );
+	void OnQuadraturePhaseChanged( const QVariant& qvr );
+	void OnIndexTrackChanged( const QVariant& qvr );
+	void OnSensorResolutionChanged( const QVariant& qvr );
+	void OnSensorApertureChanged( const QVariant& qvr );
+	void OnSensorRadialOffsetChanged( const QVariant& qvr );
+	void OnSensorAngularOffsetChanged( const QVariant& qvr );
+	void OnSensorSamplesChanged( const QVariant& qvr );
+	void OnToleranceTrialsChanged( const QVariant& qvr );
+	void OnToleranceEccentricityChanged( const QVariant& qvr );
+	void OnToleranceScaleChanged( const QVariant& qvr );
+	void OnToleranceBleedChanged( const QVariant& qvr );
+	void OnToleranceSensorChanged( const QVariant& qvr );
+	void OnToleranceJitterChanged( const QVariant& qvr );
+	void OnFirmwareDecoderChanged( const QVariant& qvr );
+	void OnFirmwareWaitStatesChanged( const QVariant& qvr );
+	void OnFirmwarePolarityChanged( const QVariant& qvr );
+	void OnFirmwareZeroOffsetChanged( const QVariant& qvr );
+	void OnFirmwareTrackOffsetsChanged( const QVariant& qvr );
+	void OnExportFormatChanged( const QVariant& qvr );
+	void OnExportDepthChanged( const QVariant& qvr );
+	void OnExportResolutionChanged( const QVariant& qvr );
+	void OnExportTileSizeChanged( const QVariant& qvr );
+	void OnMonoPackingChanged( const QVariant& qvr );
 
 private:
 	//menu
     Ui::window_main_Class ui;
 	QAction* m_actionPrint = nullptr;
+	QAction* m_actionSimulate = nullptr;
+	QAction* m_actionTolerance = nullptr;
+	QAction* m_actionFirmware = nullptr;
+	QAction* m_actionExportImage = nullptr;
+	QAction* m_actionBenchmarkDecode = nullptr;
+	QAction* m_actionFrameTrace = nullptr;
 	QAction* m_actionAbout = nullptr;
 
 	//application
@@ -77,4 +135,22 @@ private:
 	PropertyPanel m_propertyPanel;
 	Blend2DRenderWidget m_canvas;
 	PrintingService m_printingService;
+	RenderThreadTuner m_threadTuner;
+	bool m_blend2dTrace = false;
+
+	//sensor simulation
+	SensorModel m_sensorModel;
+	double m_sensorResolution = 8.0;
+	uint32_t m_sensorSamples = 16;
+
+	//tolerance analysis
+	ToleranceModel m_toleranceModel;
+	ToleranceRun m_toleranceRun;
+
+	//firmware export
+	void UpdateFirmwareCalibration();
+	FirmwareOptions m_firmwareOptions;
+
+	//image export
+	ExportOptions m_exportOptions;
 };
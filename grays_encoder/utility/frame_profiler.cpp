@@ -0,0 +1,337 @@
+/*------------------------------------------------------------------------------
+	()      File:   frame_profiler.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Frame stage percentiles and Chrome trace export.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include "utility/frame_profiler.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	// Nearest rank percentile of an ascending list.
+	//------------------------------------------------------------------------------
+	double Percentile( const std::vector<double>& sorted, double fraction )
+	{
+		const size_t rank = static_cast<size_t>( fraction * (sorted.size() - 1) + 0.5 );
+		return sorted[std::min( rank, sorted.size() - 1 )];
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// FrameProfiler
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+FrameProfiler::FrameProfiler()
+	: m_epoch( clock::now() )
+{
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void FrameProfiler::BeginFrame( uint32_t threads )
+{
+	m_current = FrameRecord();
+	m_current.index = m_frameIndex++;
+	m_current.threads = threads;
+	m_current.stageBeginUs[size_t( FrameStage::Frame )] = std::chrono::duration<double, std::micro>( clock::now() - m_epoch ).count();
+	m_inFrame = true;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void FrameProfiler::EndFrame()
+{
+	if ( !m_inFrame )
+	{
+		return;
+	}
+
+	const double nowUs = std::chrono::duration<double, std::micro>( clock::now() - m_epoch ).count();
+	m_current.stageUs[size_t( FrameStage::Frame )] = nowUs - m_current.stageBeginUs[size_t( FrameStage::Frame )];
+
+	m_frames[m_next] = m_current;
+	m_next = (m_next + 1) % Capacity;
+	m_count = std::min( m_count + 1, Capacity );
+	m_inFrame = false;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool FrameProfiler::InFrame() const
+{
+	return m_inFrame;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void FrameProfiler::AddStage( FrameStage stage, clock::time_point begin, clock::time_point end )
+{
+	if ( !m_inFrame )
+	{
+		return;
+	}
+
+	const size_t slot = size_t( stage );
+	if ( m_current.stageUs[slot] == 0.0 )
+	{
+		m_current.stageBeginUs[slot] = std::chrono::duration<double, std::micro>( begin - m_epoch ).count();
+	}
+
+	m_current.stageUs[slot] += std::chrono::duration<double, std::micro>( end - begin ).count();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void FrameProfiler::AddCount( FrameCounter counter, uint64_t count /*= 1*/ )
+{
+	m_current.counters[size_t( counter )] += count;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void FrameProfiler::SetUtilisation( double utilisation )
+{
+	m_current.utilisation = std::clamp( utilisation, 0.0, 1.0 );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const FrameRecord* FrameProfiler::GetLastFrame() const
+{
+	return m_count == 0 ? nullptr : &GetFrame( 0 );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+StageStats FrameProfiler::GetStageStats( FrameStage stage ) const
+{
+	std::vector<double> times;
+	times.reserve( m_count );
+
+	for ( size_t age = 0; age < m_count; ++age )
+	{
+		const double us = GetFrame( age ).stageUs[size_t( stage )];
+		if ( us > 0.0 )
+		{
+			times.push_back( us / 1000.0 );
+		}
+	}
+
+	StageStats stats;
+	if ( times.empty() )
+	{
+		return stats;
+	}
+
+	std::sort( times.begin(), times.end() );
+
+	stats.samples = static_cast<uint32_t>( times.size() );
+	stats.p50Ms = Percentile( times, 0.50 );
+	stats.p90Ms = Percentile( times, 0.90 );
+	stats.p99Ms = Percentile( times, 0.99 );
+	stats.maxMs = times.back();
+	return stats;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+size_t FrameProfiler::GetFrameCount() const
+{
+	return m_count;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void FrameProfiler::Clear()
+{
+	m_next = 0;
+	m_count = 0;
+	m_inFrame = false;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool FrameProfiler::ExportChromeTrace( const std::filesystem::path& path ) const
+{
+	std::ofstream file( path, std::ios::binary );
+	if ( !file )
+	{
+		return false;
+	}
+
+	char line[256];
+	bool first = true;
+
+	const auto emit = [&]()
+	{
+		file << (first ? "\n\t" : ",\n\t") << line;
+		first = false;
+	};
+
+	file << "{ \"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+	//oldest first, trace viewers expect rising timestamps.
+	for ( size_t age = m_count; age-- > 0; )
+	{
+		const FrameRecord& frame = GetFrame( age );
+
+		for ( uint32_t stage = 0; stage < uint32_t( FrameStage::Count ); ++stage )
+		{
+			if ( frame.stageUs[stage] <= 0.0 )
+			{
+				continue;
+			}
+
+			snprintf( line, sizeof( line ), "{ \"name\": \"%s\", \"cat\": \"frame\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": 1, \"args\": { \"frame\": %llu } }",
+				GetStageName( FrameStage( stage ) ),
+				frame.stageBeginUs[stage],
+				frame.stageUs[stage],
+				static_cast<unsigned long long>( frame.index ) );
+			emit();
+		}
+
+		snprintf( line, sizeof( line ), "{ \"name\": \"counters\", \"ph\": \"C\", \"ts\": %.3f, \"pid\": 1, \"args\": { \"%s\": %llu, \"%s\": %llu, \"utilisation\": %.3f, \"threads\": %u } }",
+			frame.stageBeginUs[size_t( FrameStage::Frame )],
+			GetCounterName( FrameCounter::Arcs ), static_cast<unsigned long long>( frame.counters[size_t( FrameCounter::Arcs )] ),
+			GetCounterName( FrameCounter::Commands ), static_cast<unsigned long long>( frame.counters[size_t( FrameCounter::Commands )] ),
+			frame.utilisation,
+			frame.threads );
+		emit();
+	}
+
+	file << "\n] }\n";
+	return file.good();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+double FrameProfiler::GetProcessCpuMs()
+{
+#if defined(_WIN32)
+	FILETIME creation, exit, kernel, user;
+	if ( !GetProcessTimes( GetCurrentProcess(), &creation, &exit, &kernel, &user ) )
+	{
+		return 0.0;
+	}
+
+	//100ns ticks.
+	const uint64_t kernelTicks = (uint64_t( kernel.dwHighDateTime ) << 32) | kernel.dwLowDateTime;
+	const uint64_t userTicks = (uint64_t( user.dwHighDateTime ) << 32) | user.dwLowDateTime;
+	return (kernelTicks + userTicks) / 10000.0;
+#else
+	timespec ts{};
+	clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts );
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const char* FrameProfiler::GetStageName( FrameStage stage )
+{
+	switch ( stage )
+	{
+	case FrameStage::Frame: return "Frame";
+	case FrameStage::Generate: return "Generate";
+	case FrameStage::Build: return "Build";
+	case FrameStage::Rasterize: return "Rasterize";
+	case FrameStage::Blit: return "Blit";
+	case FrameStage::Count: break;
+	}
+
+	return "Unknown";
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const char* FrameProfiler::GetCounterName( FrameCounter counter )
+{
+	switch ( counter )
+	{
+	case FrameCounter::Arcs: return "arcs";
+	case FrameCounter::Commands: return "commands";
+	case FrameCounter::Count: break;
+	}
+
+	return "unknown";
+}
+
+//------------------------------------------------------------------------------
+// Age 0 is the newest finished frame.
+//------------------------------------------------------------------------------
+const FrameRecord& FrameProfiler::GetFrame( size_t age ) const
+{
+	return m_frames[(m_next + Capacity - 1 - age) % Capacity];
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ScopedStageTimer
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ScopedStageTimer::ScopedStageTimer( FrameProfiler* profiler, FrameStage stage )
+	: m_profiler( profiler != nullptr && profiler->InFrame() ? profiler : nullptr )
+	, m_stage( stage )
+{
+	if ( m_profiler )
+	{
+		m_begin = FrameProfiler::clock::now();
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ScopedStageTimer::~ScopedStageTimer()
+{
+	if ( m_profiler )
+	{
+		m_profiler->AddStage( m_stage, m_begin, FrameProfiler::clock::now() );
+	}
+}
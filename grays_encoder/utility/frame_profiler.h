@@ -0,0 +1,161 @@
+/*------------------------------------------------------------------------------
+	()      File:   frame_profiler.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Scoped stage timers and a ring buffer of frame timings.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class FrameStage : uint32_t
+{
+	Frame,		// Whole frame, render buffer update through the blit.
+	Generate,	// Pattern generation, only when the code was invalidated.
+	Build,		// Path building and command submission inside Render.
+	Rasterize,	// Waiting for blend2d to finish, ctx.end().
+	Blit,		// QPainter::drawImage in paintEvent.
+
+	Count
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+enum class FrameCounter : uint32_t
+{
+	Arcs,		// Arc segments emitted.
+	Commands,	// Artwork fill and stroke calls handed to the context.
+
+	Count
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct FrameRecord
+{
+	uint64_t index = 0;
+	uint32_t threads = 0;
+	// CPU time over wall time times threads while rasterizing, 0..1.
+	double utilisation = 0.0;
+
+	// Microseconds since the profiler was created, stages that didn't run are 0.
+	std::array<double, size_t( FrameStage::Count )> stageBeginUs = {};
+	std::array<double, size_t( FrameStage::Count )> stageUs = {};
+	std::array<uint64_t, size_t( FrameCounter::Count )> counters = {};
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct StageStats
+{
+	uint32_t samples = 0;
+	double p50Ms = 0.0;
+	double p90Ms = 0.0;
+	double p99Ms = 0.0;
+	double maxMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// FrameProfiler
+//	Keeps the last Capacity frames in a ring buffer. Timing a stage is two
+//	steady_clock reads and an add, so it can stay on in release builds.
+//	Not thread safe, every stage is timed from the GUI thread.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class FrameProfiler
+{
+public:
+	using clock = std::chrono::steady_clock;
+	static constexpr size_t Capacity = 256;
+
+	FrameProfiler();
+
+	void BeginFrame( uint32_t threads );
+	void EndFrame();
+	bool InFrame() const;
+
+	void AddStage( FrameStage stage, clock::time_point begin, clock::time_point end );
+	void AddCount( FrameCounter counter, uint64_t count = 1 );
+	void SetUtilisation( double utilisation );
+
+	// Null until the first frame ends.
+	const FrameRecord* GetLastFrame() const;
+	// Percentiles over the frames in the ring where the stage ran.
+	StageStats GetStageStats( FrameStage stage ) const;
+	size_t GetFrameCount() const;
+	void Clear();
+
+	// Complete events per stage and counter tracks, for chrome://tracing or Perfetto.
+	bool ExportChromeTrace( const std::filesystem::path& path ) const;
+
+	// Process CPU time across all threads.
+	static double GetProcessCpuMs();
+	static const char* GetStageName( FrameStage stage );
+	static const char* GetCounterName( FrameCounter counter );
+
+private:
+	const FrameRecord& GetFrame( size_t age ) const;
+
+private:
+	clock::time_point m_epoch;
+	std::array<FrameRecord, Capacity> m_frames;
+	size_t m_next = 0;
+	size_t m_count = 0;
+	uint64_t m_frameIndex = 0;
+
+	FrameRecord m_current;
+	bool m_inFrame = false;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// ScopedStageTimer
+//	Adds the scope's duration to the current frame. A null profiler, or one
+//	outside a frame, makes it a no-op so render code can time unconditionally.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class ScopedStageTimer
+{
+public:
+	ScopedStageTimer( FrameProfiler* profiler, FrameStage stage );
+	~ScopedStageTimer();
+
+	ScopedStageTimer( const ScopedStageTimer& ) = delete;
+	ScopedStageTimer& operator=( const ScopedStageTimer& ) = delete;
+
+private:
+	FrameProfiler* m_profiler;
+	FrameStage m_stage;
+	FrameProfiler::clock::time_point m_begin;
+};
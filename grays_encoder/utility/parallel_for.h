@@ -0,0 +1,104 @@
+/*------------------------------------------------------------------------------
+	()      File:   parallel_for.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Minimal fork/join helpers used by the generation and analysis engines.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <blend2d.h>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// parallel
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+namespace parallel
+{
+	//------------------------------------------------------------------------------
+	// Number of hardware threads as reported by the blend2d runtime.
+	//------------------------------------------------------------------------------
+	inline uint32_t HardwareThreadCount()
+	{
+		BLRuntimeSystemInfo info{};
+		BLRuntime::querySystemInfo( &info );
+		return std::max( info.threadCount, 1u );
+	}
+
+	//------------------------------------------------------------------------------
+	// True if the host can run the AVX2 paths.
+	//------------------------------------------------------------------------------
+	inline bool HasAvx2()
+	{
+		BLRuntimeSystemInfo info{};
+		BLRuntime::querySystemInfo( &info );
+		return (info.cpuFeatures & BL_RUNTIME_CPU_FEATURE_X86_AVX2) != 0;
+	}
+
+	//------------------------------------------------------------------------------
+	// Splits [0, count) into one contiguous chunk per worker and calls
+	// fn( begin, end, workerIndex ) for each. 0 threads means one per core.
+	// The calling thread runs the first chunk itself.
+	//------------------------------------------------------------------------------
+	template<class Fn>
+	uint32_t ForRange( uint64_t count, uint32_t threads, Fn&& fn )
+	{
+		if ( threads == 0 )
+		{
+			threads = HardwareThreadCount();
+		}
+
+		threads = static_cast<uint32_t>( std::max<uint64_t>( 1, std::min<uint64_t>( threads, count ) ) );
+
+		const uint64_t chunk = (count + threads - 1) / threads;
+
+		std::vector<std::thread> workers;
+		workers.reserve( threads - 1 );
+
+		for ( uint32_t worker = 1; worker < threads; ++worker )
+		{
+			const uint64_t begin = std::min( count, chunk * worker );
+			const uint64_t end = std::min( count, begin + chunk );
+
+			workers.emplace_back( [&fn, begin, end, worker]() { fn( begin, end, worker ); } );
+		}
+
+		fn( 0, std::min( count, chunk ), 0u );
+
+		for ( std::thread& worker : workers )
+		{
+			worker.join();
+		}
+
+		return threads;
+	}
+}
@@ -0,0 +1,228 @@
+/*------------------------------------------------------------------------------
+	()      File:   pipeline_cache.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Saves and pre-compiles blend2d JIT pipeline signatures.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <blend2d.h>
+#include "utility/pipeline_cache.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	// Signatures are only meaningful to the blend2d build and CPU features that made them.
+	//------------------------------------------------------------------------------
+	struct CacheKey
+	{
+		uint64_t version = 0;
+		uint64_t buildType = 0;
+		uint64_t cpuFeatures = 0;
+
+		bool operator==( const CacheKey& other ) const
+		{
+			return version == other.version && buildType == other.buildType && cpuFeatures == other.cpuFeatures;
+		}
+	};
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	CacheKey GetRuntimeKey()
+	{
+		BLRuntimeBuildInfo buildInfo{};
+		BLRuntimeSystemInfo systemInfo{};
+		BLRuntime::queryBuildInfo( &buildInfo );
+		BLRuntime::querySystemInfo( &systemInfo );
+
+		CacheKey key;
+		key.version = buildInfo.version;
+		key.buildType = buildInfo.buildType;
+		key.cpuFeatures = systemInfo.cpuFeatures;
+		return key;
+	}
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	std::vector<uint32_t> GetRuntimeSignatures()
+	{
+		size_t count = 0;
+		BLRuntime::queryPipelineSignatures( nullptr, 0, &count );
+
+		std::vector<uint32_t> signatures( count );
+		BLRuntime::queryPipelineSignatures( signatures.data(), signatures.size(), &count );
+		signatures.resize( std::min( count, signatures.size() ) );
+		return signatures;
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// PipelineCache
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+PipelineCache::~PipelineCache()
+{
+	Wait();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool PipelineCache::IsSupported()
+{
+	size_t count = 0;
+	return BLRuntime::queryPipelineSignatures( nullptr, 0, &count ) == BL_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool PipelineCache::Prewarm( const std::filesystem::path& path )
+{
+	Wait();
+	if ( !Load( path ) )
+	{
+		return false;
+	}
+
+	//compiling takes a lock per pipeline only, rendering can start meanwhile.
+	m_thread = std::thread( [this]()
+	{
+		using clock = std::chrono::steady_clock;
+		const clock::time_point start = clock::now();
+
+		size_t compiled = 0;
+		BLRuntime::compilePipelines( m_signatures.data(), m_signatures.size(), &compiled );
+
+		m_prewarmed = compiled;
+		m_prewarmMs = std::chrono::duration<double, std::milli>( clock::now() - start ).count();
+	} );
+
+	return true;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void PipelineCache::Wait()
+{
+	if ( m_thread.joinable() )
+	{
+		m_thread.join();
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool PipelineCache::Load( const std::filesystem::path& path )
+{
+	m_signatures.clear();
+
+	std::ifstream file( path );
+	if ( !file )
+	{
+		return false;
+	}
+
+	CacheKey key;
+	std::vector<uint32_t> signatures;
+
+	std::string name;
+	uint64_t value = 0;
+	while ( file >> name >> value )
+	{
+		if ( name == "version" )
+		{
+			key.version = value;
+		}
+		else if ( name == "buildType" )
+		{
+			key.buildType = value;
+		}
+		else if ( name == "cpuFeatures" )
+		{
+			key.cpuFeatures = value;
+		}
+		else if ( name == "signature" && value <= UINT32_MAX )
+		{
+			signatures.push_back( static_cast<uint32_t>( value ) );
+		}
+	}
+
+	if ( !(key == GetRuntimeKey()) )
+	{
+		return false;
+	}
+
+	m_signatures = std::move( signatures );
+	return !m_signatures.empty();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool PipelineCache::Save( const std::filesystem::path& path )
+{
+	Wait();
+
+	std::vector<uint32_t> signatures = GetRuntimeSignatures();
+	signatures.insert( signatures.end(), m_signatures.begin(), m_signatures.end() );
+	std::sort( signatures.begin(), signatures.end() );
+	signatures.erase( std::unique( signatures.begin(), signatures.end() ), signatures.end() );
+
+	//nothing new since the file was loaded.
+	if ( signatures.size() == m_signatures.size() )
+	{
+		return true;
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories( path.parent_path(), error );
+
+	std::ofstream file( path, std::ios::trunc );
+	if ( !file )
+	{
+		return false;
+	}
+
+	const CacheKey key = GetRuntimeKey();
+	file << "version " << key.version << "\n";
+	file << "buildType " << key.buildType << "\n";
+	file << "cpuFeatures " << key.cpuFeatures << "\n";
+	for ( const uint32_t signature : signatures )
+	{
+		file << "signature " << signature << "\n";
+	}
+
+	m_signatures = std::move( signatures );
+	return static_cast<bool>( file );
+}
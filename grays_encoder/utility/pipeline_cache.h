@@ -0,0 +1,89 @@
+/*------------------------------------------------------------------------------
+	()      File:   pipeline_cache.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Saves and pre-compiles blend2d JIT pipeline signatures.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <thread>
+#include <vector>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// PipelineCache
+//	Remembers which blend2d JIT pipelines earlier runs compiled, so the next
+//	run can compile them on a background thread while it starts up instead
+//	of stalling the first frame. Only signatures are stored, machine code is
+//	always compiled by the running process. A file written by another blend2d
+//	build or on a CPU with other features is ignored.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class PipelineCache
+{
+public:
+	~PipelineCache();
+
+	// Only blend2d's JIT compiles pipelines, a build without AsmJit has nothing to cache.
+	static bool IsSupported();
+
+	// Loads the saved signatures and starts compiling them, returns false if there are none.
+	bool Prewarm( const std::filesystem::path& path );
+	void Wait();
+
+	// Adds the pipelines this run compiled, only writes when there are new ones.
+	bool Save( const std::filesystem::path& path );
+
+	inline size_t GetPrewarmedCount() const;
+	inline double GetPrewarmMs() const;
+
+private:
+	bool Load( const std::filesystem::path& path );
+
+	std::vector<uint32_t> m_signatures;
+	std::thread m_thread;
+	std::atomic<size_t> m_prewarmed = 0;
+	std::atomic<double> m_prewarmMs = 0.0;
+};
+
+//------------------------------------------------------------------------------
+// Inline for PipelineCache
+//------------------------------------------------------------------------------
+
+inline size_t PipelineCache::GetPrewarmedCount() const
+{
+	return m_prewarmed;
+}
+
+inline double PipelineCache::GetPrewarmMs() const
+{
+	return m_prewarmMs;
+}
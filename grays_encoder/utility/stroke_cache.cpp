@@ -0,0 +1,200 @@
+/*------------------------------------------------------------------------------
+	()      File:   stroke_cache.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Keeps stroked outlines so unchanged geometry skips the stroker.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include "utility/stroke_cache.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	// FNV-1a over the raw bytes, keys are a few doubles.
+	//------------------------------------------------------------------------------
+	template<class T>
+	uint64_t HashValue( uint64_t hash, const T& value )
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>( &value );
+		for ( size_t i = 0; i < sizeof( value ); ++i )
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	//------------------------------------------------------------------------------
+	// Keys compare doubles with ==, so -0.0 has to hash like 0.0.
+	//------------------------------------------------------------------------------
+	uint64_t HashDouble( uint64_t hash, double value )
+	{
+		return HashValue( hash, value == 0.0 ? 0.0 : value );
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// StrokeCache
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+BLResult StrokeCache::Stroke( BLContext& ctx, const StrokedPath& stroked )
+{
+	if ( !stroked.outlined )
+	{
+		return ctx.strokePath( stroked.path );
+	}
+
+	//the stroker's sides are joined into one figure, non-zero covers what strokePath would.
+	BLStyle style;
+	ctx.getStrokeStyle( style );
+	const double alpha = ctx.strokeAlpha();
+
+	ctx.save();
+	ctx.setFillStyle( style );
+	ctx.setFillAlpha( alpha );
+	ctx.setFillRule( BL_FILL_RULE_NON_ZERO );
+	const BLResult result = ctx.fillPath( stroked.outline );
+	ctx.restore();
+
+	return result;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void StrokeCache::Clear()
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	m_entries.clear();
+}
+
+//------------------------------------------------------------------------------
+// Strokes made in the transformed space depend on the matrix, dashes are left
+// to the context too.
+//------------------------------------------------------------------------------
+bool StrokeCache::IsCacheable( const BLStrokeOptions& options )
+{
+	return options.transformOrder == BL_STROKE_TRANSFORM_ORDER_AFTER && options.dashArray.empty();
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool StrokeCache::Find( const EntryKey& key, StrokedPath& stroked )
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+
+	const auto it = m_entries.find( key );
+	if ( it == m_entries.end() )
+	{
+		return false;
+	}
+
+	stroked = it->second;
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Strokes outside the lock, two tiles missing on the same shape both stroke it.
+//------------------------------------------------------------------------------
+void StrokeCache::Insert( const EntryKey& key, StrokedPath& stroked )
+{
+	//the stroker has no notion of quality, only production outlines match what the context strokes.
+	if ( key.quality == BL_APPROXIMATION_QUALITY_PRODUCTION )
+	{
+		stroked.outlined = stroked.outline.addStrokedPath( stroked.path, key.options, key.approx ) == BL_SUCCESS;
+		if ( !stroked.outlined )
+		{
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if ( m_entries.size() >= MaxEntries )
+	{
+		m_entries.clear();
+	}
+
+	m_entries.insert_or_assign( key, stroked );
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// StrokeCache::EntryKey
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool StrokeCache::EntryKey::operator==( const EntryKey& other ) const
+{
+	return key.shape == other.key.shape &&
+		key.params == other.key.params &&
+		quality == other.quality &&
+		options.startCap == other.options.startCap &&
+		options.endCap == other.options.endCap &&
+		options.join == other.options.join &&
+		options.transformOrder == other.options.transformOrder &&
+		options.width == other.options.width &&
+		options.miterLimit == other.options.miterLimit &&
+		options.dashOffset == other.options.dashOffset &&
+		approx.flattenMode == other.approx.flattenMode &&
+		approx.offsetMode == other.approx.offsetMode &&
+		approx.flattenTolerance == other.approx.flattenTolerance &&
+		approx.simplifyTolerance == other.approx.simplifyTolerance &&
+		approx.offsetParameter == other.approx.offsetParameter;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+size_t StrokeCache::EntryHash::operator()( const EntryKey& key ) const
+{
+	uint64_t hash = 14695981039346656037ull;
+	hash = HashValue( hash, key.key.shape );
+	for ( const double param : key.key.params )
+	{
+		hash = HashDouble( hash, param );
+	}
+
+	hash = HashValue( hash, key.quality );
+	hash = HashValue( hash, key.options.startCap );
+	hash = HashValue( hash, key.options.endCap );
+	hash = HashValue( hash, key.options.join );
+	hash = HashValue( hash, key.options.transformOrder );
+	hash = HashDouble( hash, key.options.width );
+	hash = HashDouble( hash, key.options.miterLimit );
+	hash = HashDouble( hash, key.options.dashOffset );
+	hash = HashValue( hash, key.approx.flattenMode );
+	hash = HashValue( hash, key.approx.offsetMode );
+	hash = HashDouble( hash, key.approx.flattenTolerance );
+	hash = HashDouble( hash, key.approx.simplifyTolerance );
+	hash = HashDouble( hash, key.approx.offsetParameter );
+	return static_cast<size_t>( hash );
+}
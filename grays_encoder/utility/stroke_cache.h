@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------------
+	()      File:   stroke_cache.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Keeps stroked outlines so unchanged geometry skips the stroker.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <blend2d.h>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// StrokedPath
+//	A path together with the outline blend2d's stroker made for it. Without an
+//	outline the stroke is left to the context.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+struct StrokedPath
+{
+	BLPath path;
+	BLPath outline;
+	bool outlined = false;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// StrokeCache
+//	Keeps shapes that are drawn every frame with their stroked outline, keyed
+//	by what the shape was built from and the stroke options, so a hit skips
+//	building the path as well as the stroker. The outline is filled with the
+//	stroke style, which rasterizes the same edges strokePath would. Outlines
+//	are in user space, so only strokes transformed after stroking (the default)
+//	are cached and the matrix can change freely between frames. Preview quality
+//	strokes keep the path only, the context strokes them coarser than the
+//	stroker would. Thread safe, tiles of an export stroke the same shapes.
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+class StrokeCache
+{
+public:
+	// What a shape is built from, shape tells apart builders taking the same parameters.
+	struct Key
+	{
+		uint32_t shape = 0;
+		std::array<double, 4> params = {};
+	};
+
+	// Returns the shape for the context's stroke options, build( BLPath& ) only runs on a miss.
+	template<class BuildFn>
+	StrokedPath Get( BLContext& ctx, const Key& key, BuildFn build );
+	// Same result as ctx.strokePath( stroked.path ).
+	BLResult Stroke( BLContext& ctx, const StrokedPath& stroked );
+	void Clear();
+
+	inline size_t GetSize() const;
+
+private:
+	struct EntryKey
+	{
+		Key key;
+		BLStrokeOptions options;
+		BLApproximationOptions approx;
+		uint32_t quality;
+
+		bool operator==( const EntryKey& other ) const;
+	};
+
+	struct EntryHash
+	{
+		size_t operator()( const EntryKey& key ) const;
+	};
+
+	static bool IsCacheable( const BLStrokeOptions& options );
+	bool Find( const EntryKey& key, StrokedPath& stroked );
+	void Insert( const EntryKey& key, StrokedPath& stroked );
+
+	// Drops everything past this, shapes that change every frame shouldn't grow the cache forever.
+	static constexpr size_t MaxEntries = 4096;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<EntryKey, StrokedPath, EntryHash> m_entries;
+};
+
+//------------------------------------------------------------------------------
+// Inline for StrokeCache
+//------------------------------------------------------------------------------
+
+template<class BuildFn>
+StrokedPath StrokeCache::Get( BLContext& ctx, const Key& key, BuildFn build )
+{
+	StrokedPath stroked;
+	if ( !IsCacheable( ctx.strokeOptions() ) )
+	{
+		build( stroked.path );
+		return stroked;
+	}
+
+	const EntryKey entryKey = { key, ctx.strokeOptions(), ctx.approximationOptions(), ctx.hints().approximationQuality };
+	if ( !Find( entryKey, stroked ) )
+	{
+		build( stroked.path );
+		Insert( entryKey, stroked );
+	}
+
+	return stroked;
+}
+
+inline size_t StrokeCache::GetSize() const
+{
+	std::lock_guard<std::mutex> lock( m_mutex );
+	return m_entries.size();
+}
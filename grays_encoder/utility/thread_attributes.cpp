@@ -0,0 +1,268 @@
+/*------------------------------------------------------------------------------
+	()      File:   thread_attributes.cpp
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Render worker thread affinity and priority options.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstdlib>
+#include "utility/thread_attributes.h"
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+namespace
+{
+	//------------------------------------------------------------------------------
+	// Parses "0-3,8,10-11" into the cpu mask, false on anything else.
+	//------------------------------------------------------------------------------
+	bool ParseCpuList( const std::string& text, BLRuntimeThreadAttributes& attributes )
+	{
+		const char* cursor = text.c_str();
+		bool any = false;
+
+		while ( *cursor != '\0' )
+		{
+			char* end = nullptr;
+			const unsigned long first = strtoul( cursor, &end, 10 );
+			if ( end == cursor )
+			{
+				return false;
+			}
+
+			unsigned long last = first;
+			cursor = end;
+			if ( *cursor == '-' )
+			{
+				last = strtoul( ++cursor, &end, 10 );
+				if ( end == cursor || last < first )
+				{
+					return false;
+				}
+				cursor = end;
+			}
+
+			if ( last >= BL_RUNTIME_MAX_AFFINITY_CPU_COUNT )
+			{
+				return false;
+			}
+
+			for ( unsigned long cpu = first; cpu <= last; ++cpu )
+			{
+				attributes.addCpu( static_cast<uint32_t>( cpu ) );
+			}
+			any = true;
+
+			if ( *cursor == ',' )
+			{
+				++cursor;
+			}
+			else if ( *cursor != '\0' )
+			{
+				return false;
+			}
+		}
+
+		return any;
+	}
+
+	//------------------------------------------------------------------------------
+	// Formats the mask back into the shortest cpu list.
+	//------------------------------------------------------------------------------
+	std::string FormatCpuList( const BLRuntimeThreadAttributes& attributes )
+	{
+		std::string text;
+		uint32_t cpu = 0;
+
+		while ( cpu < BL_RUNTIME_MAX_AFFINITY_CPU_COUNT )
+		{
+			if ( !attributes.hasCpu( cpu ) )
+			{
+				++cpu;
+				continue;
+			}
+
+			uint32_t last = cpu;
+			while ( last + 1 < BL_RUNTIME_MAX_AFFINITY_CPU_COUNT && attributes.hasCpu( last + 1 ) )
+			{
+				++last;
+			}
+
+			text += text.empty() ? "" : ",";
+			text += std::to_string( cpu );
+			if ( last != cpu )
+			{
+				text += "-" + std::to_string( last );
+			}
+			cpu = last + 1;
+		}
+
+		return text;
+	}
+
+	const char* const PriorityNames[BL_RUNTIME_THREAD_PRIORITY_COUNT] = { "default", "lowest", "below", "normal", "above", "highest" };
+	const char* const PolicyNames[BL_RUNTIME_THREAD_SCHED_POLICY_COUNT] = { "default", "normal", "batch", "idle" };
+
+	//------------------------------------------------------------------------------
+	//------------------------------------------------------------------------------
+	template<size_t N>
+	bool FindName( const char* const (&names)[N], const std::string& name, uint32_t& index )
+	{
+		for ( uint32_t i = 1; i < N; ++i )
+		{
+			if ( name == names[i] )
+			{
+				index = i;
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// parallel
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool parallel::ParseThreadAttributes( const std::vector<std::string>& args, BLRuntimeThreadAttributes& attributes )
+{
+	attributes.reset();
+	bool found = false;
+
+	for ( size_t i = 1; i + 1 < args.size(); ++i )
+	{
+		const std::string& option = args[i];
+		const std::string& value = args[i + 1];
+		bool valid = true;
+
+		if ( option == "render-cpus" || option == "render-pin" )
+		{
+			valid = ParseCpuList( value, attributes );
+			if ( valid )
+			{
+				attributes.affinity = option == "render-pin" ? BL_RUNTIME_THREAD_AFFINITY_PIN : BL_RUNTIME_THREAD_AFFINITY_CPU_SET;
+			}
+		}
+		else if ( option == "render-numa" )
+		{
+			char* end = nullptr;
+			const long node = strtol( value.c_str(), &end, 10 );
+			valid = !value.empty() && *end == '\0' && node >= 0;
+			if ( valid )
+			{
+				attributes.numaNode = static_cast<int32_t>( node );
+			}
+		}
+		else if ( option == "render-priority" )
+		{
+			valid = FindName( PriorityNames, value, attributes.priority );
+		}
+		else if ( option == "render-policy" )
+		{
+			valid = FindName( PolicyNames, value, attributes.schedPolicy );
+		}
+		else
+		{
+			continue;
+		}
+
+		if ( valid )
+		{
+			found = true;
+		}
+		else
+		{
+			fprintf( stderr, "ignoring %s %s\n", option.c_str(), value.c_str() );
+		}
+		++i;
+	}
+
+	return found;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool parallel::ConfigureThreadAttributes( const std::vector<std::string>& args )
+{
+	BLRuntimeThreadAttributes attributes;
+	if ( !ParseThreadAttributes( args, attributes ) )
+	{
+		return false;
+	}
+
+	if ( BLRuntime::setThreadAttributes( attributes ) != BL_SUCCESS )
+	{
+		fprintf( stderr, "render thread attributes rejected, unknown numa node or no cpus left\n" );
+		return false;
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string parallel::DescribeThreadAttributes()
+{
+	BLRuntimeThreadingInfo info;
+	if ( BLRuntime::queryThreadingInfo( &info ) != BL_SUCCESS )
+	{
+		return std::string();
+	}
+
+	const BLRuntimeThreadAttributes& attributes = info.attributes;
+	std::string text;
+
+	if ( attributes.affinity != BL_RUNTIME_THREAD_AFFINITY_NONE )
+	{
+		text += attributes.affinity == BL_RUNTIME_THREAD_AFFINITY_PIN ? "pinned " : "cpus ";
+		text += FormatCpuList( attributes );
+		if ( attributes.numaNode >= 0 )
+		{
+			text += " (node " + std::to_string( attributes.numaNode ) + ")";
+		}
+		if ( info.affinityFailed != 0 )
+		{
+			text += ", " + std::to_string( info.affinityFailed ) + " failed";
+		}
+	}
+
+	if ( attributes.priority != BL_RUNTIME_THREAD_PRIORITY_DEFAULT || attributes.schedPolicy != BL_RUNTIME_THREAD_SCHED_POLICY_DEFAULT )
+	{
+		text += text.empty() ? "" : ", ";
+		text += std::string( "priority " ) + PriorityNames[attributes.priority] + ", policy " + PolicyNames[attributes.schedPolicy];
+		if ( info.priorityFailed != 0 )
+		{
+			text += ", " + std::to_string( info.priorityFailed ) + " failed";
+		}
+	}
+
+	return text;
+}
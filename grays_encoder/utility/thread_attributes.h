@@ -0,0 +1,66 @@
+/*------------------------------------------------------------------------------
+	()      File:   thread_attributes.h
+	/\      Copyright (c) 2021 Andrew Woodward-May
+   //\\
+  //  \\    Description:
+				Render worker thread affinity and priority options.
+------------------------------
+------------------------------
+License Text - The MIT License
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in the
+Software without restriction, including without limitation the rights to use, copy,
+modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+------------------------------------------------------------------------------*/
+#pragma once
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#include <string>
+#include <vector>
+#include <blend2d.h>
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// parallel
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+namespace parallel
+{
+	//------------------------------------------------------------------------------
+	// Reads the render thread options from the command line,
+	//   render-cpus <list>		restrict workers to a cpu list, "0-3,8"
+	//   render-pin <list>		pin each worker to one cpu of the list, round robin
+	//   render-numa <node>		restrict workers to the cpus of a numa node
+	//   render-priority <p>	lowest, below, normal, above or highest
+	//   render-policy <p>		normal, batch or idle
+	// Returns false if none were given, bad values are reported and skipped.
+	//------------------------------------------------------------------------------
+	bool ParseThreadAttributes( const std::vector<std::string>& args, BLRuntimeThreadAttributes& attributes );
+
+	//------------------------------------------------------------------------------
+	// Parses and applies the options to blend2d's worker threads, which only
+	// affects workers created afterwards so call it before the first render.
+	//------------------------------------------------------------------------------
+	bool ConfigureThreadAttributes( const std::vector<std::string>& args );
+
+	//------------------------------------------------------------------------------
+	// One line summary of the applied attributes, empty if none were set.
+	//------------------------------------------------------------------------------
+	std::string DescribeThreadAttributes();
+}
@@ -49,6 +49,13 @@
 // not supported at all.
 // ----------------------------------------------------------------------------
 
+// ----------------------------------------------------------------------------
+// #define BL_BUILD_NO_TRACE
+//
+// Compiles out trace scopes recorded by `blRuntimeStartTrace()`. Implied by
+// BL_BUILD_NO_TLS as trace rings are stored per thread.
+// ----------------------------------------------------------------------------
+
 // ----------------------------------------------------------------------------
 // #define BL_BUILD_NO_INTRINSICS
 //
@@ -97,8 +104,10 @@
   #endif
 #endif
 
+// Windows 7 is required by processor group affinity and NUMA node queries
+// used by the thread-pool (SetThreadGroupAffinity, GetNumaNodeProcessorMaskEx).
 #if defined(_WIN32) && !defined(_WIN32_WINNT)
-  #define _WIN32_WINNT 0x0600
+  #define _WIN32_WINNT 0x0601
 #endif
 
 // The FileSystem API works fully with 64-bit file sizes and offsets,
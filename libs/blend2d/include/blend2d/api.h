@@ -642,6 +642,8 @@ BL_DEFINE_STRUCT(BLFileCore);
 BL_DEFINE_STRUCT(BLRuntimeBuildInfo);
 BL_DEFINE_STRUCT(BLRuntimeSystemInfo);
 BL_DEFINE_STRUCT(BLRuntimeResourceInfo);
+BL_DEFINE_STRUCT(BLRuntimeThreadAttributes);
+BL_DEFINE_STRUCT(BLRuntimeThreadingInfo);
 
 BL_DEFINE_STRUCT(BLStringCore);
 BL_DEFINE_STRUCT(BLStringImpl);
@@ -721,6 +723,7 @@ BL_DEFINE_STRUCT(BLContextImpl);
 BL_DEFINE_STRUCT(BLContextVirt);
 BL_DEFINE_STRUCT(BLContextCookie);
 BL_DEFINE_STRUCT(BLContextCreateInfo);
+BL_DEFINE_STRUCT(BLContextWorkerStats);
 BL_DEFINE_STRUCT(BLContextHints);
 BL_DEFINE_STRUCT(BLContextState);
 
@@ -2052,6 +2055,12 @@ BL_API BLResult BL_CDECL blRuntimeInit() BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL blRuntimeShutdown() BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL blRuntimeCleanup(uint32_t cleanupFlags) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL blRuntimeQueryInfo(uint32_t infoType, void* infoOut) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL blRuntimeSetThreadAttributes(const BLRuntimeThreadAttributes* attributes) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL blRuntimeQueryPipelineSignatures(uint32_t* signaturesOut, size_t capacity, size_t* countOut) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL blRuntimeCompilePipelines(const uint32_t* signatures, size_t count, size_t* compiledOut) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL blRuntimeStartTrace(uint32_t eventsPerThread) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL blRuntimeStopTrace(void) BL_NOEXCEPT_C;
+BL_API BLResult BL_CDECL blRuntimeExportTrace(BLStringCore* out) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL blRuntimeMessageOut(const char* msg) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL blRuntimeMessageFmt(const char* fmt, ...) BL_NOEXCEPT_C;
 BL_API BLResult BL_CDECL blRuntimeMessageVFmt(const char* fmt, va_list ap) BL_NOEXCEPT_C;
@@ -68,6 +68,8 @@ BL_DEFINE_ENUM(BLContextHint) {
   BL_CONTEXT_HINT_GRADIENT_QUALITY = 1,
   //! Pattern quality.
   BL_CONTEXT_HINT_PATTERN_QUALITY = 2,
+  //! Approximation quality.
+  BL_CONTEXT_HINT_APPROXIMATION_QUALITY = 3,
 
   //! Count of rendering context hints.
   BL_CONTEXT_HINT_COUNT = 8
@@ -296,6 +298,69 @@ BL_DEFINE_ENUM(BLRenderingQuality) {
   BL_RENDERING_QUALITY_COUNT = 1
 };
 
+//! Approximation quality.
+//!
+//! Scales the tolerances used to flatten curves and to simplify them when
+//! stroking. The flattening tolerance applies in device space, so the result
+//! of a coarser quality depends on the current zoom.
+BL_DEFINE_ENUM(BLApproximationQuality) {
+  //! Use the approximation options as they are.
+  BL_APPROXIMATION_QUALITY_PRODUCTION = 0,
+  //! Coarser approximation for interactive previews. The flattening tolerance
+  //! is 4 times larger and the stroker's simplification tolerance follows it
+  //! in device space, so fewer edges are generated.
+  BL_APPROXIMATION_QUALITY_PREVIEW = 1,
+
+  //! Count of approximation quality options.
+  BL_APPROXIMATION_QUALITY_COUNT = 2
+};
+
+// ============================================================================
+// [BLContext - WorkerStats]
+// ============================================================================
+
+//! Statistics of a single thread used by asynchronous rendering.
+//!
+//! Counters are collected only when `BLContextCreateInfo::workerStats` is
+//! provided. They cover the whole lifetime of the rendering context and are
+//! written to the array each time the rendering context is flushed with
+//! `BL_CONTEXT_FLUSH_SYNC`, which includes `BLContext::end()`.
+struct BLContextWorkerStats {
+  //! Index of the thread, 0 is the user thread, workers start at 1.
+  uint32_t workerId;
+  //! Number of batches the thread participated in.
+  uint32_t batchCount;
+
+  //! Number of jobs processed (building edges of asynchronous commands).
+  uint64_t jobCount;
+  //! Number of bands processed.
+  uint64_t bandCount;
+  //! Number of commands processed, a command spanning multiple bands is
+  //! counted once per band.
+  uint64_t commandCount;
+  //! Number of spans passed to fill pipelines.
+  uint64_t spanCount;
+  //! Number of pixel rows covered by spans passed to fill pipelines.
+  uint64_t rowCount;
+
+  //! Time spent processing jobs, in nanoseconds.
+  uint64_t jobTimeNs;
+  //! Time spent processing commands outside of pipelines, which is mostly
+  //! rasterization, in nanoseconds.
+  uint64_t rasterTimeNs;
+  //! Time spent in fill pipelines, which fetch and composite pixels, in
+  //! nanoseconds.
+  uint64_t fillTimeNs;
+  //! Time spent waiting for other threads in a batch, in nanoseconds.
+  uint64_t waitTimeNs;
+
+  // --------------------------------------------------------------------------
+  #ifdef __cplusplus
+  BL_INLINE void reset() noexcept { memset(this, 0, sizeof(*this)); }
+  #endif
+  // --------------------------------------------------------------------------
+};
+
 // ============================================================================
 // [BLContext - CreateInfo]
 // ============================================================================
@@ -322,13 +387,31 @@ struct BLContextCreateInfo {
 
   //! Maximum number of commands to be queued.
   //!
-  //! If this parameter is zero the queue size will be determined automatically.
+  //! Asynchronous rendering serializes commands into batches. Once a batch
+  //! reaches this limit worker threads start processing it while the user
+  //! thread continues serializing the next batch, so the user thread and the
+  //! workers overlap instead of running in series. The last batch is processed
+  //! by flush or `end()`, where the user thread acts as a worker too.
   //!
-  //! TODO: To be documented, has no effect at the moment.
+  //! If this parameter is zero the queue size will be determined automatically,
+  //! which doesn't limit the queue at all if the rendering context has no worker
+  //! threads. Small limits are rounded up to a reasonable minimum.
   uint32_t commandQueueLimit;
 
+  //! Number of entries in `workerStats`.
+  uint32_t workerStatsCapacity;
+
   //! Reserved for future use, must be zero.
-  uint32_t reserved[4];
+  uint32_t reserved[3];
+
+  //! Array that receives per-thread statistics of asynchronous rendering, see
+  //! `BLContextWorkerStats`, can be null.
+  //!
+  //! Statistics are only collected when this array is provided. The user thread
+  //! is always stored first followed by worker threads, entries not used by the
+  //! rendering context are zeroed. The array must outlive the rendering context.
+  //! Synchronous rendering contexts don't write to the array.
+  BLContextWorkerStats* workerStats;
 
   // --------------------------------------------------------------------------
   #ifdef __cplusplus
@@ -392,6 +475,7 @@ struct BLContextHints {
       uint8_t renderingQuality;
       uint8_t gradientQuality;
       uint8_t patternQuality;
+      uint8_t approximationQuality;
     };
 
     uint8_t hints[BL_CONTEXT_HINT_COUNT];
@@ -927,6 +1011,7 @@ public:
   BL_INLINE BLResult setRenderingQuality(uint32_t value) noexcept { return setHint(BL_CONTEXT_HINT_RENDERING_QUALITY, value); }
   BL_INLINE BLResult setGradientQuality(uint32_t value) noexcept { return setHint(BL_CONTEXT_HINT_GRADIENT_QUALITY, value); }
   BL_INLINE BLResult setPatternQuality(uint32_t value) noexcept { return setHint(BL_CONTEXT_HINT_PATTERN_QUALITY, value); }
+  BL_INLINE BLResult setApproximationQuality(uint32_t value) noexcept { return setHint(BL_CONTEXT_HINT_APPROXIMATION_QUALITY, value); }
 
   //! \}
 
@@ -42,6 +42,12 @@
 static constexpr const double BL_CONTEXT_MINIMUM_TOLERANCE = 0.01;
 static constexpr const double BL_CONTEXT_MAXIMUM_TOLERANCE = 0.50;
 
+//! Flattening tolerance scale of each `BLApproximationQuality`.
+static constexpr const double blApproximationQualityToleranceScale[BL_APPROXIMATION_QUALITY_COUNT] = {
+  1.0, // BL_APPROXIMATION_QUALITY_PRODUCTION
+  4.0  // BL_APPROXIMATION_QUALITY_PREVIEW
+};
+
 // ============================================================================
 // [Utilities]
 // ============================================================================
@@ -137,7 +137,11 @@ BL_DEFINE_ENUM(BLFileReadFlags) {
   //! Do not fallback to regular read if memory mapping fails. It's worth noting
   //! that memory mapping would fail for files stored on filesystem that is not
   //! local (like a mounted network filesystem, etc...).
-  BL_FILE_READ_MMAP_NO_FALLBACK = 0x00000008u
+  BL_FILE_READ_MMAP_NO_FALLBACK = 0x00000008u,
+
+  //! Memory map files that are not small and fallback to a regular read
+  //! otherwise, which is what image and font loaders use by default.
+  BL_FILE_READ_MMAP_DEFAULT = BL_FILE_READ_MMAP_ENABLED | BL_FILE_READ_MMAP_AVOID_SMALL
 };
 
 // ============================================================================
@@ -370,6 +370,40 @@ struct BLFixedPipe_Composite_PRGB32_Src_Solid {
   }
 };
 
+struct BLFixedPipe_Composite_A8_Src_Solid {
+  enum : uint32_t { DST_BPP = 1 };
+
+  uint32_t src;
+
+  BL_INLINE BLFixedPipe_Composite_A8_Src_Solid(const void* fetchData_) noexcept {
+    src = static_cast<const BLPipeFetchData::Solid*>(fetchData_)->prgb32 >> 24;
+  }
+
+  BL_INLINE uint8_t* compositePixelOpaque(uint8_t* dstPtr) noexcept {
+    *dstPtr = uint8_t(src);
+    return dstPtr + DST_BPP;
+  }
+
+  BL_INLINE uint8_t* compositePixelMasked(uint8_t* dstPtr, uint32_t m) noexcept {
+    uint32_t d = *dstPtr;
+    *dstPtr = uint8_t(blUdiv255(src * m + d * (255 - m)));
+    return dstPtr + DST_BPP;
+  }
+
+  BL_INLINE uint8_t* compositeSpanOpaque(uint8_t* dstPtr, uint32_t w) noexcept {
+    memset(dstPtr, int(src), w);
+    return dstPtr + w;
+  }
+
+  BL_INLINE uint8_t* compositeSpanCMask(uint8_t* dstPtr, uint32_t w, uint32_t m) noexcept {
+    uint32_t i = w;
+    do {
+      dstPtr = compositePixelMasked(dstPtr, m);
+    } while (--i);
+    return dstPtr;
+  }
+};
+
 // ============================================================================
 // [BLFixedPipeRuntime]
 // ============================================================================
@@ -379,13 +413,17 @@ static BLPipeFillFunc BL_CDECL blPipeGenRuntimeGet(BLPipeRuntime* self_, uint32_
   BLPipeFillFunc func = nullptr;
 
   BLPipeSignature s(signature);
+  bool dstA8 = s.dstFormat() == BL_FORMAT_A8;
+
   switch (s.fillType()) {
     case BL_PIPE_FILL_TYPE_BOX_A:
-      func = BLFixedPipe_FillBoxA_Base<BLFixedPipe_Composite_PRGB32_Src_Solid>::pipeline;
+      func = dstA8 ? BLFixedPipe_FillBoxA_Base<BLFixedPipe_Composite_A8_Src_Solid>::pipeline
+                   : BLFixedPipe_FillBoxA_Base<BLFixedPipe_Composite_PRGB32_Src_Solid>::pipeline;
       break;
 
     case BL_PIPE_FILL_TYPE_ANALYTIC:
-      func = BLFixedPipe_FillAnalytic_Base<BLFixedPipe_Composite_PRGB32_Src_Solid>::pipeline;
+      func = dstA8 ? BLFixedPipe_FillAnalytic_Base<BLFixedPipe_Composite_A8_Src_Solid>::pipeline
+                   : BLFixedPipe_FillAnalytic_Base<BLFixedPipe_Composite_PRGB32_Src_Solid>::pipeline;
       break;
 
     default:
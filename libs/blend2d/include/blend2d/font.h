@@ -25,6 +25,7 @@
 #define BLEND2D_FONT_H_INCLUDED
 
 #include "./array.h"
+#include "./filesystem.h"
 #include "./fontdefs.h"
 #include "./geometry.h"
 #include "./glyphbuffer.h"
@@ -143,8 +144,8 @@ public:
   //! (determined by Blend2D), and would fallback to a regular open/read in case the
   //! memory mapping is not possible or failed for some other reason. Please note that
   //! not all files can be memory mapped so `BL_FILE_READ_MMAP_NO_FALLBACK` flag is not
-  //! recommended.
-  BL_INLINE BLResult createFromFile(const char* fileName, uint32_t readFlags = 0) noexcept {
+  //! recommended. `BL_FILE_READ_MMAP_DEFAULT` is used when no flags are given.
+  BL_INLINE BLResult createFromFile(const char* fileName, uint32_t readFlags = BL_FILE_READ_MMAP_DEFAULT) noexcept {
     return blFontDataCreateFromFile(this, fileName, readFlags);
   }
 
@@ -362,7 +363,7 @@ public:
   //! as it allows to specify a `faceIndex`, which can be used to load multiple
   //! font-faces from a TrueType/OpenType collection. The use of `createFromData()`
   //! is recommended for any serious font handling.
-  BL_INLINE BLResult createFromFile(const char* fileName, uint32_t readFlags = 0) noexcept {
+  BL_INLINE BLResult createFromFile(const char* fileName, uint32_t readFlags = BL_FILE_READ_MMAP_DEFAULT) noexcept {
     return blFontFaceCreateFromFile(this, fileName, readFlags);
   }
 
@@ -510,8 +510,9 @@ BLResult blImageScale(BLImageCore* dst, const BLImageCore* src, const BLSizeI* s
 // ============================================================================
 
 BLResult blImageReadFromFile(BLImageCore* self, const char* fileName, const BLArrayCore* codecs) noexcept {
+  // Decoders only read from the buffer, so a mapped file is consumed in place.
   BLArray<uint8_t> buffer;
-  BL_PROPAGATE(BLFileSystem::readFile(fileName, buffer));
+  BL_PROPAGATE(BLFileSystem::readFile(fileName, buffer, 0, BL_FILE_READ_MMAP_DEFAULT));
 
   if (buffer.empty())
     return blTraceError(BL_ERROR_FILE_EMPTY);
@@ -28,6 +28,7 @@
 #include "./runtime_p.h"
 #include "./string_p.h"
 #include "./support_p.h"
+#include "./trace_p.h"
 #include "./codec/bmpcodec_p.h"
 #include "./codec/jpegcodec_p.h"
 #include "./codec/pngcodec_p.h"
@@ -311,6 +312,8 @@ BLResult blImageDecoderReadInfo(BLImageDecoderCore* self, BLImageInfo* infoOut,
 }
 
 BLResult blImageDecoderReadFrame(BLImageDecoderCore* self, BLImageCore* imageOut, const uint8_t* data, size_t size) noexcept {
+  BL_TRACE_SCOPE(trace, "codec.decode", size);
+
   BLImageDecoderImpl* impl = self->impl;
   return impl->virt->readFrame(impl, imageOut, data, size);
 }
@@ -385,8 +388,13 @@ BLResult blImageEncoderRestart(BLImageEncoderCore* self) noexcept {
 }
 
 BLResult blImageEncoderWriteFrame(BLImageEncoderCore* self, BLArrayCore* dst, const BLImageCore* src) noexcept {
+  BL_TRACE_SCOPE(trace, "codec.encode");
+
   BLImageEncoderImpl* impl = self->impl;
-  return impl->virt->writeFrame(impl, dst, src);
+  BLResult result = impl->virt->writeFrame(impl, dst, src);
+
+  BL_TRACE_SET_ARG(trace, blArrayGetSize(dst));
+  return result;
 }
 
 // ============================================================================
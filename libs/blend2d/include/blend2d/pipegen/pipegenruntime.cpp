@@ -30,6 +30,7 @@
 #include "../pipegen/fillpart_p.h"
 #include "../pipegen/pipecompiler_p.h"
 #include "../pipegen/pipegenruntime_p.h"
+#include "../trace_p.h"
 
 // ============================================================================
 // [Globals]
@@ -83,22 +84,39 @@ static void BL_CDECL blPipeGenRuntimeDestroy(BLPipeRuntime* self_) noexcept {
   self->~BLPipeGenRuntime();
 }
 
+// Compiles `signature` and adds it to the cache. Another thread can compile the
+// same signature in the meantime (pipelines are compiled without holding the
+// lock), in that case the function cached first wins and the other is released.
+static BLPipeFillFunc blPipeGenRuntimeCompileAndCache(BLPipeGenRuntime* self, uint32_t signature) noexcept {
+  BL_TRACE_SCOPE(trace, "pipeline.compile", signature);
+
+  BLPipeFillFunc func = self->_compileFillFunc(signature);
+  if (BL_UNLIKELY(!func))
+    return nullptr;
+
+  BLPipeFillFunc cached = nullptr;
+  BLResult result = self->_mutex.protect([&] {
+    cached = (BLPipeFillFunc)self->_functionCache.get(signature);
+    return cached ? BL_SUCCESS : self->_functionCache.put(signature, (void*)func);
+  });
+
+  if (BL_UNLIKELY(cached || result != BL_SUCCESS)) {
+    self->_jitRuntime.release(func);
+    return cached;
+  }
+
+  self->_pipelineCount++;
+  return func;
+}
+
 static BLPipeFillFunc BL_CDECL blPipeGenRuntimeGet(BLPipeRuntime* self_, uint32_t signature, BLPipeLookupCache* cache) noexcept {
   BLPipeGenRuntime* self = static_cast<BLPipeGenRuntime*>(self_);
   BLPipeFillFunc func = self->_mutex.protectShared([&] { return (BLPipeFillFunc)self->_functionCache.get(signature); });
 
   if (!func) {
-    func = self->_compileFillFunc(signature);
+    func = blPipeGenRuntimeCompileAndCache(self, signature);
     if (BL_UNLIKELY(!func))
       return nullptr;
-
-    BLResult result = self->_mutex.protect([&] { return self->_functionCache.put(signature, (void*)func); });
-    if (BL_UNLIKELY(result != BL_SUCCESS)) {
-      self->_jitRuntime.release(func);
-      return nullptr;
-    }
-
-    self->_pipelineCount++;
   }
 
   if (cache)
@@ -244,6 +262,62 @@ BLPipeFillFunc BLPipeGenRuntime::_compileFillFunc(uint32_t signature) noexcept {
   return func;
 }
 
+// ============================================================================
+// [BLPipeGenRuntime - Signatures]
+// ============================================================================
+
+// Signatures passed to `_compileSignatures()` come from the user (usually read
+// from a file), so they must be checked before they reach the compiler, which
+// only asserts what the rendering context guarantees.
+static bool blPipeGenIsValidSignature(uint32_t signature) noexcept {
+  BLPipeSignature sig(signature);
+  return sig.dstFormat() != BL_FORMAT_NONE &&
+         sig.dstFormat() < BL_FORMAT_INTERNAL_COUNT &&
+         sig.srcFormat() < BL_FORMAT_INTERNAL_COUNT &&
+         sig.compOp() < BL_COMP_OP_INTERNAL_COUNT &&
+         sig.compOp() != BL_COMP_OP_CLEAR &&
+         sig.compOp() != BL_COMP_OP_DST_COPY &&
+         sig.fillType() != BL_PIPE_FILL_TYPE_NONE &&
+         sig.fetchType() < BL_PIPE_FETCH_TYPE_COUNT;
+}
+
+size_t BLPipeGenRuntime::_querySignatures(uint32_t* out, size_t capacity) noexcept {
+  return _mutex.protectShared([&] {
+    const BLZoneHashMap<BLPipeFunctionCache::FuncEntry>& funcMap = _functionCache._funcMap;
+    size_t index = 0;
+
+    for (uint32_t bucket = 0; bucket < funcMap._bucketCount; bucket++) {
+      const BLZoneHashNode* node = funcMap._data[bucket];
+      while (node) {
+        if (index < capacity)
+          out[index] = static_cast<const BLPipeFunctionCache::FuncEntry*>(node)->signature();
+        index++;
+        node = node->_hashNext;
+      }
+    }
+
+    return index;
+  });
+}
+
+size_t BLPipeGenRuntime::_compileSignatures(const uint32_t* signatures, size_t count) noexcept {
+  size_t compiledCount = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t signature = signatures[i];
+    if (!blPipeGenIsValidSignature(signature))
+      continue;
+
+    if (_mutex.protectShared([&] { return _functionCache.get(signature); }))
+      continue;
+
+    if (blPipeGenRuntimeCompileAndCache(this, signature))
+      compiledCount++;
+  }
+
+  return compiledCount;
+}
+
 // ============================================================================
 // [BLPipeGenRuntime - Runtime]
 // ============================================================================
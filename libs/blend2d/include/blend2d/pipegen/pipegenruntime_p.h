@@ -127,6 +127,14 @@ public:
 
   BLPipeFillFunc _compileFillFunc(uint32_t signature) noexcept;
 
+  //! Copies signatures of cached pipelines to `out` (at most `capacity` of them)
+  //! and returns the number of all cached pipelines.
+  size_t _querySignatures(uint32_t* out, size_t capacity) noexcept;
+
+  //! Compiles and caches pipelines of the given `signatures`, skips signatures
+  //! that are invalid or already cached. Returns the number of compiled pipelines.
+  size_t _compileSignatures(const uint32_t* signatures, size_t count) noexcept;
+
   static BLWrap<BLPipeGenRuntime> _global;
 };
 
@@ -23,3 +23,40 @@
 
 #include "./api-build_p.h"
 #include "./piperuntime_p.h"
+
+#if BL_TARGET_ARCH_X86 && !defined(BL_BUILD_NO_JIT)
+  #include "./pipegen/pipegenruntime_p.h"
+#endif
+
+// ============================================================================
+// [BLPipeRuntime - Pipeline Signatures]
+// ============================================================================
+
+// Only the global JIT runtime caches pipelines, fixed pipelines are always
+// available, so there is nothing to query or compile without JIT. Callers are
+// told so they can skip persisting signatures altogether.
+
+BLResult blRuntimeQueryPipelineSignatures(uint32_t* signaturesOut, size_t capacity, size_t* countOut) noexcept {
+#if BL_TARGET_ARCH_X86 && !defined(BL_BUILD_NO_JIT)
+  *countOut = BLPipeGenRuntime::_global->_querySignatures(signaturesOut, capacity);
+  return BL_SUCCESS;
+#else
+  blUnused(signaturesOut, capacity);
+  *countOut = 0;
+  return blTraceError(BL_ERROR_NOT_IMPLEMENTED);
+#endif
+}
+
+BLResult blRuntimeCompilePipelines(const uint32_t* signatures, size_t count, size_t* compiledOut) noexcept {
+#if BL_TARGET_ARCH_X86 && !defined(BL_BUILD_NO_JIT)
+  size_t compiledCount = BLPipeGenRuntime::_global->_compileSignatures(signatures, count);
+  if (compiledOut)
+    *compiledOut = compiledCount;
+  return BL_SUCCESS;
+#else
+  blUnused(signatures, count);
+  if (compiledOut)
+    *compiledOut = 0;
+  return blTraceError(BL_ERROR_NOT_IMPLEMENTED);
+#endif
+}
@@ -30,6 +30,7 @@
 #include "../path_p.h"
 #include "../pipedefs_p.h"
 #include "../support_p.h"
+#include "../trace_p.h"
 #include "../zoneallocator_p.h"
 
 //! \cond INTERNAL
@@ -732,6 +733,87 @@ public:
   }
 };
 
+// ============================================================================
+// [BLFlattenArc]
+// ============================================================================
+
+//! Helper to flatten a cubic curve that represents a circular arc.
+//!
+//! `BLPath` has no arc command, arcs are stored as cubics that span at most
+//! 90 degrees each. Such cubic can be flattened in uniform steps with a segment
+//! count calculated directly from its radius (in fixed-point device space, so
+//! it's scale-aware) instead of being recursively subdivided, which would round
+//! the count of each monotonic part up to a power of 2.
+class BLFlattenArc {
+public:
+  enum : size_t {
+    //! Arcs that would need more segments are subdivided instead.
+    kMaxSegmentCount = 4096,
+    //! Number of points generated at once.
+    kChunkSize = 32
+  };
+
+  //! Returns the number of uniform steps (in `t`) that flatten the cubic `p`
+  //! within `tolerance`, or zero if `p` is not a circular arc.
+  //!
+  //! The cubic is compared with the ideal arc cubic that has the same end points
+  //! and the same (averaged) tangent angle. The distance between their control
+  //! points bounds the distance between both curves, so it's subtracted from the
+  //! tolerance (twice, both vertices and the curve can be off) before the count
+  //! is calculated.
+  static BL_INLINE size_t segmentCount(const BLPoint* p, double tolerance) noexcept {
+    BLPoint chord = p[3] - p[0];
+    double len = blLength(chord);
+
+    // Also rejects NaNs.
+    if (!(len > 0.0))
+      return 0;
+
+    BLPoint u = chord / len;
+    BLPoint a = p[1] - p[0];
+    BLPoint b = p[3] - p[2];
+
+    // Both tangents are mirrored by the chord, `phi` is half of the sweep angle.
+    double along = blDotProduct(u, a) + blDotProduct(u, b);
+    double across = blCrossProduct(u, a) - blCrossProduct(u, b);
+    double tanLen = blSqrt(along * along + across * across);
+
+    if (!(tanLen > 0.0))
+      return 0;
+
+    double cosPhi = along / tanLen;
+    double sinPhi = across / tanLen;
+    double sinPhiAbs = blAbs(sinPhi);
+
+    // Either more than 90 degrees (not produced by `BLPath`) or a straight line.
+    if (cosPhi < BL_M_SQRT_0p5 - 1e-9 || sinPhiAbs < 1e-9)
+      return 0;
+
+    // Handle length of the ideal arc cubic, `4/3 * tan(phi / 2) * radius`.
+    double h = (2.0 / 3.0) * len / (1.0 + cosPhi);
+    BLPoint t0(u.x * cosPhi - u.y * sinPhi, u.y * cosPhi + u.x * sinPhi);
+    BLPoint t1(u.x * cosPhi + u.y * sinPhi, u.y * cosPhi - u.x * sinPhi);
+
+    double diff = blMax(blLength(p[1] - (p[0] + t0 * h)), blLength(p[2] - (p[3] - t1 * h)));
+    double arcTolerance = tolerance - 2.0 * diff;
+
+    if (!(arcTolerance >= tolerance * 0.75))
+      return 0;
+
+    // The largest angle of which the sagitta is within the tolerance.
+    double radius = len / (2.0 * sinPhiAbs);
+    double stepAngle = 2.0 * blAcos(blMax(1.0 - arcTolerance / radius, -1.0));
+
+    // The parametric speed of the arc cubic peaks at its end points where it's
+    // `3h`, so a step of `dt` never sweeps more than `3h / radius * dt` radians.
+    double n = blCeil((3.0 * h / radius) / stepAngle);
+    if (!(n <= double(kMaxSegmentCount)))
+      return 0;
+
+    return blMax<size_t>(size_t(n), 1);
+  }
+};
+
 // ============================================================================
 // [BLEdgeBuilder<>]
 // ============================================================================
@@ -756,6 +838,8 @@ public:
   BLBoxI _clipBoxI;
   //! Curve flattening tolerance
   double _flattenToleranceSq;
+  //! Curve flattening tolerance (not squared), used by `BLFlattenArc`.
+  double _flattenTolerance;
 
   // Shorthands and Working Variables
   // --------------------------------
@@ -854,6 +938,7 @@ public:
                 blTruncToInt(clipBox.x1),
                 blTruncToInt(clipBox.y1)),
       _flattenToleranceSq(toleranceSq),
+      _flattenTolerance(blSqrt(toleranceSq)),
       _bandEdges(nullptr),
       _fixedBandHeightShift(0),
       _signFlip(0),
@@ -875,6 +960,7 @@ public:
 
   BL_INLINE void setFlattenToleranceSq(double toleranceSq) noexcept {
     _flattenToleranceSq = toleranceSq;
+    _flattenTolerance = blSqrt(toleranceSq);
   }
 
   BL_INLINE void begin() noexcept {
@@ -936,6 +1022,8 @@ public:
   }
 
   BL_NOINLINE BLResult addPath(const BLPathView& view, bool closed, const BLMatrix2D& m, uint32_t mType) noexcept {
+    BL_TRACE_SCOPE(trace, "path.flatten", view.size);
+
     if (mType <= BL_MATRIX2D_TYPE_SCALE) {
       BLEdgeSourcePathScale source(BLEdgeTransformScale(m), view);
       return addFromSource(source, closed);
@@ -1772,6 +1860,15 @@ RestartClipLoop:
       BLPoint Pa, Pb, Pc, Pd;
       spline[0] = p0;
 
+      // Circular arc - flattened in uniform steps, clipped by `lineTo()`.
+      size_t arcSegmentCount = BLFlattenArc::segmentCount(spline, _flattenTolerance);
+      if (arcSegmentCount) {
+        BL_PROPAGATE(flattenArc(state, spline, arcSegmentCount));
+        if (!source.maybeNextCubicTo(p1, p2, p3))
+          return BL_SUCCESS;
+        continue;
+      }
+
       double tArray[kMaxTCount];
       size_t tCount = 0;
 
@@ -1882,6 +1979,36 @@ RestartClipLoop:
   // [Curve Utilities]
   // --------------------------------------------------------------------------
 
+  // Flattens a cubic recognized by `BLFlattenArc` into `segmentCount` lines of
+  // equal parametric length. Points are generated in chunks and passed to the
+  // line builder, which handles both clipping and monotonic splitting.
+  BL_NOINLINE BLResult flattenArc(State& state, const BLPoint* spline, size_t segmentCount) noexcept {
+    BLPoint Pa, Pb, Pc, Pd;
+    blGetCubicCoefficients(spline, Pa, Pb, Pc, Pd);
+
+    BLPoint pts[BLFlattenArc::kChunkSize];
+    double dt = 1.0 / double(segmentCount);
+
+    size_t i = 1;
+    while (i <= segmentCount) {
+      size_t n = blMin<size_t>(segmentCount - i + 1, BLFlattenArc::kChunkSize);
+      for (size_t j = 0; j < n; j++) {
+        double t = double(i + j) * dt;
+        pts[j] = ((Pa * t + Pb) * t + Pc) * t + Pd;
+      }
+
+      // The last point must be exact.
+      i += n;
+      if (i > segmentCount)
+        pts[n - 1] = spline[3];
+
+      BLEdgeSourcePoly<BLPoint> polySource(BLEdgeTransformNone(), pts + 1, n - 1);
+      BL_PROPAGATE(lineTo(polySource, state, pts[0]));
+    }
+
+    return BL_SUCCESS;
+  }
+
   template<typename MonoCurveT>
   BL_INLINE BLResult flattenSafeMonoCurve(MonoCurveT& monoCurve, Appender& appender, const BLPoint* src, uint32_t signBit) noexcept {
     monoCurve.begin(src, signBit);
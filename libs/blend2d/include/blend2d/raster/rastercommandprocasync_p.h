@@ -156,6 +156,27 @@ public:
   }
 
   //! \}
+
+  //! \name Fill
+  //! \{
+
+  //! Calls `fillFunc` to fill a span covering `rowCount` pixel rows and records it in work stats.
+  BL_INLINE void fill(BLPipeFillFunc fillFunc, BLPipeFillData* fillData, const void* fetchData, uint32_t rowCount) noexcept {
+    BLRasterWorkData* workData = _workData;
+    workData->stats.spanCount++;
+    workData->stats.rowCount += rowCount;
+
+    if (!workData->collectStats) {
+      fillFunc(&workData->ctxData, fillData, fetchData);
+      return;
+    }
+
+    uint64_t startTime = blRasterWorkTimeNs();
+    fillFunc(&workData->ctxData, fillData, fetchData);
+    workData->stats.fillTimeNs += blRasterWorkTimeNs() - startTime;
+  }
+
+  //! \}
 };
 
 // ============================================================================
@@ -173,7 +194,7 @@ static BL_INLINE bool blRasterCommandProcAsync_FillBoxA(BLRasterCommandProcAsync
     BLPipeFillFunc fillFunc = command.fillFunc();
     const void* fetchData = command.getPipeFetchData();
 
-    fillFunc(&procData.workData()->ctxData, &fillData, fetchData);
+    procData.fill(fillFunc, &fillData, fetchData, uint32_t(y1 - y0));
   }
 
   return command.boxI().y1 <= int(procData.bandY1());
@@ -193,7 +214,7 @@ static BL_INLINE bool blRasterCommandProcAsync_FillBoxU(BLRasterCommandProcAsync
       BLPipeFillFunc fillFunc = command.fillFunc();
       const void* fetchData = command.getPipeFetchData();
 
-      fillFunc(&procData.workData()->ctxData, &fillData, fetchData);
+      procData.fill(fillFunc, &fillData, fetchData, uint32_t((y1 + 0xFF) >> 8) - uint32_t(y0 >> 8));
     }
   }
 
@@ -419,7 +440,7 @@ SaveState:
     fillData.analytic.box.x1 = int(blMin(dstWidth, blAlignUp(ras._cellMaxX + 1, BL_PIPE_PIXELS_PER_ONE_BIT)));
     fillData.analytic.box.y0 = int(ras._bandOffset);
     fillData.analytic.box.y1 = int(ras._bandEnd) + 1;
-    fillFunc(&workData.ctxData, &fillData, fetchData);
+    procData.fill(fillFunc, &fillData, fetchData, uint32_t(fillData.analytic.box.y1 - fillData.analytic.box.y0));
   }
 
   return !edges && !active;
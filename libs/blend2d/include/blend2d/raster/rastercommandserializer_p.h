@@ -66,6 +66,11 @@ struct BLRasterCommandSerializerStorage<BL_RASTER_RENDERING_MODE_ASYNC> {
   BL_INLINE BLResult initStorage(BLRasterContextImpl* ctxI) noexcept {
     BLRasterWorkerManager& mgr = ctxI->workerMgr();
 
+    // Flushing here, before anything of the new command exists, guarantees that
+    // nothing references the batch being flushed.
+    if (BL_UNLIKELY(mgr.isCommandQueueFull()))
+      BL_PROPAGATE(blRasterContextImplFlushQueuedBatch(ctxI));
+
     BL_PROPAGATE(mgr.ensureCommandQueue());
     _command = mgr.currentCommandData();
     ctxI->syncWorkData.saveState();
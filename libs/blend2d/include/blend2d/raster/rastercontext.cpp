@@ -122,6 +122,7 @@ public:
   explicit BL_INLINE BLRasterContextStateAccessor(const BLRasterContextImpl* ctxI) noexcept : ctxI(ctxI) {}
 
   BL_INLINE const BLApproximationOptions& approximationOptions() const noexcept { return ctxI->approximationOptions(); }
+  BL_INLINE uint32_t approximationQuality() const noexcept { return ctxI->hints().approximationQuality; }
   BL_INLINE const BLStrokeOptions& strokeOptions() const noexcept { return ctxI->strokeOptions(); }
 
   BL_INLINE uint8_t metaMatrixFixedType() const noexcept { return ctxI->metaMatrixFixedType(); }
@@ -133,6 +134,7 @@ public:
 
   BL_INLINE const BLBox& finalClipBoxD() const noexcept { return ctxI->finalClipBoxD(); }
   BL_INLINE const BLBox& finalClipBoxFixedD() const noexcept { return ctxI->finalClipBoxFixedD(); }
+  BL_INLINE double toleranceFixedD() const noexcept { return ctxI->internalState.toleranceFixedD; }
 };
 
 // ============================================================================
@@ -161,7 +163,8 @@ static BL_INLINE void blRasterContextImplCompOpChanged(BLRasterContextImpl* ctxI
 }
 
 static BL_INLINE void blRasterContextImplFlattenToleranceChanged(BLRasterContextImpl* ctxI) noexcept {
-  ctxI->internalState.toleranceFixedD = ctxI->approximationOptions().flattenTolerance * ctxI->precisionInfo.fpScaleD;
+  double qualityScale = blApproximationQualityToleranceScale[ctxI->hints().approximationQuality];
+  ctxI->internalState.toleranceFixedD = ctxI->approximationOptions().flattenTolerance * qualityScale * ctxI->precisionInfo.fpScaleD;
   ctxI->syncWorkData.edgeBuilder.setFlattenToleranceSq(blSquare(ctxI->internalState.toleranceFixedD));
 }
 
@@ -753,43 +756,97 @@ static BL_INLINE void blRasterContextImplReleaseFetchQueue(BLRasterContextImpl*
   }
 }
 
-static BL_NOINLINE BLResult blRasterContextImplFlushBatch(BLRasterContextImpl* ctxI) noexcept {
+// Finalizes the current batch and starts worker threads on it. The user thread
+// only acts as a worker when `userThreadIsWorker` is true, in that case the
+// batch is fully processed by the user thread when this function returns.
+static BLRasterWorkBatch* blRasterContextImplStartBatch(BLRasterContextImpl* ctxI, bool userThreadIsWorker) noexcept {
   BLRasterWorkerManager& mgr = ctxI->workerMgr();
-  if (mgr.hasPendingCommands()) {
-    mgr.finalizeBatch();
+  mgr.finalizeBatch();
 
-    uint32_t workerCount = mgr.workerCount();
-    BLRasterWorkBatch* batch = mgr.currentBatch();
+  uint32_t workerCount = mgr.workerCount();
+  BLRasterWorkBatch* batch = mgr.currentBatch();
 
-    BLRasterWorkSynchronization& synchronization = mgr._synchronization;
-    batch->_synchronization = &synchronization;
+  BLRasterWorkSynchronization& synchronization = mgr._synchronization;
+  batch->_synchronization = &synchronization;
 
-    synchronization.jobsRunningCount = workerCount + 1;
-    synchronization.threadsRunningCount = workerCount;
+  synchronization.jobsRunningCount = workerCount + uint32_t(userThreadIsWorker);
+  synchronization.threadsRunningCount = workerCount;
 
-    for (uint32_t i = 0; i < workerCount; i++) {
-      BLThread* thread = mgr._workerThreads[i];
-      BLRasterWorkData* workData = mgr._workDataStorage[i];
+  for (uint32_t i = 0; i < workerCount; i++) {
+    BLThread* thread = mgr._workerThreads[i];
+    BLRasterWorkData* workData = mgr._workDataStorage[i];
 
-      workData->batch = batch;
-      workData->initContextData(ctxI->dstData);
+    workData->batch = batch;
+    workData->initContextData(ctxI->dstData);
 
-      thread->run(blRasterWorkThreadEntry, blRasterWorkThreadDone, workData);
-    }
+    thread->run(blRasterWorkThreadEntry, blRasterWorkThreadDone, workData);
+  }
 
-    // User thread acts as a worker too.
-    {
-      BLRasterWorkData* workData = &ctxI->syncWorkData;
-      workData->batch = batch;
-      blRasterWorkProc(workData);
-    }
+  if (userThreadIsWorker) {
+    BLRasterWorkData* workData = &ctxI->syncWorkData;
+    workData->batch = batch;
+    blRasterWorkProc(workData);
+  }
+
+  return batch;
+}
+
+// Waits for worker threads to finish the given `batch` and releases its fetch data.
+static void blRasterContextImplFinishBatch(BLRasterContextImpl* ctxI, BLRasterWorkBatch* batch) noexcept {
+  BLRasterWorkerManager& mgr = ctxI->workerMgr();
 
-    if (workerCount) {
+  if (mgr.workerCount()) {
+    if (mgr.collectsStats()) {
+      uint64_t waitTime = blRasterWorkTimeNs();
       mgr._synchronization.waitForThreadsToFinish();
-      ctxI->syncWorkData._accumulatedErrorFlags |= blAtomicFetch(&batch->_accumulatedErrorFlags, std::memory_order_relaxed);
+      ctxI->syncWorkData.stats.waitTimeNs += blRasterWorkTimeNs() - waitTime;
     }
+    else {
+      mgr._synchronization.waitForThreadsToFinish();
+    }
+
+    ctxI->syncWorkData._accumulatedErrorFlags |= blAtomicFetch(&batch->_accumulatedErrorFlags, std::memory_order_relaxed);
+  }
+
+  blRasterContextImplReleaseFetchQueue(ctxI, batch->_fetchQueueList.first());
+}
+
+// Stores statistics of the user thread and all workers to the user provided array.
+static void blRasterContextImplStoreWorkerStats(BLRasterContextImpl* ctxI) noexcept {
+  BLRasterWorkerManager& mgr = ctxI->workerMgr();
+  BLContextWorkerStats* dst = mgr._workerStats;
+
+  uint32_t capacity = mgr._workerStatsCapacity;
+  uint32_t count = blMin(mgr.workerCount() + 1u, capacity);
+
+  for (uint32_t i = 0; i < count; i++) {
+    dst[i] = i == 0 ? ctxI->syncWorkData.stats : mgr._workDataStorage[i - 1]->stats;
+    dst[i].workerId = i;
+  }
+
+  for (uint32_t i = count; i < capacity; i++)
+    dst[i].reset();
+}
+
+static BL_NOINLINE BLResult blRasterContextImplFlushBatch(BLRasterContextImpl* ctxI) noexcept {
+  BLRasterWorkerManager& mgr = ctxI->workerMgr();
+  BLRasterWorkBatch* pendingBatch = mgr._pendingBatch;
 
-    blRasterContextImplReleaseFetchQueue(ctxI, batch->_fetchQueueList.first());
+  if (pendingBatch) {
+    blRasterContextImplFinishBatch(ctxI, pendingBatch);
+    mgr._pendingBatch = nullptr;
+  }
+
+  bool hasPendingCommands = mgr.hasPendingCommands();
+  if (hasPendingCommands) {
+    // User thread acts as a worker too.
+    BLRasterWorkBatch* batch = blRasterContextImplStartBatch(ctxI, true);
+    blRasterContextImplFinishBatch(ctxI, batch);
+  }
+
+  // All batches share the allocator and edges built by the user thread, so
+  // they can only be released when no batch is being processed.
+  if (pendingBatch || hasPendingCommands) {
     mgr._allocator.clear();
     mgr.initFirstBatch();
 
@@ -797,6 +854,36 @@ static BL_NOINLINE BLResult blRasterContextImplFlushBatch(BLRasterContextImpl* c
     ctxI->contextFlags &= ~BL_RASTER_CONTEXT_SHARED_ALL_FLAGS;
   }
 
+  // No batch is being processed, so worker stats are stable.
+  if (mgr.collectsStats())
+    blRasterContextImplStoreWorkerStats(ctxI);
+
+  return BL_SUCCESS;
+}
+
+BLResult blRasterContextImplFlushQueuedBatch(BLRasterContextImpl* ctxI) noexcept {
+  BLRasterWorkerManager& mgr = ctxI->workerMgr();
+
+  // Without worker threads there is nothing to overlap with, the batch is
+  // flushed synchronously to keep the memory it uses bounded.
+  if (!mgr.workerCount())
+    return blRasterContextImplFlushBatch(ctxI);
+
+  // Allocate the next batch first so the current one stays intact on failure.
+  BLRasterWorkBatch* nextBatch = mgr.newBatch();
+  if (BL_UNLIKELY(!nextBatch))
+    return blTraceError(BL_ERROR_OUT_OF_MEMORY);
+
+  // Only one batch is processed at a time. Workers process batches in order,
+  // so commands of the next batch never overtake commands of the previous one.
+  if (mgr._pendingBatch)
+    blRasterContextImplFinishBatch(ctxI, mgr._pendingBatch);
+
+  mgr._pendingBatch = blRasterContextImplStartBatch(ctxI, false);
+  mgr.setCurrentBatch(nextBatch);
+
+  // State slots are per batch, shared states must be serialized again.
+  ctxI->contextFlags &= ~BL_RASTER_CONTEXT_SHARED_ALL_FLAGS;
   return BL_SUCCESS;
 }
 
@@ -1007,6 +1094,7 @@ static BLResult BL_CDECL blRasterContextImplRestore(BLContextImpl* baseImpl, con
   }
 
   uint32_t sharedFlagsToKeep = ctxI->contextFlags & BL_RASTER_CONTEXT_SHARED_ALL_FLAGS;
+  uint32_t approximationQuality = ctxI->hints().approximationQuality;
   ctxI->internalState.savedStateCount -= n;
 
   for (;;) {
@@ -1098,6 +1186,14 @@ static BLResult BL_CDECL blRasterContextImplRestore(BLContextImpl* baseImpl, con
       break;
   }
 
+  // Hints are part of the core state, the tolerance depends on one of them.
+  if (ctxI->hints().approximationQuality != approximationQuality) {
+    blRasterContextImplFlattenToleranceChanged(ctxI);
+    sharedFlagsToKeep &= ~(BL_RASTER_CONTEXT_SHARED_FILL_STATE        |
+                           BL_RASTER_CONTEXT_SHARED_STROKE_BASE_STATE |
+                           BL_RASTER_CONTEXT_SHARED_STROKE_EXT_STATE  );
+  }
+
   ctxI->contextFlags &= ~BL_RASTER_CONTEXT_SHARED_ALL_FLAGS;
   ctxI->contextFlags |= sharedFlagsToKeep;
 
@@ -1178,6 +1274,19 @@ static BLResult BL_CDECL blRasterContextImplSetHint(BLContextImpl* baseImpl, uin
       ctxI->internalState.hints.patternQuality = uint8_t(value);
       return BL_SUCCESS;
 
+    case BL_CONTEXT_HINT_APPROXIMATION_QUALITY:
+      if (BL_UNLIKELY(value >= BL_APPROXIMATION_QUALITY_COUNT))
+        return blTraceError(BL_ERROR_INVALID_VALUE);
+
+      if (ctxI->internalState.hints.approximationQuality != value) {
+        ctxI->contextFlags &= ~(BL_RASTER_CONTEXT_SHARED_FILL_STATE        |
+                                BL_RASTER_CONTEXT_SHARED_STROKE_BASE_STATE |
+                                BL_RASTER_CONTEXT_SHARED_STROKE_EXT_STATE  );
+        ctxI->internalState.hints.approximationQuality = uint8_t(value);
+        blRasterContextImplFlattenToleranceChanged(ctxI);
+      }
+      return BL_SUCCESS;
+
     default:
       return blTraceError(BL_ERROR_INVALID_VALUE);
   }
@@ -1189,15 +1298,25 @@ static BLResult BL_CDECL blRasterContextImplSetHints(BLContextImpl* baseImpl, co
   uint8_t renderingQuality = hints->renderingQuality;
   uint8_t patternQuality = hints->patternQuality;
   uint8_t gradientQuality = hints->gradientQuality;
+  uint8_t approximationQuality = hints->approximationQuality;
 
-  if (BL_UNLIKELY(renderingQuality >= BL_RENDERING_QUALITY_COUNT ||
-                  patternQuality   >= BL_PATTERN_QUALITY_COUNT   ||
-                  gradientQuality  >= BL_GRADIENT_QUALITY_COUNT  ))
+  if (BL_UNLIKELY(renderingQuality     >= BL_RENDERING_QUALITY_COUNT     ||
+                  patternQuality       >= BL_PATTERN_QUALITY_COUNT       ||
+                  gradientQuality      >= BL_GRADIENT_QUALITY_COUNT      ||
+                  approximationQuality >= BL_APPROXIMATION_QUALITY_COUNT ))
     return blTraceError(BL_ERROR_INVALID_VALUE);
 
   ctxI->internalState.hints.renderingQuality = renderingQuality;
   ctxI->internalState.hints.patternQuality = patternQuality;
   ctxI->internalState.hints.gradientQuality = gradientQuality;
+
+  if (ctxI->internalState.hints.approximationQuality != approximationQuality) {
+    ctxI->contextFlags &= ~(BL_RASTER_CONTEXT_SHARED_FILL_STATE        |
+                            BL_RASTER_CONTEXT_SHARED_STROKE_BASE_STATE |
+                            BL_RASTER_CONTEXT_SHARED_STROKE_EXT_STATE  );
+    ctxI->internalState.hints.approximationQuality = approximationQuality;
+    blRasterContextImplFlattenToleranceChanged(ctxI);
+  }
   return BL_SUCCESS;
 }
 
@@ -1767,7 +1886,7 @@ static BL_INLINE BLRasterSharedBaseStrokeState* blRasterContextImplEnsureStrokeS
     if (BL_UNLIKELY(!stateData))
       return nullptr;
 
-    sharedStrokeState = new(stateData) BLRasterSharedBaseStrokeState(ctxI->strokeOptions(), ctxI->approximationOptions());
+    sharedStrokeState = new(stateData) BLRasterSharedBaseStrokeState(ctxI->strokeOptions(), ctxI->approximationOptions(), ctxI->hints().approximationQuality);
     if (transformOrder != BL_STROKE_TRANSFORM_ORDER_AFTER) {
       static_cast<BLRasterSharedExtendedStrokeState*>(sharedStrokeState)->userMatrix = ctxI->userMatrix();
       static_cast<BLRasterSharedExtendedStrokeState*>(sharedStrokeState)->metaMatrixFixed = ctxI->metaMatrixFixed();
@@ -1817,6 +1936,7 @@ static BL_INLINE BLResult blRasterContextImplEnqueueCommand(BLRasterContextImpl*
 
   commandFinalizer(command);
   mgr._commandQueueAppender.advance();
+  mgr._commandQueueCount++;
   return BL_SUCCESS;
 }
 
@@ -1827,7 +1947,13 @@ static BL_INLINE BLResult blRasterContextImplEnqueueFillBox(BLRasterContextImpl*
     return blTraceError(BL_ERROR_INVALID_STATE);
 
   serializer.initFillFunc(fillFunc);
-  return blRasterContextImplEnqueueCommand<Category>(ctxI, serializer.command(), [&](BLRasterCommand&) {});
+  return blRasterContextImplEnqueueCommand<Category>(ctxI, serializer.command(), [&](BLRasterCommand& command) {
+    const BLBoxI& box = command._boxI;
+    if (command.isBoxA())
+      ctxI->workerMgr().addBandCost(box.y0, box.y1, box.x1 - box.x0);
+    else
+      ctxI->workerMgr().addBandCost(box.y0 >> 8, (box.y1 + 255) >> 8, (box.x1 - box.x0) >> 8);
+  });
 }
 
 template<uint32_t Category>
@@ -1884,11 +2010,49 @@ static BL_INLINE BLResult blRasterContextImplNewStrokeJob(BLRasterContextImpl* c
   return BL_SUCCESS;
 }
 
+// Edges of commands that use a job are built by workers. A path caches its
+// bounding box, so its extent in the clip box is estimated from that box mapped
+// by the final matrix and grown by the stroke reach. Text and geometries that
+// aren't paths can cover the whole clip box as far as the context knows.
+static BL_INLINE void blRasterContextImplAddJobBandCost(BLRasterContextImpl* ctxI, const BLPath* path, uint32_t opType) noexcept {
+  const BLBoxI& clipBox = ctxI->finalClipBoxI();
+
+  BLBox box;
+  if (!path || path->getBoundingBox(&box) != BL_SUCCESS || !(box.x0 <= box.x1 && box.y0 <= box.y1)) {
+    ctxI->workerMgr().addBandCost(clipBox.y0, clipBox.y1, clipBox.x1 - clipBox.x0);
+    return;
+  }
+
+  double userReach = 0.0;
+  double deviceReach = 0.0;
+
+  if (opType == BL_CONTEXT_OP_TYPE_STROKE) {
+    // Miter joins reach up to `miterLimit` half widths, square caps sqrt(2).
+    const BLStrokeOptions& options = ctxI->strokeOptions();
+    double reach = options.width * 0.5 * blMax(options.join <= BL_STROKE_JOIN_MITER_ROUND ? options.miterLimit : 1.0, 1.5);
+
+    if (options.transformOrder == BL_STROKE_TRANSFORM_ORDER_AFTER)
+      userReach = reach;
+    else
+      deviceReach = reach;
+  }
+
+  box = blMatrix2DMapBox(ctxI->finalMatrix(), BLBox(box.x0 - userReach, box.y0 - userReach, box.x1 + userReach, box.y1 + userReach));
+
+  int x0 = int(blClamp(blFloor(box.x0 - deviceReach), double(clipBox.x0), double(clipBox.x1)));
+  int y0 = int(blClamp(blFloor(box.y0 - deviceReach), double(clipBox.y0), double(clipBox.y1)));
+  int x1 = int(blClamp(blCeil(box.x1 + deviceReach) + 1.0, double(clipBox.x0), double(clipBox.x1)));
+  int y1 = int(blClamp(blCeil(box.y1 + deviceReach) + 1.0, double(clipBox.y0), double(clipBox.y1)));
+
+  ctxI->workerMgr().addBandCost(y0, y1, x1 - x0);
+}
+
 template<uint32_t Category, typename JobType, typename JobFinalizer>
 static BL_INLINE BLResult blRasterContextImplEnqueueCommandWithFillJob(
   BLRasterContextImpl* ctxI,
   BLRasterCoreCommandSerializerAsync& serializer,
   size_t jobSize,
+  const BLPath* path,
   const JobFinalizer& jobFinalizer) noexcept {
 
   JobType* job;
@@ -1906,6 +2070,7 @@ static BL_INLINE BLResult blRasterContextImplEnqueueCommandWithFillJob(
   serializer.initFillFunc(fillFunc);
   return blRasterContextImplEnqueueCommand<Category>(ctxI, serializer.command(), [&](BLRasterCommand& command) {
     command._analyticAsync.stateSlotIndex = ctxI->workerMgr().nextStateSlotIndex();
+    blRasterContextImplAddJobBandCost(ctxI, path, BL_CONTEXT_OP_TYPE_FILL);
     job->initFillJob(serializer._command);
     job->setMetaMatrixFixedType(ctxI->metaMatrixFixedType());
     job->setFinalMatrixFixedType(ctxI->finalMatrixFixedType());
@@ -1919,6 +2084,7 @@ static BL_INLINE BLResult blRasterContextImplEnqueueCommandWithStrokeJob(
   BLRasterContextImpl* ctxI,
   BLRasterCoreCommandSerializerAsync& serializer,
   size_t jobSize,
+  const BLPath* path,
   const JobFinalizer& jobFinalizer) noexcept {
 
   JobType* job;
@@ -1936,6 +2102,7 @@ static BL_INLINE BLResult blRasterContextImplEnqueueCommandWithStrokeJob(
   serializer.initFillFunc(fillFunc);
   return blRasterContextImplEnqueueCommand<Category>(ctxI, serializer.command(), [&](BLRasterCommand& command) {
     command._analyticAsync.stateSlotIndex = ctxI->workerMgr().nextStateSlotIndex();
+    blRasterContextImplAddJobBandCost(ctxI, path, BL_CONTEXT_OP_TYPE_STROKE);
     job->initStrokeJob(serializer._command);
     job->setMetaMatrixFixedType(ctxI->metaMatrixFixedType());
     job->setFinalMatrixFixedType(ctxI->finalMatrixFixedType());
@@ -1952,9 +2119,9 @@ static BL_INLINE BLResult blRasterContextImplEnqueueCommandWithJob(
   const JobFinalizer& jobFinalizer) noexcept {
 
   if (OpType == BL_CONTEXT_OP_TYPE_FILL)
-    return blRasterContextImplEnqueueCommandWithFillJob<Category, JobType, JobFinalizer>(ctxI, serializer, jobSize, jobFinalizer);
+    return blRasterContextImplEnqueueCommandWithFillJob<Category, JobType, JobFinalizer>(ctxI, serializer, jobSize, nullptr, jobFinalizer);
   else
-    return blRasterContextImplEnqueueCommandWithStrokeJob<Category, JobType, JobFinalizer>(ctxI, serializer, jobSize, jobFinalizer);
+    return blRasterContextImplEnqueueCommandWithStrokeJob<Category, JobType, JobFinalizer>(ctxI, serializer, jobSize, nullptr, jobFinalizer);
 }
 
 // ============================================================================
@@ -2093,6 +2260,12 @@ static BL_INLINE BLResult blRasterContextImplFillClippedEdges(BLRasterContextImp
     return blTraceError(BL_ERROR_OUT_OF_MEMORY);
   }
 
+  // Edges are already built, so their vertical extent is known. The edge storage
+  // doesn't track the horizontal extent, so the clip box width is used instead.
+  const BLBoxI& edgeBox = workData->edgeStorage.boundingBox();
+  const BLBoxI& clipBox = ctxI->finalClipBoxI();
+  ctxI->workerMgr().addBandCost(edgeBox.y0 >> BL_PIPE_A8_SHIFT, (edgeBox.y1 >> BL_PIPE_A8_SHIFT) + 1, clipBox.x1 - clipBox.x0);
+
   serializer.initFillAnalyticAsync(fillRule, workData->edgeStorage.flattenEdgeLinks());
   workData->edgeStorage.resetBoundingBox();
   return blRasterContextImplEnqueueFillAnalytic<Category>(ctxI, serializer);
@@ -2119,6 +2292,7 @@ static BL_INLINE BLResult blRasterContextImplFillUnsafeGeometry(
   return blRasterContextImplEnqueueCommandWithFillJob<Category, BLRasterJobData_GeometryOp>(
     ctxI, serializer,
     sizeof(BLRasterJobData_GeometryOp) + geometrySize,
+    geometryType == BL_GEOMETRY_TYPE_PATH ? static_cast<const BLPath*>(geometryData) : nullptr,
     [&](BLRasterJobData_GeometryOp* job) {
       job->setGeometry(geometryType, geometryData, geometrySize);
     });
@@ -2149,6 +2323,7 @@ static BL_INLINE BLResult blRasterContextImplStrokeUnsafeGeometry(
   return blRasterContextImplEnqueueCommandWithStrokeJob<Category, BLRasterJobData_GeometryOp>(
     ctxI, serializer,
     sizeof(BLRasterJobData_GeometryOp) + geometrySize,
+    geometryType == BL_GEOMETRY_TYPE_PATH ? static_cast<const BLPath*>(geometryData) : nullptr,
     [&](BLRasterJobData_GeometryOp* job) {
       job->setGeometry(geometryType, geometryData, geometrySize);
     });
@@ -3266,6 +3441,11 @@ static uint32_t blRasterContextImplCalculateBandHeight(uint32_t format, const BL
   uint32_t kMinBandHeight = 8;
   uint32_t kMaxBandHeight = 64;
 
+  // Bands are claimed by workers in chunks grouped by their estimated cost, so
+  // having more bands than threads is cheap and lets expensive regions (dense
+  // edges concentrated in few rows) be spread over more workers.
+  uint32_t kMinBandsPerThread = 4;
+
   uint32_t bandHeight = kMaxBandHeight;
 
   // TODO: [Rendering Context] We should read this number from the CPU and adjust.
@@ -3284,7 +3464,7 @@ static uint32_t blRasterContextImplCalculateBandHeight(uint32_t format, const BL
   uint32_t threadCount = options->threadCount;
   if (bandHeight > kMinBandHeight && threadCount > 1) {
     uint32_t bandHeightShift = blBitCtz(bandHeight);
-    uint32_t minimumBandCount = threadCount;
+    uint32_t minimumBandCount = threadCount * kMinBandsPerThread;
 
     do {
       uint32_t bandCount = (uint32_t(size.h) + bandHeight - 1) >> bandHeightShift;
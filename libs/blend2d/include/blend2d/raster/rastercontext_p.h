@@ -465,6 +465,11 @@ public:
 // ============================================================================
 
 BL_HIDDEN BLResult blRasterContextImplCreate(BLContextImpl** out, BLImageCore* image, const BLContextCreateInfo* options) noexcept;
+
+//! Flushes the current batch once it reached the command queue limit. Worker
+//! threads start processing it while the user thread continues serializing
+//! commands into a new batch.
+BL_HIDDEN BLResult blRasterContextImplFlushQueuedBatch(BLRasterContextImpl* ctxI) noexcept;
 BL_HIDDEN void blRasterContextOnInit(BLRuntimeContext* rt) noexcept;
 
 //! \}
@@ -128,6 +128,30 @@ static BL_INLINE BLResult blRasterContextUtilFillGlyphRun(
   return workData->accumulateError(result);
 }
 
+// ============================================================================
+// [BLRasterContext - Stroke Approximation]
+// ============================================================================
+
+//! Returns approximation options to be used by the stroker.
+//!
+//! The stroker works before the path is transformed by `m`, so its tolerances
+//! are in user units. In `BL_APPROXIMATION_QUALITY_PREVIEW` the simplification
+//! tolerance keeps its ratio to the flattening tolerance, which is in device
+//! space (`toleranceFixedD` is already scaled by the quality and `m` has the
+//! same fixed-point scale), so strokes get coarser as the view zooms out.
+static BL_INLINE BLApproximationOptions blRasterContextUtilStrokeApproximationOptions(
+  const BLApproximationOptions& approx, uint32_t quality, double toleranceFixedD, const BLMatrix2D& m) noexcept {
+
+  BLApproximationOptions result = approx;
+  if (quality == BL_APPROXIMATION_QUALITY_PRODUCTION)
+    return result;
+
+  double scale = blSqrt(blAbs(m.m00 * m.m11 - m.m01 * m.m10));
+  if (scale > 0.0 && blIsFinite(scale))
+    result.simplifyTolerance = approx.simplifyTolerance * toleranceFixedD / (approx.flattenTolerance * scale);
+  return result;
+}
+
 // ============================================================================
 // [BLRasterContext - Stroke Path Utilities]
 // ============================================================================
@@ -158,13 +182,16 @@ static BL_INLINE BLResult blRasterContextUtilStrokeUnsafePath(
     sink.matrixType = accessor.metaMatrixFixedType();
   }
 
+  BLApproximationOptions approx = blRasterContextUtilStrokeApproximationOptions(
+    accessor.approximationOptions(), accessor.approximationQuality(), accessor.toleranceFixedD(), *sink.matrix);
+
   a->clear();
   workData->edgeBuilder.begin();
 
   BLResult result = blPathStrokeInternal(
     path->view(),
     accessor.strokeOptions(),
-    accessor.approximationOptions(),
+    approx,
     a, b, c,
     blRasterContextStrokeGeometrySinkFunc, &sink);
 
@@ -193,7 +220,6 @@ static BL_INLINE BLResult blRasterContextUtilStrokeGlyphRun(
   sink.edgeBuilder = &workData->edgeBuilder;
   sink.paths = workData->tmpPath;
   sink.strokeOptions = &accessor.strokeOptions();
-  sink.approximationOptions = &accessor.approximationOptions();
 
   BLMatrix2D preMatrix;
   if (accessor.strokeOptions().transformOrder != BL_STROKE_TRANSFORM_ORDER_AFTER) {
@@ -208,6 +234,10 @@ static BL_INLINE BLResult blRasterContextUtilStrokeGlyphRun(
     sink.matrixType = accessor.finalMatrixFixedType();
   }
 
+  BLApproximationOptions approx = blRasterContextUtilStrokeApproximationOptions(
+    accessor.approximationOptions(), accessor.approximationQuality(), accessor.toleranceFixedD(), *sink.matrix);
+  sink.approximationOptions = &approx;
+
   BLPath* tmpPath = &workData->tmpPath[3];
   tmpPath->clear();
   workData->edgeBuilder.begin();
@@ -156,10 +156,12 @@ struct BLRasterSharedFillState {
 struct BLRasterSharedBaseStrokeState {
   BLStrokeOptions strokeOptions;
   BLApproximationOptions approximationOptions;
+  uint32_t approximationQuality;
 
-  BL_INLINE explicit BLRasterSharedBaseStrokeState(const BLStrokeOptions& strokeOptions, const BLApproximationOptions& approximationOptions) noexcept
+  BL_INLINE explicit BLRasterSharedBaseStrokeState(const BLStrokeOptions& strokeOptions, const BLApproximationOptions& approximationOptions, uint32_t approximationQuality) noexcept
     : strokeOptions(strokeOptions),
-      approximationOptions(approximationOptions) {}
+      approximationOptions(approximationOptions),
+      approximationQuality(approximationQuality) {}
 };
 
 // ============================================================================
@@ -171,8 +173,8 @@ struct BLRasterSharedExtendedStrokeState : public BLRasterSharedBaseStrokeState
   BLMatrix2D userMatrix;
   BLMatrix2D metaMatrixFixed;
 
-  BL_INLINE explicit BLRasterSharedExtendedStrokeState(const BLStrokeOptions& strokeOptions, const BLApproximationOptions& approximationOptions) noexcept
-    : BLRasterSharedBaseStrokeState(strokeOptions, approximationOptions) {}
+  BL_INLINE explicit BLRasterSharedExtendedStrokeState(const BLStrokeOptions& strokeOptions, const BLApproximationOptions& approximationOptions, uint32_t approximationQuality) noexcept
+    : BLRasterSharedBaseStrokeState(strokeOptions, approximationOptions, approximationQuality) {}
 };
 
 //! \}
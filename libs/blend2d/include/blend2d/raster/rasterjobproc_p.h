@@ -66,9 +66,11 @@ public:
   BL_INLINE uint32_t finalMatrixFixedType() const noexcept { return job->finalMatrixFixedType(); }
   BL_INLINE const BLMatrix2D& finalMatrixFixed() const noexcept { return fillState()->finalMatrixFixed; }
   BL_INLINE const BLBox& finalClipBoxFixedD() const noexcept { return fillState()->finalClipBoxFixedD; }
+  BL_INLINE double toleranceFixedD() const noexcept { return fillState()->toleranceFixedD; }
 
   // Stroke states.
   BL_INLINE const BLApproximationOptions& approximationOptions() const noexcept { return baseStrokeState()->approximationOptions; }
+  BL_INLINE uint32_t approximationQuality() const noexcept { return baseStrokeState()->approximationQuality; }
   BL_INLINE const BLStrokeOptions& strokeOptions() const noexcept { return baseStrokeState()->strokeOptions; }
 
   BL_INLINE uint32_t metaMatrixFixedType() const noexcept { return job->metaMatrixFixedType(); }
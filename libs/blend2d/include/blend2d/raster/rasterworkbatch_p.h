@@ -61,9 +61,9 @@ public:
   };
 
   struct alignas(BL_CACHE_LINE_SIZE) {
-    //! Band index, incremented by workers to get a band index to process.
-    //! Can go out of range in case there is no more bands to process.
-    volatile size_t _bandIndex;
+    //! Band chunk index, incremented by workers to get the next chunk of bands
+    //! to process. Can go out of range in case there is no more bands to process.
+    volatile size_t _bandChunkIndex;
   };
 
   //! Pointer to the synchronization data.
@@ -74,29 +74,38 @@ public:
   BLZoneList<BLRasterCommandQueue> _commandQueueList;
   BLZoneAllocator::Block* _pastBlock;
 
+  //! Start band of each chunk followed by `_bandCount`, has `_bandChunkCount + 1`
+  //! entries. Chunks are contiguous and ordered, so a worker that only claims
+  //! chunks through `nextBandChunkIndex()` always sees bands in increasing order,
+  //! which is required by the asynchronous command processor.
+  const uint32_t* _bandChunks;
+
   uint32_t _jobCount;
   uint32_t _commandCount;
   uint32_t _bandCount;
+  uint32_t _bandChunkCount;
   uint32_t _stateSlotCount;
 
   BL_INLINE BLRasterWorkBatch() noexcept
     : _jobIndex(0),
       _accumulatedErrorFlags(0),
-      _bandIndex(0),
+      _bandChunkIndex(0),
       _synchronization(nullptr),
       _jobQueueList(),
       _fetchQueueList(),
       _commandQueueList(),
       _pastBlock(nullptr),
+      _bandChunks(nullptr),
       _jobCount(0),
       _commandCount(0),
       _bandCount(0),
+      _bandChunkCount(0),
       _stateSlotCount(0) {}
 
   BL_INLINE ~BLRasterWorkBatch() noexcept {}
 
   BL_INLINE size_t nextJobIndex() noexcept { return blAtomicFetchAdd(&_jobIndex); }
-  BL_INLINE size_t nextBandIndex() noexcept { return blAtomicFetchAdd(&_bandIndex); }
+  BL_INLINE size_t nextBandChunkIndex() noexcept { return blAtomicFetchAdd(&_bandChunkIndex); }
 
   BL_INLINE const BLZoneList<BLRasterJobQueue>& jobQueueList() const noexcept { return _jobQueueList; }
   BL_INLINE const BLZoneList<BLRasterFetchQueue>& fetchQueueList() const noexcept { return _fetchQueueList; }
@@ -106,6 +115,9 @@ public:
   BL_INLINE uint32_t commandCount() const noexcept { return _commandCount; }
 
   BL_INLINE uint32_t bandCount() const noexcept { return _bandCount; }
+  BL_INLINE uint32_t bandChunkCount() const noexcept { return _bandChunkCount; }
+  BL_INLINE uint32_t bandChunkStart(size_t chunkIndex) const noexcept { return _bandChunks[chunkIndex]; }
+  BL_INLINE uint32_t bandChunkEnd(size_t chunkIndex) const noexcept { return _bandChunks[chunkIndex + 1]; }
   BL_INLINE uint32_t stateSlotCount() const noexcept { return _stateSlotCount; }
 
   BL_INLINE void accumulateErrorFlags(uint32_t errorFlags) noexcept {
@@ -34,6 +34,7 @@ BLRasterWorkData::BLRasterWorkData(BLRasterContextImpl* ctxI, uint32_t workerId)
     batch(nullptr),
     ctxData(),
     clipMode(BL_CLIP_MODE_ALIGNED_RECT),
+    collectStats(0),
     reserved {},
     _workerId(workerId),
     _bandHeight(0),
@@ -42,7 +43,8 @@ BLRasterWorkData::BLRasterWorkData(BLRasterContextImpl* ctxI, uint32_t workerId)
     workState{},
     zeroBuffer(),
     edgeStorage(),
-    edgeBuilder(&workZone, &edgeStorage) {}
+    edgeBuilder(&workZone, &edgeStorage),
+    stats {} {}
 
 BLRasterWorkData::~BLRasterWorkData() noexcept {
   if (edgeStorage.bandEdges())
@@ -24,6 +24,9 @@
 #ifndef BLEND2D_RASTER_RASTERWORKDATA_P_H_INCLUDED
 #define BLEND2D_RASTER_RASTERWORKDATA_P_H_INCLUDED
 
+#include <chrono>
+
+#include "../context.h"
 #include "../geometry_p.h"
 #include "../image.h"
 #include "../path.h"
@@ -44,6 +47,16 @@
 class BLRasterContextImpl;
 class BLRasterWorkBatch;
 
+// ============================================================================
+// [BLRasterWorkData - Stats]
+// ============================================================================
+
+//! Returns a monotonic time in nanoseconds used by `BLContextWorkerStats`.
+static BL_INLINE uint64_t blRasterWorkTimeNs() noexcept {
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
 // ============================================================================
 // [BLRasterWorkData]
 // ============================================================================
@@ -69,8 +82,10 @@ public:
 
   //! Clip mode.
   uint8_t clipMode;
+  //! Whether to collect `stats`, see `BLContextCreateInfo::workerStats`.
+  uint8_t collectStats;
   //! Reserved.
-  uint8_t reserved[3];
+  uint8_t reserved[2];
   //! Id of the worker that uses this WorkData.
   uint32_t _workerId;
   //! Band height.
@@ -94,6 +109,9 @@ public:
   //! Edge builder.
   BLEdgeBuilder<int> edgeBuilder;
 
+  //! Statistics accumulated during the lifetime of the rendering context.
+  BLContextWorkerStats stats;
+
   explicit BLRasterWorkData(BLRasterContextImpl* ctxI, uint32_t workerId = kSyncWorkerId) noexcept;
   ~BLRasterWorkData() noexcept;
 
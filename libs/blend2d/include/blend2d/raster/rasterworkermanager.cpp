@@ -34,6 +34,7 @@ BLResult BLRasterWorkerManager::init(BLRasterContextImpl* ctxI, const BLContextC
   uint32_t initFlags = createInfo->flags;
   uint32_t threadCount = createInfo->threadCount;
   uint32_t commandQueueLimit = createInfo->commandQueueLimit;
+  BLContextWorkerStats* workerStats = createInfo->workerStatsCapacity ? createInfo->workerStats : nullptr;
 
   BL_ASSERT(!isActive());
   BL_ASSERT(threadCount > 0);
@@ -124,6 +125,7 @@ BLResult BLRasterWorkerManager::init(BLRasterContextImpl* ctxI, const BLContextC
       for (uint32_t i = 0; i < n; i++) {
         workDataStorage[i] = new(workDataStorage[i]) BLRasterWorkData(ctxI, i);
         workDataStorage[i]->initBandData(ctxI->bandHeight(), ctxI->bandCount());
+        workDataStorage[i]->collectStats = uint8_t(workerStats != nullptr);
       }
     }
 
@@ -137,9 +139,40 @@ BLResult BLRasterWorkerManager::init(BLRasterContextImpl* ctxI, const BLContextC
     _workerCount = 0;
   }
 
+  // Allocate band cost estimation and band chunks, both have one extra entry.
+  // This is done after acquiring threads as that can restore the zone state.
+  uint32_t bandCount = ctxI->bandCount();
+  uint32_t* bandCostDelta = zone.allocT<uint32_t>(blAlignUp((bandCount + 1) * sizeof(uint32_t), 8));
+  uint32_t* bandChunkData = zone.allocT<uint32_t>(blAlignUp((bandCount + 1) * sizeof(uint32_t), 8));
+
+  if (!bandCostDelta || !bandChunkData) {
+    // Releases acquired threads and destroys work data, `reset()` is a no-op otherwise.
+    _isActive = true;
+    reset();
+    zone.restoreState(zoneState);
+    return blTraceError(BL_ERROR_OUT_OF_MEMORY);
+  }
+
+  for (uint32_t i = 0; i <= bandCount; i++)
+    bandCostDelta[i] = 0;
+
+  // Without worker threads there is nothing to overlap with, so the queue is
+  // only limited when the limit was given explicitly (to bound memory use).
+  if (!commandQueueLimit)
+    commandQueueLimit = workerCount ? uint32_t(kDefaultCommandQueueLimit) : 0xFFFFFFFFu;
+  else
+    commandQueueLimit = blMax<uint32_t>(commandQueueLimit, kMinCommandQueueLimit);
+
+  ctxI->syncWorkData.collectStats = uint8_t(workerStats != nullptr);
+
   _isActive = true;
-  _bandCount = ctxI->bandCount();
+  _workerStats = workerStats;
+  _workerStatsCapacity = workerStats ? createInfo->workerStatsCapacity : 0u;
+  _bandCount = bandCount;
+  _bandHeightShift = blBitCtz(ctxI->bandHeight());
   _commandQueueLimit = commandQueueLimit;
+  _bandCostDelta = bandCostDelta;
+  _bandChunkData = bandChunkData;
 
   initFirstBatch();
   return BL_SUCCESS;
@@ -166,7 +199,76 @@ void BLRasterWorkerManager::reset() noexcept {
     _threadPool = nullptr;
   }
 
+  _pendingBatch = nullptr;
+  _workerStats = nullptr;
+  _workerStatsCapacity = 0;
   _commandQueueCount = 0;
   _commandQueueLimit = 0;
   _stateSlotCount = 0;
+  _bandCostDelta = nullptr;
+  _bandChunkData = nullptr;
+}
+
+// ============================================================================
+// [BLRasterWorkerManager - Band Chunks]
+// ============================================================================
+
+uint32_t BLRasterWorkerManager::_buildBandChunks() noexcept {
+  uint32_t bandCount = _bandCount;
+  uint32_t* cost = _bandCostDelta;
+  uint32_t* chunks = _bandChunkData;
+
+  // Convert deltas to per-band costs in place.
+  uint32_t acc = 0;
+  uint64_t total = 0;
+
+  for (uint32_t i = 0; i < bandCount; i++) {
+    acc += cost[i];
+    cost[i] = acc;
+    total += acc;
+  }
+  cost[bandCount] = 0;
+
+  uint32_t chunkCount = 0;
+
+  if (!_workerCount) {
+    // The user thread is the only worker, a single chunk avoids the atomics.
+    chunks[chunkCount++] = 0;
+  }
+  else if (!total) {
+    // Nothing to estimate from, fall back to one band per chunk.
+    while (chunkCount < bandCount) {
+      chunks[chunkCount] = chunkCount;
+      chunkCount++;
+    }
+  }
+  else {
+    // Guided scheduling driven by the estimated cost. Cheap bands are grouped
+    // so workers don't fight over empty space, while bands that are expensive
+    // (an annulus full of edges, for example) end up alone in their chunk. The
+    // target shrinks as the remaining cost drops, so the last chunks are small
+    // and no worker is left alone with a large tail at the end of the batch.
+    uint64_t remaining = total;
+    uint64_t divisor = uint64_t(_workerCount + 1) * kBandChunkDivisor;
+
+    uint32_t i = 0;
+    while (i < bandCount) {
+      uint64_t target = blMax<uint64_t>(remaining / divisor, 1);
+      uint64_t chunkCost = 0;
+
+      chunks[chunkCount++] = i;
+      do {
+        chunkCost += cost[i++];
+      } while (i < bandCount && chunkCost + cost[i] <= target);
+
+      remaining -= chunkCost;
+    }
+  }
+
+  chunks[chunkCount] = bandCount;
+
+  for (uint32_t i = 0; i <= bandCount; i++)
+    cost[i] = 0;
+
+  return chunkCount;
 }
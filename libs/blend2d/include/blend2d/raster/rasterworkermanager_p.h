@@ -61,13 +61,33 @@ class BLRasterWorkerManager {
 public:
   BL_NONCOPYABLE(BLRasterWorkerManager)
 
-  enum : uint32_t { kAllocatorAlignment = 8 };
+  enum : uint32_t {
+    kAllocatorAlignment = 8,
+
+    //! Each pixel-row covered by a command costs `1 + (width >> kBandCostWidthShift)`.
+    kBandCostWidthShift = 5,
+    //! Guided scheduling divisor - each chunk takes at most `remaining / (threads * divisor)`
+    //! of the estimated cost, so chunks get smaller towards the end of the batch.
+    kBandChunkDivisor = 2,
+
+    //! Command queue limit used when `BLContextCreateInfo::commandQueueLimit` is zero.
+    //!
+    //! Large enough to amortize waking up workers, small enough that workers start
+    //! while the user thread is still serializing a large scene.
+    kDefaultCommandQueueLimit = 4096,
+    //! Minimum command queue limit, smaller batches spend more time synchronizing
+    //! than rendering.
+    kMinCommandQueueLimit = 64
+  };
 
   //! Zone allocator used to allocate commands and jobs.
   BLZoneAllocator _allocator;
 
   //! The current batch.
   BLRasterWorkBatch* _currentBatch;
+  //! Batch processed by worker threads while the user thread serializes the
+  //! current one, see `blRasterContextImplFlushQueuedBatch()`.
+  BLRasterWorkBatch* _pendingBatch;
   //! Job queue appender.
   BLRasterJobQueueAppender _jobQueueAppender;
   //! Command queue appender.
@@ -85,24 +105,38 @@ public:
   //! Work synchronization
   BLRasterWorkSynchronization _synchronization;
 
+  //! User provided array that receives work statistics, see `BLContextCreateInfo::workerStats`.
+  BLContextWorkerStats* _workerStats;
+  //! Number of entries in `_workerStats`.
+  uint32_t _workerStatsCapacity;
+
   //! Indicates that a worker manager is active.
   uint32_t _isActive;
   //! Number of worker threads.
   uint32_t _workerCount;
   //! Number of bands,
   uint32_t _bandCount;
+  //! Band height shift, to get a band index from a pixel row.
+  uint32_t _bandHeightShift;
   //! Batch id, an incrementing number that is assigned to FetchData.
   uint32_t _batchId;
   //! Number of commands in the queue.
   uint32_t _commandQueueCount;
-  //! Maximum number of commands in a queue.
+  //! Maximum number of commands in a queue before the batch is flushed.
   uint32_t _commandQueueLimit;
   //! Count of data slots.
   uint32_t _stateSlotCount;
 
+  //! Estimated cost of each band stored as deltas (`_bandCount + 1` entries),
+  //! accumulated by the rendering context as commands are enqueued.
+  uint32_t* _bandCostDelta;
+  //! Band chunks of the current batch (`_bandCount + 1` entries).
+  uint32_t* _bandChunkData;
+
   BL_INLINE BLRasterWorkerManager() noexcept
     : _allocator(131072 - BLZoneAllocator::kBlockOverhead, kAllocatorAlignment),
       _currentBatch(nullptr),
+      _pendingBatch(nullptr),
       _jobQueueAppender(),
       _commandQueueAppender(),
       _fetchQueueAppender(),
@@ -110,13 +144,18 @@ public:
       _workerThreads(nullptr),
       _workDataStorage(nullptr),
       _synchronization(),
+      _workerStats(nullptr),
+      _workerStatsCapacity(0),
       _isActive(0),
       _workerCount(0),
       _bandCount(0),
+      _bandHeightShift(0),
       _batchId(1),
       _commandQueueCount(0),
       _commandQueueLimit(0),
-      _stateSlotCount(0) {}
+      _stateSlotCount(0),
+      _bandCostDelta(nullptr),
+      _bandChunkData(nullptr) {}
 
   BL_INLINE ~BLRasterWorkerManager() noexcept {
     // Cannot be initialized upon destruction!
@@ -130,13 +169,30 @@ public:
   BLResult init(BLRasterContextImpl* ctxI, const BLContextCreateInfo* createInfo) noexcept;
 
   BL_INLINE void initFirstBatch() noexcept {
-    BLRasterWorkBatch* batch = _allocator.newT<BLRasterWorkBatch>();
+    BLRasterWorkBatch* batch = newBatch();
     BL_ASSERT(batch != nullptr); // We have preallocated enough, cannot happen.
 
-    batch->_jobQueueList.reset(newJobQueue());
-    batch->_fetchQueueList.reset(newFetchQueue());
-    batch->_commandQueueList.reset(newCommandQueue());
+    setCurrentBatch(batch);
+  }
+
+  //! Allocates a new batch with empty queues, returns null if out of memory.
+  BL_INLINE BLRasterWorkBatch* newBatch() noexcept {
+    BLRasterWorkBatch* batch = _allocator.newT<BLRasterWorkBatch>();
+    BLRasterJobQueue* jobQueue = newJobQueue();
+    BLRasterFetchQueue* fetchQueue = newFetchQueue();
+    BLRasterCommandQueue* commandQueue = newCommandQueue();
 
+    if (BL_UNLIKELY(!batch || !jobQueue || !fetchQueue || !commandQueue))
+      return nullptr;
+
+    batch->_jobQueueList.reset(jobQueue);
+    batch->_fetchQueueList.reset(fetchQueue);
+    batch->_commandQueueList.reset(commandQueue);
+    return batch;
+  }
+
+  //! Makes `batch` the current batch, all commands are appended to it from now.
+  BL_INLINE void setCurrentBatch(BLRasterWorkBatch* batch) noexcept {
     _currentBatch = batch;
     _jobQueueAppender.reset(*batch->_jobQueueList.first());
     _fetchQueueAppender.reset(*batch->_fetchQueueList.first());
@@ -159,6 +215,8 @@ public:
 
   BL_INLINE uint32_t workerCount() const noexcept { return _workerCount; }
 
+  BL_INLINE bool collectsStats() const noexcept { return _workerStats != nullptr; }
+
   //! \}
 
   //! \name Job Data
@@ -276,12 +334,43 @@ public:
     return _commandQueueAppender._ptr;
   }
 
+  //! Tests whether the current batch reached the command queue limit and should
+  //! be flushed before the next command is serialized.
+  BL_INLINE bool isCommandQueueFull() const noexcept {
+    return _commandQueueCount >= _commandQueueLimit;
+  }
+
   BL_INLINE uint32_t nextStateSlotIndex() noexcept {
     return _stateSlotCount++;
   }
 
   //! \}
 
+  //! \name Band Cost Estimation
+  //! \{
+
+  //! Accumulates the estimated cost of a command that covers pixel rows `[y0, y1)`
+  //! and is `width` pixels wide. The estimate only drives how bands are grouped
+  //! into chunks, it never affects what gets rendered.
+  BL_INLINE void addBandCost(int y0, int y1, int width) noexcept {
+    if (y0 >= y1 || y1 <= 0)
+      return;
+
+    uint32_t bandStart = blMin(uint32_t(blMax(y0, 0)) >> _bandHeightShift, _bandCount);
+    uint32_t bandEnd = blMin(((uint32_t(y1) - 1u) >> _bandHeightShift) + 1u, _bandCount);
+    uint32_t cost = 1u + (uint32_t(blMax(width, 0)) >> kBandCostWidthShift);
+
+    // Deltas wrap around, prefix sums computed by `_buildBandChunks()` are exact.
+    _bandCostDelta[bandStart] += cost;
+    _bandCostDelta[bandEnd] -= cost;
+  }
+
+  //! Turns accumulated band costs into band chunks of the current batch and
+  //! clears the accumulated costs.
+  uint32_t _buildBandChunks() noexcept;
+
+  //! \}
+
   //! \name Work Batch
   //! \{
 
@@ -302,6 +391,8 @@ public:
     _currentBatch->_commandCount += uint32_t(lastCommandQueue->size());
     _currentBatch->_stateSlotCount = _stateSlotCount;
     _currentBatch->_bandCount = _bandCount;
+    _currentBatch->_bandChunkCount = _buildBandChunks();
+    _currentBatch->_bandChunks = _bandChunkData;
     _currentBatch->_pastBlock = _allocator.pastBlock();
 
     if (++_batchId == 0)
@@ -32,6 +32,7 @@
 #include "../raster/rasterworkdata_p.h"
 #include "../raster/rasterworkproc_p.h"
 #include "../raster/rasterworksynchronization_p.h"
+#include "../trace_p.h"
 
 // TODO: HARDCODED.
 static const uint32_t fpScale = 256;
@@ -47,6 +48,10 @@ static void blRasterWorkProcessJobs(BLRasterWorkData* workData) noexcept {
   if (!jobCount)
     return;
 
+  BL_TRACE_SCOPE(trace, "raster.jobs");
+  uint64_t startTime = workData->collectStats ? blRasterWorkTimeNs() : uint64_t(0);
+  size_t processedCount = 0;
+
   const BLRasterJobQueue* queue = batch->jobQueueList().first();
   BL_ASSERT(queue != nullptr);
 
@@ -70,9 +75,22 @@ static void blRasterWorkProcessJobs(BLRasterWorkData* workData) noexcept {
     BL_ASSERT(jobData != nullptr);
 
     blRasterJobProcAsync(workData, jobData);
+    processedCount++;
+  }
+
+  workData->stats.jobCount += processedCount;
+  BL_TRACE_SET_ARG(trace, processedCount);
+
+  if (!workData->collectStats) {
+    batch->_synchronization->waitForJobsToFinish();
+    return;
   }
 
+  uint64_t waitTime = blRasterWorkTimeNs();
   batch->_synchronization->waitForJobsToFinish();
+
+  workData->stats.jobTimeNs += waitTime - startTime;
+  workData->stats.waitTimeNs += blRasterWorkTimeNs() - waitTime;
 }
 
 // ============================================================================
@@ -87,6 +105,7 @@ static void blRasterWorkProcessBand(BLRasterCommandProcAsyncData& procData, bool
   typedef BLPrivateBitOps<BLBitWord> BitOps;
   BLRasterWorkBatch* batch = procData.batch();
 
+  size_t commandCount = 0;
   BLBitWord* bitSetPtr = procData.pendingCommandBitSetData();
   BLBitWord* bitSetEndMinus1 = procData.pendingCommandBitSetEnd() - 1;
   BLBitWord bitSetMask = procData.pendingCommandBitSetMask();
@@ -106,6 +125,8 @@ static void blRasterWorkProcessBand(BLRasterCommandProcAsyncData& procData, bool
     while (it.hasNext()) {
       uint32_t bitIndex = it.next();
       const BLRasterCommand& command = commandQueueData[bitIndex];
+      commandCount++;
+
       if (blRasterCommandProcAsync(procData, command, isInitialBand)) {
         bitWord &= ~BitOps::indexAsMask(bitIndex);
       }
@@ -127,6 +148,7 @@ static void blRasterWorkProcessBand(BLRasterCommandProcAsyncData& procData, bool
   }
 
   procData.clearPendingCommandBitSetMask();
+  procData.workData()->stats.commandCount += commandCount;
 }
 
 static void blRasterWorkProcessCommands(BLRasterWorkData* workData) noexcept {
@@ -141,20 +163,38 @@ static void blRasterWorkProcessCommands(BLRasterWorkData* workData) noexcept {
     return;
   }
 
+  BL_TRACE_SCOPE(trace, "raster.commands");
+
   bool isInitialBand = true;
-  size_t bandCount = batch->bandCount();
+  size_t bandChunkCount = batch->bandChunkCount();
+  uint64_t bandCount = 0;
+
+  uint64_t startTime = workData->collectStats ? blRasterWorkTimeNs() : uint64_t(0);
+  uint64_t fillTime = workData->stats.fillTimeNs;
 
   for (;;) {
-    size_t bandId = batch->nextBandIndex();
-    if (bandId >= bandCount)
+    size_t chunkIndex = batch->nextBandChunkIndex();
+    if (chunkIndex >= bandChunkCount)
       break;
 
-    procData.initBand(uint32_t(bandId), workData->bandHeight(), fpScale);
-    blRasterWorkProcessBand(procData, isInitialBand);
+    uint32_t bandEnd = batch->bandChunkEnd(chunkIndex);
+    for (uint32_t bandId = batch->bandChunkStart(chunkIndex); bandId < bandEnd; bandId++) {
+      procData.initBand(bandId, workData->bandHeight(), fpScale);
+      blRasterWorkProcessBand(procData, isInitialBand);
+
+      isInitialBand = false;
+    }
 
-    isInitialBand = false;
+    bandCount += bandEnd - batch->bandChunkStart(chunkIndex);
   }
 
+  workData->stats.bandCount += bandCount;
+  BL_TRACE_SET_ARG(trace, bandCount);
+
+  // Time spent in pipelines is accounted by `BLRasterCommandProcAsyncData::fill()`.
+  if (workData->collectStats)
+    workData->stats.rasterTimeNs += (blRasterWorkTimeNs() - startTime) - (workData->stats.fillTimeNs - fillTime);
+
   workData->workZone.restoreState(zoneState);
 }
 
@@ -179,6 +219,8 @@ static void blRasterWorkProcDone(BLRasterWorkData* workData) noexcept {
 // ============================================================================
 
 void blRasterWorkProc(BLRasterWorkData* workData) noexcept {
+  BL_TRACE_SCOPE(trace, "raster.batch", workData->batch->commandCount());
+
   // NOTE: The zone must be cleared when the worker threads starts processing
   // jobs and commands. The reason is that once we finish job processing other
   // threads can still use data produced by such job, so even when we are done
@@ -188,6 +230,8 @@ void blRasterWorkProc(BLRasterWorkData* workData) noexcept {
   if (!workData->isSync())
     workData->startOver();
 
+  workData->stats.batchCount++;
+
   // Pass 1 - Process jobs.
   //
   // Once the thread acquires a job to process no other thread can have that
@@ -199,10 +243,10 @@ void blRasterWorkProc(BLRasterWorkData* workData) noexcept {
   //
   // Commands are processed after the last job finishes. Command are processed
   // multiple times per each band. Threads process all commands in a band and
-  // then move to the next available band. This ensures that even when there
-  // is something more complicated in one band than in all other bands the
-  // distribution of threads should be fair as other threads won't wait for
-  // a particular band to be rendered.
+  // then move to the next available band. Bands are claimed in chunks built
+  // from the estimated cost of each band, cheap bands are grouped together
+  // and expensive ones are claimed alone, so the distribution of threads
+  // should be fair even when most of the work is concentrated in few bands.
   blRasterWorkProcessCommands(workData);
 
   // Propagates accumulated error flags into the batch.
@@ -24,6 +24,7 @@
 #include "./api-build_p.h"
 #include "./runtime_p.h"
 #include "./support_p.h"
+#include "./threading/threadpool_p.h"
 
 // PTHREAD_STACK_MIN would be defined either by <pthread.h> or <limits.h>.
 #include <limits.h>
@@ -246,6 +247,7 @@ BLResult blRuntimeInit() noexcept {
 
   // Call "Runtime Initialization" handlers.
   // - These would automatically install shutdown handlers when necessary.
+  blTraceOnInit(rt);
   blThreadOnInit(rt);
   blThreadPoolOnInit(rt);
   blZeroAllocatorOnInit(rt);
@@ -329,6 +331,12 @@ BLResult blRuntimeQueryInfo(uint32_t infoType, void* infoOut) noexcept {
       return BL_SUCCESS;
     }
 
+    case BL_RUNTIME_INFO_TYPE_THREADING: {
+      BLRuntimeThreadingInfo* threadingInfo = static_cast<BLRuntimeThreadingInfo*>(infoOut);
+      blThreadPoolQueryThreadingInfo(threadingInfo);
+      return BL_SUCCESS;
+    }
+
     default:
       return blTraceError(BL_ERROR_INVALID_VALUE);
   }
@@ -42,7 +42,9 @@ BL_DEFINE_ENUM(BLRuntimeLimits) {
   //! Maximum width and height of an image.
   BL_RUNTIME_MAX_IMAGE_SIZE = 65535,
   //! Maximum number of threads for asynchronous operations (including rendering).
-  BL_RUNTIME_MAX_THREAD_COUNT = 32
+  BL_RUNTIME_MAX_THREAD_COUNT = 32,
+  //! Maximum number of CPUs that can be addressed by thread affinity, see `BLRuntimeThreadAttributes`.
+  BL_RUNTIME_MAX_AFFINITY_CPU_COUNT = 256
 };
 
 //! Type of runtime information that can be queried through `blRuntimeQueryInfo()`.
@@ -54,9 +56,11 @@ BL_DEFINE_ENUM(BLRuntimeInfoType) {
   //! Resources information (includes Blend2D memory consumption, file handles
   //! used, etc...)
   BL_RUNTIME_INFO_TYPE_RESOURCE = 2,
+  //! Threading information (worker thread attributes and how they were applied).
+  BL_RUNTIME_INFO_TYPE_THREADING = 3,
 
   //! Count of runtime information types.
-  BL_RUNTIME_INFO_TYPE_COUNT = 3
+  BL_RUNTIME_INFO_TYPE_COUNT = 4
 };
 
 //! Blend2D runtime build type.
@@ -103,6 +107,54 @@ BL_DEFINE_ENUM(BLRuntimeCleanupFlags) {
   BL_RUNTIME_CLEANUP_EVERYTHING = 0xFFFFFFFFu
 };
 
+//! Scheduling priority of worker threads, see `BLRuntimeThreadAttributes`.
+//!
+//! On Linux the priority is the nice value of each worker thread (19, 10, 0, -5
+//! and -10 respectively), raising it above normal requires privileges. On Windows
+//! it maps to the corresponding `THREAD_PRIORITY_...` value.
+BL_DEFINE_ENUM(BLRuntimeThreadPriority) {
+  //! Inherit the priority of the thread that created the worker.
+  BL_RUNTIME_THREAD_PRIORITY_DEFAULT = 0,
+  BL_RUNTIME_THREAD_PRIORITY_LOWEST = 1,
+  BL_RUNTIME_THREAD_PRIORITY_BELOW_NORMAL = 2,
+  BL_RUNTIME_THREAD_PRIORITY_NORMAL = 3,
+  BL_RUNTIME_THREAD_PRIORITY_ABOVE_NORMAL = 4,
+  BL_RUNTIME_THREAD_PRIORITY_HIGHEST = 5,
+
+  //! Count of thread priorities.
+  BL_RUNTIME_THREAD_PRIORITY_COUNT = 6
+};
+
+//! Scheduling policy of worker threads, see `BLRuntimeThreadAttributes`.
+//!
+//! Maps to `SCHED_OTHER`, `SCHED_BATCH` and `SCHED_IDLE` on Linux. Windows has
+//! no scheduling policies, `BATCH` is treated as below normal priority and `IDLE`
+//! as `THREAD_PRIORITY_IDLE`, both only if the priority is `DEFAULT`.
+BL_DEFINE_ENUM(BLRuntimeThreadSchedPolicy) {
+  //! Inherit the policy of the thread that created the worker.
+  BL_RUNTIME_THREAD_SCHED_POLICY_DEFAULT = 0,
+  BL_RUNTIME_THREAD_SCHED_POLICY_NORMAL = 1,
+  BL_RUNTIME_THREAD_SCHED_POLICY_BATCH = 2,
+  BL_RUNTIME_THREAD_SCHED_POLICY_IDLE = 3,
+
+  //! Count of scheduling policies.
+  BL_RUNTIME_THREAD_SCHED_POLICY_COUNT = 4
+};
+
+//! Affinity of worker threads, see `BLRuntimeThreadAttributes`.
+BL_DEFINE_ENUM(BLRuntimeThreadAffinity) {
+  //! Worker threads can run on any CPU.
+  BL_RUNTIME_THREAD_AFFINITY_NONE = 0,
+  //! Worker threads can run on any CPU of the CPU set.
+  BL_RUNTIME_THREAD_AFFINITY_CPU_SET = 1,
+  //! Each worker thread is pinned to a single CPU of the CPU set, assigned
+  //! round-robin in the order the threads are created.
+  BL_RUNTIME_THREAD_AFFINITY_PIN = 2,
+
+  //! Count of affinity modes.
+  BL_RUNTIME_THREAD_AFFINITY_COUNT = 3
+};
+
 // ============================================================================
 // [BLRuntime - BuildInfo]
 // ============================================================================
@@ -251,6 +303,85 @@ struct BLRuntimeResourceInfo {
   // --------------------------------------------------------------------------
 };
 
+// ============================================================================
+// [BLRuntime - ThreadAttributes]
+// ============================================================================
+
+//! Attributes of worker threads created by the global thread-pool, can be
+//! changed through `blRuntimeSetThreadAttributes()`.
+//!
+//! Attributes only apply to threads created after they were set. Setting them
+//! releases all pooled threads, so only threads that are acquired at that time
+//! (by rendering contexts that are still attached) keep the previous attributes.
+struct BLRuntimeThreadAttributes {
+  //! Thread priority, see `BLRuntimeThreadPriority`.
+  uint32_t priority;
+  //! Scheduling policy, see `BLRuntimeThreadSchedPolicy`.
+  uint32_t schedPolicy;
+  //! Affinity mode, see `BLRuntimeThreadAffinity`.
+  uint32_t affinity;
+  //! NUMA node to restrict the CPU set to, or -1 to not use NUMA information.
+  //! If `cpuMask` is empty the CPU set is all CPUs of the node.
+  int32_t numaNode;
+  //! CPU set used by affinity, bit N represents CPU N.
+  uint64_t cpuMask[BL_RUNTIME_MAX_AFFINITY_CPU_COUNT / 64];
+  //! Reserved for future use, must be zero.
+  uint32_t reserved[4];
+
+  // --------------------------------------------------------------------------
+  #ifdef __cplusplus
+  BL_INLINE void reset() noexcept {
+    memset(this, 0, sizeof(*this));
+    numaNode = -1;
+  }
+
+  BL_INLINE bool hasCpu(uint32_t cpu) const noexcept {
+    return cpu < BL_RUNTIME_MAX_AFFINITY_CPU_COUNT && (cpuMask[cpu / 64] & (uint64_t(1) << (cpu % 64))) != 0;
+  }
+
+  BL_INLINE void addCpu(uint32_t cpu) noexcept {
+    if (cpu < BL_RUNTIME_MAX_AFFINITY_CPU_COUNT)
+      cpuMask[cpu / 64] |= uint64_t(1) << (cpu % 64);
+  }
+  #endif
+  // --------------------------------------------------------------------------
+};
+
+// ============================================================================
+// [BLRuntime - ThreadingInfo]
+// ============================================================================
+
+//! Threading information queried by the runtime.
+struct BLRuntimeThreadingInfo {
+  //! Attributes of worker threads as set by `blRuntimeSetThreadAttributes()`,
+  //! `cpuMask` is resolved (intersected with the NUMA node, if used).
+  BLRuntimeThreadAttributes attributes;
+
+  //! Number of worker threads that are alive (acquired and pooled).
+  uint32_t threadCount;
+  //! Number of worker threads that are pooled at the moment.
+  uint32_t pooledThreadCount;
+
+  //! Number of worker threads that applied their affinity successfully.
+  uint32_t affinityApplied;
+  //! Number of worker threads that failed to apply their affinity.
+  uint32_t affinityFailed;
+  //! Number of worker threads that applied their priority and policy successfully.
+  uint32_t priorityApplied;
+  //! Number of worker threads that failed to apply their priority or policy,
+  //! which is expected when raising the priority without privileges.
+  uint32_t priorityFailed;
+
+  //! Reserved for future use.
+  uint32_t reserved[2];
+
+  // --------------------------------------------------------------------------
+  #ifdef __cplusplus
+  BL_INLINE void reset() noexcept { memset(this, 0, sizeof(*this)); }
+  #endif
+  // --------------------------------------------------------------------------
+};
+
 // ============================================================================
 // [BLRuntime - C++ API]
 // ============================================================================
@@ -303,6 +434,60 @@ static BL_INLINE BLResult queryResourceInfo(BLRuntimeResourceInfo* out) noexcept
   return blRuntimeQueryInfo(BL_RUNTIME_INFO_TYPE_RESOURCE, out);
 }
 
+static BL_INLINE BLResult queryThreadingInfo(BLRuntimeThreadingInfo* out) noexcept {
+  return blRuntimeQueryInfo(BL_RUNTIME_INFO_TYPE_THREADING, out);
+}
+
+static BL_INLINE BLResult setThreadAttributes(const BLRuntimeThreadAttributes& attributes) noexcept {
+  return blRuntimeSetThreadAttributes(&attributes);
+}
+
+//! Queries signatures of pipelines compiled by the global JIT runtime.
+//!
+//! At most `capacity` signatures are copied to `signaturesOut`, `countOut` is
+//! always set to the number of all compiled pipelines. Signatures are only
+//! meaningful to the same Blend2D build running on a CPU with the same features,
+//! they can be passed to `compilePipelines()` to compile pipelines before they
+//! are first used (at startup, for example). Returns `BL_ERROR_NOT_IMPLEMENTED`
+//! and sets `countOut` to zero if Blend2D was built without JIT.
+static BL_INLINE BLResult queryPipelineSignatures(uint32_t* signaturesOut, size_t capacity, size_t* countOut) noexcept {
+  return blRuntimeQueryPipelineSignatures(signaturesOut, capacity, countOut);
+}
+
+//! Compiles pipelines of the given `signatures` by the global JIT runtime.
+//!
+//! Signatures that are invalid or already compiled are skipped. Can be called
+//! from any thread, even while other threads render. Returns
+//! `BL_ERROR_NOT_IMPLEMENTED` if Blend2D was built without JIT.
+static BL_INLINE BLResult compilePipelines(const uint32_t* signatures, size_t count, size_t* compiledOut = nullptr) noexcept {
+  return blRuntimeCompilePipelines(signatures, count, compiledOut);
+}
+
+//! Starts recording trace events, discards events of a previous trace.
+//!
+//! Each thread records to its own ring buffer of `eventsPerThread` events
+//! (rounded up to a power of 2, zero means a default size), only the most
+//! recent events are kept. Returns `BL_ERROR_NOT_IMPLEMENTED` if tracing was
+//! disabled at compile time.
+static BL_INLINE BLResult startTrace(uint32_t eventsPerThread = 0) noexcept {
+  return blRuntimeStartTrace(eventsPerThread);
+}
+
+//! Stops recording trace events, recorded events are kept until the next
+//! `startTrace()`.
+static BL_INLINE BLResult stopTrace() noexcept {
+  return blRuntimeStopTrace();
+}
+
+//! Exports recorded trace events to `out` as Chrome trace event JSON, which
+//! can be loaded by Perfetto or `chrome://tracing`.
+//!
+//! Should be called after `stopTrace()`, events recorded during the export
+//! may be incomplete.
+static BL_INLINE BLResult exportTrace(BLStringCore* out) noexcept {
+  return blRuntimeExportTrace(out);
+}
+
 static BL_INLINE BLResult message(const char* msg) noexcept {
   return blRuntimeMessageOut(msg);
 }
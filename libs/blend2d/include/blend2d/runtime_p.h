@@ -256,6 +256,7 @@ BL_HIDDEN BL_NORETURN void blRuntimeFailure(const char* fmt, ...) noexcept;
 // [BLRuntime - Runtime]
 // ============================================================================
 
+BL_HIDDEN void blTraceOnInit(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void blThreadOnInit(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void blThreadPoolOnInit(BLRuntimeContext* rt) noexcept;
 BL_HIDDEN void blZeroAllocatorOnInit(BLRuntimeContext* rt) noexcept;
@@ -32,11 +32,18 @@
   #include <process.h>
 #endif
 
+#ifdef __linux__
+  #include <sched.h>
+  #include <sys/resource.h>
+  #include <sys/syscall.h>
+#endif
+
 // ============================================================================
 // [Globals]
 // ============================================================================
 
 static BLThreadVirt blThreadVirt;
+static BLThreadAttributeStats blThreadAttributeStats;
 
 // ============================================================================
 // [BLThread - Internal]
@@ -63,6 +70,8 @@ public:
   BLMutex mutex;
   BLConditionVariable condition;
 
+  BLThreadAttributes attributes;
+
   BL_INLINE BLInternalThread(BLThreadFunc exitFunc, void* exitData) noexcept
     : BLThread { &blThreadVirt },
       handle {},
@@ -72,7 +81,8 @@ public:
       doneFunc(nullptr),
       workData(nullptr),
       exitFunc(exitFunc),
-      exitData(exitData) {}
+      exitData(exitData),
+      attributes {} {}
 
   BL_INLINE ~BLInternalThread() noexcept {
 #if _WIN32
@@ -100,9 +110,129 @@ static BLResult BL_CDECL blThreadDestroy(BLThread* self_) noexcept {
   return BL_SUCCESS;
 }
 
+// ============================================================================
+// [BLThread - Attributes]
+// ============================================================================
+
+static bool blThreadApplyAffinity(const BLThreadAttributes& attributes) noexcept {
+  uint32_t pinnedCpu = attributes.pinnedCpu;
+  bool isPinned = attributes.affinity == BL_RUNTIME_THREAD_AFFINITY_PIN;
+
+#if defined(_WIN32)
+  // Windows addresses CPUs by processor groups of 64, a CPU set that spans
+  // more groups is restricted to the first group that has a CPU in the set.
+  GROUP_AFFINITY groupAffinity {};
+  if (isPinned) {
+    groupAffinity.Group = WORD(pinnedCpu / 64);
+    groupAffinity.Mask = KAFFINITY(uint64_t(1) << (pinnedCpu % 64));
+  }
+  else {
+    for (uint32_t i = 0; i < BL_ARRAY_SIZE(attributes.cpuMask); i++) {
+      if (attributes.cpuMask[i]) {
+        groupAffinity.Group = WORD(i);
+        groupAffinity.Mask = KAFFINITY(attributes.cpuMask[i]);
+        break;
+      }
+    }
+  }
+  return SetThreadGroupAffinity(GetCurrentThread(), &groupAffinity, nullptr) != 0;
+#elif defined(__linux__)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+
+  for (uint32_t cpu = 0; cpu < BL_RUNTIME_MAX_AFFINITY_CPU_COUNT && cpu < CPU_SETSIZE; cpu++) {
+    bool enabled = isPinned ? cpu == pinnedCpu : (attributes.cpuMask[cpu / 64] & (uint64_t(1) << (cpu % 64))) != 0;
+    if (enabled)
+      CPU_SET(cpu, &cpuSet);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+  // Not supported (macOS only provides affinity hints through thread tags).
+  blUnused(pinnedCpu, isPinned);
+  return false;
+#endif
+}
+
+static bool blThreadApplyPriority(const BLThreadAttributes& attributes) noexcept {
+  uint32_t priority = attributes.priority;
+  uint32_t schedPolicy = attributes.schedPolicy;
+
+#if defined(_WIN32)
+  static const int priorityTable[BL_RUNTIME_THREAD_PRIORITY_COUNT] = {
+    THREAD_PRIORITY_NORMAL,
+    THREAD_PRIORITY_LOWEST,
+    THREAD_PRIORITY_BELOW_NORMAL,
+    THREAD_PRIORITY_NORMAL,
+    THREAD_PRIORITY_ABOVE_NORMAL,
+    THREAD_PRIORITY_HIGHEST
+  };
+
+  int value = priorityTable[priority];
+  if (priority == BL_RUNTIME_THREAD_PRIORITY_DEFAULT) {
+    if (schedPolicy == BL_RUNTIME_THREAD_SCHED_POLICY_BATCH)
+      value = THREAD_PRIORITY_BELOW_NORMAL;
+    else if (schedPolicy == BL_RUNTIME_THREAD_SCHED_POLICY_IDLE)
+      value = THREAD_PRIORITY_IDLE;
+  }
+  return SetThreadPriority(GetCurrentThread(), value) != 0;
+#elif defined(__linux__)
+  static const int niceTable[BL_RUNTIME_THREAD_PRIORITY_COUNT] = { 0, 19, 10, 0, -5, -10 };
+  static const int policyTable[BL_RUNTIME_THREAD_SCHED_POLICY_COUNT] = { SCHED_OTHER, SCHED_OTHER, SCHED_BATCH, SCHED_IDLE };
+
+  bool ok = true;
+
+  // Policy first, `SCHED_IDLE` ignores the nice value, but it's still applied
+  // so it takes effect if the policy is changed back later.
+  if (schedPolicy != BL_RUNTIME_THREAD_SCHED_POLICY_DEFAULT) {
+    sched_param param {};
+    ok &= pthread_setschedparam(pthread_self(), policyTable[schedPolicy], &param) == 0;
+  }
+
+  // Linux keeps the nice value per thread, so this doesn't affect the process.
+  if (priority != BL_RUNTIME_THREAD_PRIORITY_DEFAULT)
+    ok &= setpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid)), niceTable[priority]) == 0;
+
+  return ok;
+#else
+  blUnused(priority, schedPolicy);
+  return false;
+#endif
+}
+
+static void blThreadApplyAttributes(const BLThreadAttributes& attributes) noexcept {
+  if (attributes.affinity != BL_RUNTIME_THREAD_AFFINITY_NONE) {
+    if (blThreadApplyAffinity(attributes))
+      blAtomicFetchAdd(&blThreadAttributeStats.affinityApplied, 1u, std::memory_order_relaxed);
+    else
+      blAtomicFetchAdd(&blThreadAttributeStats.affinityFailed, 1u, std::memory_order_relaxed);
+  }
+
+  if (attributes.priority != BL_RUNTIME_THREAD_PRIORITY_DEFAULT || attributes.schedPolicy != BL_RUNTIME_THREAD_SCHED_POLICY_DEFAULT) {
+    if (blThreadApplyPriority(attributes))
+      blAtomicFetchAdd(&blThreadAttributeStats.priorityApplied, 1u, std::memory_order_relaxed);
+    else
+      blAtomicFetchAdd(&blThreadAttributeStats.priorityFailed, 1u, std::memory_order_relaxed);
+  }
+}
+
+void blThreadQueryAttributeStats(BLThreadAttributeStats* out) noexcept {
+  out->affinityApplied = blAtomicFetch(&blThreadAttributeStats.affinityApplied, std::memory_order_relaxed);
+  out->affinityFailed = blAtomicFetch(&blThreadAttributeStats.affinityFailed, std::memory_order_relaxed);
+  out->priorityApplied = blAtomicFetch(&blThreadAttributeStats.priorityApplied, std::memory_order_relaxed);
+  out->priorityFailed = blAtomicFetch(&blThreadAttributeStats.priorityFailed, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// [BLThread - Entry Point]
+// ============================================================================
+
 static BL_INLINE void blThreadEntryPoint(BLInternalThread* thread) noexcept {
   uint32_t status = BL_THREAD_STATUS_IDLE;
 
+  // Applied by the thread itself, some platforms (Linux nice values) can only
+  // address the calling thread.
+  blThreadApplyAttributes(thread->attributes);
+
   do {
     BLThreadFunc workFunc;
     BLThreadFunc doneFunc;
@@ -217,6 +347,8 @@ BLResult BL_CDECL blThreadCreate(BLThread** threadOut, const BLThreadAttributes*
   if (BL_UNLIKELY(!thread))
     return blTraceError(BL_ERROR_OUT_OF_MEMORY);
 
+  thread->attributes = *attributes;
+
   BLResult result = BL_SUCCESS;
   uint32_t flags = 0;
   uint32_t stackSize = attributes->stackSize;
@@ -288,6 +420,8 @@ BLResult BL_CDECL blThreadCreate(BLThread** threadOut, const BLThreadAttributes*
     return blTraceError(BL_ERROR_OUT_OF_MEMORY);
   }
 
+  thread->attributes = *attributes;
+
   // Probe loop - Since some implementations fail to create a thread with
   // small stack-size, we would probe a safe value in this case and use
   // it the next time we want to create a thread as a minimum so we don't
@@ -25,6 +25,7 @@
 #define BLEND2D_THREADING_THREAD_P_H_INCLUDED
 
 #include "../api-internal_p.h"
+#include "../runtime.h"
 
 //! \cond INTERNAL
 //! \addtogroup blend2d_internal
@@ -64,6 +65,27 @@ enum BLThreadQuitFlags : uint32_t {
 
 struct BLThreadAttributes {
   uint32_t stackSize;
+
+  //! Thread priority, see `BLRuntimeThreadPriority`.
+  uint8_t priority;
+  //! Scheduling policy, see `BLRuntimeThreadSchedPolicy`.
+  uint8_t schedPolicy;
+  //! Affinity mode, see `BLRuntimeThreadAffinity`.
+  uint8_t affinity;
+  //! Reserved for future use.
+  uint8_t reserved;
+  //! CPU to pin the thread to, only used by `BL_RUNTIME_THREAD_AFFINITY_PIN`.
+  uint32_t pinnedCpu;
+  //! CPU set used by `BL_RUNTIME_THREAD_AFFINITY_CPU_SET`.
+  uint64_t cpuMask[BL_RUNTIME_MAX_AFFINITY_CPU_COUNT / 64];
+};
+
+//! Counts how many threads applied their attributes, queried by the thread-pool.
+struct BLThreadAttributeStats {
+  uint32_t affinityApplied;
+  uint32_t affinityFailed;
+  uint32_t priorityApplied;
+  uint32_t priorityFailed;
 };
 
 struct BLThreadVirt {
@@ -99,6 +121,10 @@ struct BLThread {
 
 BL_HIDDEN BLResult BL_CDECL blThreadCreate(BLThread** threadOut, const BLThreadAttributes* attributes, BLThreadFunc exitFunc, void* exitData) noexcept;
 
+//! Attributes are applied by each thread when it starts, so the stats can lag
+//! behind threads that were just created.
+BL_HIDDEN void blThreadQueryAttributeStats(BLThreadAttributeStats* out) noexcept;
+
 //! \}
 //! \endcond
 
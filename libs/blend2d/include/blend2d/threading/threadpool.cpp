@@ -34,6 +34,8 @@
   #include <process.h>
 #endif
 
+#include <stdio.h>
+
 // ============================================================================
 // [Globals]
 // ============================================================================
@@ -57,10 +59,12 @@ public:
   volatile uint32_t acquiredThreadCount;
   volatile uint32_t destroyWaitTimeInMS;
   volatile uint32_t waitingOnDestroy;
+  volatile uint32_t pinIndex;
 
   BLMutex mutex;
   BLConditionVariable destroyCondition;
   BLThreadAttributes threadAttributes;
+  BLRuntimeThreadAttributes runtimeAttributes;
   BitArray pooledThreadBits;
   BLThread* threads[kMaxThreadCount];
 
@@ -74,9 +78,11 @@ public:
       acquiredThreadCount(0),
       destroyWaitTimeInMS(100),
       waitingOnDestroy(0),
+      pinIndex(0),
       mutex(),
       destroyCondition(),
       threadAttributes {},
+      runtimeAttributes {},
       pooledThreadBits {},
       threads {} { init(); }
 
@@ -173,9 +179,44 @@ static BLResult BL_CDECL blThreadPoolSetThreadAttributes(BLThreadPool* self_, co
   }
 
   self->threadAttributes = *attributes;
+  self->pinIndex = 0;
   return BL_SUCCESS;
 }
 
+// Returns the attributes of a thread that is about to be created, assigns the
+// next CPU of the CPU set to it if threads are pinned. Must be called locked.
+static BLThreadAttributes blThreadPoolNextThreadAttributes(BLInternalThreadPool* self) noexcept {
+  BLThreadAttributes attributes = self->threadAttributes;
+  if (attributes.affinity != BL_RUNTIME_THREAD_AFFINITY_PIN)
+    return attributes;
+
+  uint32_t cpuCount = 0;
+  for (uint32_t i = 0; i < BL_ARRAY_SIZE(attributes.cpuMask); i++)
+    cpuCount += blPopCount(attributes.cpuMask[i]);
+
+  // Verified by `blRuntimeSetThreadAttributes()`, but be defensive.
+  if (BL_UNLIKELY(!cpuCount)) {
+    attributes.affinity = BL_RUNTIME_THREAD_AFFINITY_NONE;
+    return attributes;
+  }
+
+  uint32_t n = self->pinIndex++ % cpuCount;
+  for (uint32_t i = 0; i < BL_ARRAY_SIZE(attributes.cpuMask); i++) {
+    uint64_t mask = attributes.cpuMask[i];
+    uint32_t count = blPopCount(mask);
+
+    if (n < count) {
+      while (n--)
+        mask &= mask - 1u;
+      attributes.pinnedCpu = i * 64u + blBitCtz(mask);
+      break;
+    }
+    n -= count;
+  }
+
+  return attributes;
+}
+
 // ============================================================================
 // [BLThreadPool - Cleanup]
 // ============================================================================
@@ -279,7 +320,8 @@ static uint32_t blThreadPoolAcquireThreadsInternal(BLInternalThreadPool* self, B
     }
 
     while (nAcquired < createThreadCount) {
-      reason = blThreadCreate(&threads[nAcquired], &self->threadAttributes, blThreadPoolThreadExitFunc, self);
+      BLThreadAttributes attributes = blThreadPoolNextThreadAttributes(self);
+      reason = blThreadCreate(&threads[nAcquired], &attributes, blThreadPoolThreadExitFunc, self);
 
       if (reason != BL_SUCCESS) {
         if (flags & BL_THREAD_POOL_ACQUIRE_FLAG_ALL_OR_NOTHING) {
@@ -356,6 +398,126 @@ static void BL_CDECL blThreadPoolReleaseThreads(BLThreadPool* self_, BLThread**
 static BLWrap<BLInternalThreadPool> blGlobalThreadPool;
 BLThreadPool* blThreadPoolGlobal() noexcept { return &blGlobalThreadPool; }
 
+// ============================================================================
+// [BLThreadPool - Runtime Thread Attributes]
+// ============================================================================
+
+// Resolves CPUs of the given NUMA `node`, returns false if the node doesn't
+// exist or the platform doesn't provide NUMA information.
+static bool blThreadPoolQueryNumaNodeCpus(uint32_t node, uint64_t* cpuMask) noexcept {
+  memset(cpuMask, 0, sizeof(uint64_t) * (BL_RUNTIME_MAX_AFFINITY_CPU_COUNT / 64));
+
+#if defined(_WIN32)
+  GROUP_AFFINITY groupAffinity {};
+  if (!GetNumaNodeProcessorMaskEx(USHORT(node), &groupAffinity))
+    return false;
+
+  if (groupAffinity.Group < BL_RUNTIME_MAX_AFFINITY_CPU_COUNT / 64)
+    cpuMask[groupAffinity.Group] = uint64_t(groupAffinity.Mask);
+  return true;
+#elif defined(__linux__)
+  // The list has a form of "0-7,16-23".
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+
+  FILE* f = fopen(path, "r");
+  if (!f)
+    return false;
+
+  unsigned first, last;
+  int c = ',';
+  while (c == ',' && fscanf(f, "%u", &first) == 1) {
+    last = first;
+    c = fgetc(f);
+    if (c == '-') {
+      if (fscanf(f, "%u", &last) != 1)
+        break;
+      c = fgetc(f);
+    }
+
+    for (unsigned cpu = first; cpu <= last && cpu < BL_RUNTIME_MAX_AFFINITY_CPU_COUNT; cpu++)
+      cpuMask[cpu / 64] |= uint64_t(1) << (cpu % 64);
+  }
+
+  fclose(f);
+  return true;
+#else
+  blUnused(node);
+  return false;
+#endif
+}
+
+BLResult blRuntimeSetThreadAttributes(const BLRuntimeThreadAttributes* attributes) noexcept {
+  if (attributes->priority >= BL_RUNTIME_THREAD_PRIORITY_COUNT ||
+      attributes->schedPolicy >= BL_RUNTIME_THREAD_SCHED_POLICY_COUNT ||
+      attributes->affinity >= BL_RUNTIME_THREAD_AFFINITY_COUNT)
+    return blTraceError(BL_ERROR_INVALID_VALUE);
+
+  BLRuntimeThreadAttributes resolved = *attributes;
+  bool hasMask = false;
+
+  for (uint32_t i = 0; i < BL_ARRAY_SIZE(resolved.cpuMask); i++)
+    hasMask |= resolved.cpuMask[i] != 0;
+
+  if (resolved.numaNode >= 0) {
+    uint64_t nodeMask[BL_RUNTIME_MAX_AFFINITY_CPU_COUNT / 64];
+    if (!blThreadPoolQueryNumaNodeCpus(uint32_t(resolved.numaNode), nodeMask))
+      return blTraceError(BL_ERROR_INVALID_VALUE);
+
+    bool nonEmpty = false;
+    for (uint32_t i = 0; i < BL_ARRAY_SIZE(resolved.cpuMask); i++) {
+      resolved.cpuMask[i] = hasMask ? resolved.cpuMask[i] & nodeMask[i] : nodeMask[i];
+      nonEmpty |= resolved.cpuMask[i] != 0;
+    }
+
+    hasMask = nonEmpty;
+    if (resolved.affinity == BL_RUNTIME_THREAD_AFFINITY_NONE)
+      resolved.affinity = BL_RUNTIME_THREAD_AFFINITY_CPU_SET;
+  }
+
+  if (resolved.affinity != BL_RUNTIME_THREAD_AFFINITY_NONE && !hasMask)
+    return blTraceError(BL_ERROR_INVALID_VALUE);
+
+  BLInternalThreadPool* self = blGlobalThreadPool.p();
+
+  BLThreadAttributes threadAttributes {};
+  threadAttributes.stackSize = self->threadAttributes.stackSize;
+  threadAttributes.priority = uint8_t(resolved.priority);
+  threadAttributes.schedPolicy = uint8_t(resolved.schedPolicy);
+  threadAttributes.affinity = uint8_t(resolved.affinity);
+  memcpy(threadAttributes.cpuMask, resolved.cpuMask, sizeof(threadAttributes.cpuMask));
+
+  BL_PROPAGATE(self->setThreadAttributes(threadAttributes));
+  {
+    BLLockGuard<BLMutex> guard(self->mutex);
+    self->runtimeAttributes = resolved;
+  }
+
+  // Pooled threads were created with the previous attributes.
+  self->cleanup();
+  return BL_SUCCESS;
+}
+
+void blThreadPoolQueryThreadingInfo(BLRuntimeThreadingInfo* out) noexcept {
+  BLInternalThreadPool* self = blGlobalThreadPool.p();
+  out->reset();
+
+  {
+    BLLockGuard<BLMutex> guard(self->mutex);
+    out->attributes = self->runtimeAttributes;
+    out->pooledThreadCount = self->pooledThreadCount;
+  }
+  out->threadCount = blAtomicFetch(&self->createdThreadCount);
+
+  BLThreadAttributeStats stats;
+  blThreadQueryAttributeStats(&stats);
+
+  out->affinityApplied = stats.affinityApplied;
+  out->affinityFailed = stats.affinityFailed;
+  out->priorityApplied = stats.priorityApplied;
+  out->priorityFailed = stats.priorityFailed;
+}
+
 // ============================================================================
 // [BLThreadPool - RuntimeInit]
 // ============================================================================
@@ -388,6 +550,7 @@ void blThreadPoolOnInit(BLRuntimeContext* rt) noexcept {
 
   blGlobalThreadPool.init(0u);
   blGlobalThreadPool->setThreadAttributes(attrs);
+  blGlobalThreadPool->runtimeAttributes.reset();
 
   rt->shutdownHandlers.add(blThreadPoolOnShutdown);
   rt->cleanupHandlers.add(blThreadPoolRtCleanup);
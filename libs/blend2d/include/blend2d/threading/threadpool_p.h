@@ -135,6 +135,9 @@ struct BLThreadPool {
 BL_HIDDEN BLThreadPool* blThreadPoolGlobal() noexcept;
 BL_HIDDEN BLThreadPool* blThreadPoolCreate() noexcept;
 
+//! Fills threading information of the global thread-pool.
+BL_HIDDEN void blThreadPoolQueryThreadingInfo(BLRuntimeThreadingInfo* out) noexcept;
+
 //! \}
 //! \endcond
 
@@ -22,7 +22,11 @@
 // 3. This notice may not be removed or altered from any source distribution.
 
 #include "./api-build_p.h"
+#include "./runtime_p.h"
+#include "./string.h"
+#include "./support_p.h"
 #include "./trace_p.h"
+#include "./threading/mutex_p.h"
 
 // ============================================================================
 // [BLOpenType::BLDebugTrace]
@@ -43,3 +47,191 @@ void BLDebugTrace::log(uint32_t severity, uint32_t indentation, const char* fmt,
   blRuntimeMessageVFmt(fmt, ap);
   va_end(ap);
 }
+
+// ============================================================================
+// [BLTrace - Globals]
+// ============================================================================
+
+static constexpr uint32_t BL_TRACE_DEFAULT_CAPACITY = 65536;
+static constexpr uint32_t BL_TRACE_MIN_CAPACITY = 256;
+static constexpr uint32_t BL_TRACE_MAX_CAPACITY = 16777216;
+
+volatile uint32_t blTraceGeneration;
+
+//! Protects everything except event recording, which is done by ring owners.
+static BLWrap<BLMutex> blTraceMutex;
+//! List of all rings, including rings of threads that no longer exist.
+static BLTraceRing* blTraceRingList;
+//! Number of threads that ever recorded an event.
+static uint32_t blTraceThreadCount;
+//! Capacity of rings used by the current trace.
+static uint32_t blTraceCapacity;
+//! Generation of the last trace, kept after the trace was stopped for export.
+static uint32_t blTraceLastGeneration;
+//! Incremented when all rings are released, invalidates `blTraceLocalRing`.
+static volatile uint32_t blTraceRingEpoch;
+//! Time when the last trace started, exported timestamps are relative to it.
+static uint64_t blTraceStartTime;
+
+#ifndef BL_BUILD_NO_TRACE
+static thread_local BLTraceRing* blTraceLocalRing;
+static thread_local uint32_t blTraceLocalEpoch;
+#endif
+
+// ============================================================================
+// [BLTrace - Rings]
+// ============================================================================
+
+#ifndef BL_BUILD_NO_TRACE
+static BL_NOINLINE BLTraceRing* blTraceAcquireRingSlow(uint32_t generation) noexcept {
+  BLLockGuard<BLMutex> guard(blTraceMutex);
+
+  // The trace was stopped or restarted since the caller checked it.
+  if (blAtomicFetch(&blTraceGeneration) != generation)
+    return nullptr;
+
+  BLTraceRing* ring = blTraceLocalEpoch == blTraceRingEpoch ? blTraceLocalRing : nullptr;
+  uint32_t capacity = blTraceCapacity;
+
+  if (ring && ring->capacity == capacity) {
+    blAtomicStore(&ring->writeCount, size_t(0));
+    blAtomicStore(&ring->generation, generation);
+    return ring;
+  }
+
+  // A ring of a different capacity stays in the list with its old generation
+  // and will never be exported again, the thread keeps its index.
+  BLTraceRing* newRing = static_cast<BLTraceRing*>(
+    malloc(sizeof(BLTraceRing) + (capacity - 1) * sizeof(BLTraceEvent)));
+
+  if (BL_UNLIKELY(!newRing))
+    return nullptr;
+
+  newRing->next = blTraceRingList;
+  newRing->threadIndex = ring ? ring->threadIndex : ++blTraceThreadCount;
+  newRing->generation = generation;
+  newRing->capacity = capacity;
+  newRing->reserved = 0;
+  newRing->writeCount = 0;
+
+  blTraceRingList = newRing;
+  blTraceLocalRing = newRing;
+  blTraceLocalEpoch = blTraceRingEpoch;
+  return newRing;
+}
+
+BLTraceRing* blTraceAcquireRing(uint32_t generation) noexcept {
+  BLTraceRing* ring = blTraceLocalRing;
+  if (BL_LIKELY(ring && blTraceLocalEpoch == blAtomicFetch(&blTraceRingEpoch) && ring->generation == generation))
+    return ring;
+  return blTraceAcquireRingSlow(generation);
+}
+#else
+BLTraceRing* blTraceAcquireRing(uint32_t generation) noexcept {
+  blUnused(generation);
+  return nullptr;
+}
+#endif
+
+// ============================================================================
+// [BLTrace - API]
+// ============================================================================
+
+BLResult blRuntimeStartTrace(uint32_t eventsPerThread) noexcept {
+#ifndef BL_BUILD_NO_TRACE
+  if (!eventsPerThread)
+    eventsPerThread = BL_TRACE_DEFAULT_CAPACITY;
+
+  uint32_t capacity = blAlignUpPowerOf2(blClamp(eventsPerThread, BL_TRACE_MIN_CAPACITY, BL_TRACE_MAX_CAPACITY));
+  BLLockGuard<BLMutex> guard(blTraceMutex);
+
+  // Zero means disabled, so it's skipped when the generation wraps around.
+  if (++blTraceLastGeneration == 0)
+    blTraceLastGeneration = 1;
+
+  blTraceCapacity = capacity;
+  blTraceStartTime = blTraceTimeNs();
+  blAtomicStore(&blTraceGeneration, blTraceLastGeneration);
+
+  return BL_SUCCESS;
+#else
+  blUnused(eventsPerThread);
+  return blTraceError(BL_ERROR_NOT_IMPLEMENTED);
+#endif
+}
+
+BLResult blRuntimeStopTrace() noexcept {
+  blAtomicStore(&blTraceGeneration, uint32_t(0));
+  return BL_SUCCESS;
+}
+
+BLResult blRuntimeExportTrace(BLStringCore* out) noexcept {
+  BLString& dst = *blDownCast(out);
+  BL_PROPAGATE(dst.assign("{\"traceEvents\":[\n"));
+
+  BLLockGuard<BLMutex> guard(blTraceMutex);
+  uint32_t generation = blTraceLastGeneration;
+  const char* separator = "";
+
+  // Formatted to a local buffer as each export appends a lot of small records.
+  char buf[256];
+  int n;
+
+  for (BLTraceRing* ring = blTraceRingList; ring; ring = ring->next) {
+    if (!generation || blAtomicFetch(&ring->generation) != generation)
+      continue;
+
+    size_t writeCount = blAtomicFetch(&ring->writeCount, std::memory_order_acquire);
+    size_t i = writeCount > ring->capacity ? writeCount - ring->capacity : size_t(0);
+
+    n = snprintf(buf, BL_ARRAY_SIZE(buf),
+      "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Blend2D thread %u\"}}",
+      separator, ring->threadIndex, ring->threadIndex);
+    BL_PROPAGATE(dst.append(buf, size_t(blMin<int>(n, int(BL_ARRAY_SIZE(buf) - 1)))));
+    separator = ",\n";
+
+    for (; i < writeCount; i++) {
+      const BLTraceEvent& event = ring->events[i & (ring->capacity - 1)];
+
+      // Events recorded before the trace started (by scopes that were open).
+      if (event.startTime < blTraceStartTime)
+        continue;
+
+      uint64_t ts = event.startTime - blTraceStartTime;
+      n = snprintf(buf, BL_ARRAY_SIZE(buf),
+        ",\n{\"name\":\"%s\",\"cat\":\"blend2d\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03u,\"dur\":%llu.%03u,\"args\":{\"n\":%llu}}",
+        event.name, ring->threadIndex,
+        (unsigned long long)(ts / 1000u), unsigned(ts % 1000u),
+        (unsigned long long)(event.duration / 1000u), unsigned(event.duration % 1000u),
+        (unsigned long long)event.arg);
+      BL_PROPAGATE(dst.append(buf, size_t(blMin<int>(n, int(BL_ARRAY_SIZE(buf) - 1)))));
+    }
+  }
+
+  return dst.append("\n]}\n");
+}
+
+// ============================================================================
+// [BLTrace - Runtime]
+// ============================================================================
+
+static void BL_CDECL blTraceOnShutdown(BLRuntimeContext* rt) noexcept {
+  blUnused(rt);
+  blAtomicStore(&blTraceGeneration, uint32_t(0));
+
+  BLTraceRing* ring = blTraceRingList;
+  while (ring) {
+    BLTraceRing* next = ring->next;
+    free(ring);
+    ring = next;
+  }
+
+  blTraceRingList = nullptr;
+  blAtomicFetchAdd(&blTraceRingEpoch);
+  blTraceMutex.destroy();
+}
+
+void blTraceOnInit(BLRuntimeContext* rt) noexcept {
+  blTraceMutex.init();
+  rt->shutdownHandlers.add(blTraceOnShutdown);
+}
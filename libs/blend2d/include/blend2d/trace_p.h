@@ -24,7 +24,14 @@
 #ifndef BLEND2D_TRACE_P_H_INCLUDED
 #define BLEND2D_TRACE_P_H_INCLUDED
 
+#include <chrono>
+
 #include "./api-internal_p.h"
+#include "./threading/atomic_p.h"
+
+#if defined(BL_BUILD_NO_TLS) && !defined(BL_BUILD_NO_TRACE)
+  #define BL_BUILD_NO_TRACE
+#endif
 
 //! \cond INTERNAL
 //! \addtogroup blend2d_internal
@@ -87,6 +94,124 @@ public:
   int indentation;
 };
 
+// ============================================================================
+// [BLTrace - Events]
+// ============================================================================
+
+//! Trace event - a named time interval recorded by `BLTraceScope`.
+//!
+//! Events are recorded once the interval ends, which keeps nesting intact even
+//! when older events are overwritten by the ring buffer.
+struct BLTraceEvent {
+  //! Name of the event, must be a string literal (only the pointer is stored).
+  const char* name;
+  //! Start time in nanoseconds, see `blTraceTimeNs()`.
+  uint64_t startTime;
+  //! Duration in nanoseconds.
+  uint64_t duration;
+  //! Optional argument (count, size, signature), exported as `n`.
+  uint64_t arg;
+};
+
+//! Per-thread ring buffer that holds the most recent `BLTraceEvent` records.
+//!
+//! Only the owning thread writes to the ring, so recording is lock-free. Rings
+//! are never released before `blRuntimeShutdown()`, so they can be exported
+//! even after their thread has finished.
+struct BLTraceRing {
+  //! Next ring in a list of all rings.
+  BLTraceRing* next;
+  //! Index of the thread that owns the ring, exported as `tid`.
+  uint32_t threadIndex;
+  //! Generation of the trace the ring belongs to, see `blRuntimeStartTrace()`.
+  volatile uint32_t generation;
+  //! Capacity of `events` (power of 2).
+  uint32_t capacity;
+  //! Reserved.
+  uint32_t reserved;
+  //! Number of events written since the trace started (monotonic).
+  volatile size_t writeCount;
+  //! Events data.
+  BLTraceEvent events[1];
+};
+
+//! Generation of the running trace or zero if tracing is not enabled.
+BL_HIDDEN extern volatile uint32_t blTraceGeneration;
+
+//! Returns a monotonic time in nanoseconds.
+static BL_INLINE uint64_t blTraceTimeNs() noexcept {
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//! Returns the ring of the calling thread that belongs to the trace `generation`,
+//! creates it if necessary. Returns null if out of memory.
+BL_HIDDEN BLTraceRing* blTraceAcquireRing(uint32_t generation) noexcept;
+
+//! Tests whether a trace is running.
+static BL_INLINE bool blTraceEnabled() noexcept {
+  return blAtomicFetch(&blTraceGeneration, std::memory_order_relaxed) != 0;
+}
+
+//! Records an event to the ring of the calling thread.
+static BL_INLINE void blTraceRecord(const char* name, uint64_t startTime, uint64_t duration, uint64_t arg) noexcept {
+  uint32_t generation = blAtomicFetch(&blTraceGeneration, std::memory_order_acquire);
+  if (!generation)
+    return;
+
+  BLTraceRing* ring = blTraceAcquireRing(generation);
+  if (BL_UNLIKELY(!ring))
+    return;
+
+  size_t index = ring->writeCount;
+  BLTraceEvent& event = ring->events[index & (ring->capacity - 1)];
+
+  event.name = name;
+  event.startTime = startTime;
+  event.duration = duration;
+  event.arg = arg;
+
+  blAtomicStore(&ring->writeCount, index + 1, std::memory_order_release);
+}
+
+// ============================================================================
+// [BLTraceScope]
+// ============================================================================
+
+//! Records the lifetime of the scope as a trace event, a no-op unless a trace
+//! is running (one relaxed load).
+class BLTraceScope {
+public:
+  BL_NONCOPYABLE(BLTraceScope)
+
+  const char* _name;
+  uint64_t _startTime;
+  uint64_t _arg;
+
+  BL_INLINE explicit BLTraceScope(const char* name, uint64_t arg = 0) noexcept
+    : _name(name),
+      _startTime(blTraceEnabled() ? blTraceTimeNs() : uint64_t(0)),
+      _arg(arg) {}
+
+  BL_INLINE ~BLTraceScope() noexcept {
+    if (_startTime)
+      blTraceRecord(_name, _startTime, blTraceTimeNs() - _startTime, _arg);
+  }
+
+  //! Replaces the argument, useful when it's only known at the end of the scope.
+  BL_INLINE void setArg(uint64_t arg) noexcept { _arg = arg; }
+};
+
+//! Defines a `BLTraceScope` variable `VAR` that traces the rest of the enclosing
+//! scope, compiled out when `BL_BUILD_NO_TRACE` is defined.
+#ifndef BL_BUILD_NO_TRACE
+  #define BL_TRACE_SCOPE(VAR, ...) BLTraceScope VAR(__VA_ARGS__)
+  #define BL_TRACE_SET_ARG(VAR, ARG) VAR.setArg(ARG)
+#else
+  #define BL_TRACE_SCOPE(VAR, ...) ((void)0)
+  #define BL_TRACE_SET_ARG(VAR, ARG) ((void)0)
+#endif
+
 //! \}
 //! \endcond
 